@@ -0,0 +1,1158 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*
+ * Module : EduOM_APITest.c
+ *
+ * Description :
+ *  Check the interface functions of EduOM beyond the five operations tested
+ *  by EduOM_Test(). Each check creates its own data file, calls one group of
+ *  interface functions and compares the results with the expected ones,
+ *  printing PASS or FAIL. Run by "EduOM_Test api".
+ *
+ * Exports:
+ *  Four EduOM_APITest(Four, Four)
+ *
+ * Internal Functions:
+ *  Four eduom_APITestCreateObjects(Four, Four*)
+ *  Four eduom_APITestBulkLoad(Four, Four*)
+ *  Four eduom_APITestPinObject(Four, Four*)
+ *  Four eduom_APITestPageScan(Four, Four*)
+ *  Four eduom_APITestScanCursor(Four, Four*)
+ *  Four eduom_APITestPlacementPolicy(Four, Four*)
+ *  Four eduom_APITestCompaction(Four, Four*)
+ *  Four eduom_APITestUpdateObject(Four, Four*)
+ *  Four eduom_APITestReadahead(Four, Four*)
+ *  Four eduom_APITestPreallocation(Four, Four*)
+ *  Four eduom_APITestElementPool(Four, Four*)
+ *  Four eduom_APITestStats(Four, Four*)
+ *  Four eduom_APITestReportFile(Four, Four*)
+ *  Four eduom_APITestReorganizeFile(Four, Four*)
+ *  Four eduom_APITestClusterRadius(Four, Four*)
+ *  Four eduom_APITestCreateFile(Four, FileID*, ObjectID*)
+ *  Four eduom_APITestCreateNear(ObjectID*, Four, ObjectID*)
+ *  Four eduom_APITestCount(ObjectID*)
+ *  void eduom_APITestFill(char*, Four, Four)
+ *  Boolean eduom_APITestHasData(ObjectID*, Four, Four)
+ *  void eduom_APITestResult(char*, Boolean, Four*)
+ */
+#include "EduOM.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "EduOM_Internal.h"
+#include "EduOM_TestModule.h"
+#include "EduOM_common.h"
+
+#define APITEST_OBJECT_SIZE 100 /* length of the objects of the checks */
+#define APITEST_BATCH 10        /* # of objects created by one call */
+#define APITEST_MANY 200        /* # of objects spanning several pages */
+#define APITEST_REORG 600       /* # of objects of the reorganized file */
+
+Four eduom_APITestCreateObjects(Four, Four *);
+Four eduom_APITestBulkLoad(Four, Four *);
+Four eduom_APITestPinObject(Four, Four *);
+Four eduom_APITestPageScan(Four, Four *);
+Four eduom_APITestScanCursor(Four, Four *);
+Four eduom_APITestPlacementPolicy(Four, Four *);
+Four eduom_APITestCompaction(Four, Four *);
+Four eduom_APITestUpdateObject(Four, Four *);
+Four eduom_APITestReadahead(Four, Four *);
+Four eduom_APITestPreallocation(Four, Four *);
+Four eduom_APITestElementPool(Four, Four *);
+Four eduom_APITestStats(Four, Four *);
+Four eduom_APITestReportFile(Four, Four *);
+Four eduom_APITestReorganizeFile(Four, Four *);
+Four eduom_APITestClusterRadius(Four, Four *);
+Four eduom_APITestCreateFile(Four, FileID *, ObjectID *);
+Four eduom_APITestCreateNear(ObjectID *, Four, ObjectID *);
+Four eduom_APITestCount(ObjectID *);
+void eduom_APITestFill(char *, Four, Four);
+Boolean eduom_APITestHasData(ObjectID *, Four, Four);
+void eduom_APITestResult(char *, Boolean, Four *);
+
+/* the checks in the order they are run */
+static Four (*apiTests[])(Four, Four *) = {
+    eduom_APITestCreateObjects,   eduom_APITestBulkLoad,
+    eduom_APITestPinObject,       eduom_APITestPageScan,
+    eduom_APITestScanCursor,      eduom_APITestPlacementPolicy,
+    eduom_APITestCompaction,      eduom_APITestUpdateObject,
+    eduom_APITestReadahead,       eduom_APITestPreallocation,
+    eduom_APITestElementPool,     eduom_APITestStats,
+    eduom_APITestReportFile,      eduom_APITestReorganizeFile,
+    eduom_APITestClusterRadius};
+
+/*@================================
+ * EduOM_APITest()
+ *================================*/
+/*
+ * Function: Four EduOM_APITest(Four, Four)
+ *
+ * Description :
+ *  Run all the checks of the interface functions and print the number of
+ *  the failed checks.
+ *
+ * Returns:
+ *  1) number of the failed checks (values greater than or equal to 0)
+ *  2) error code (negative values)
+ *    some errors caused by function calls
+ */
+Four EduOM_APITest(Four volId,  /* IN volume of the files */
+                   Four handle) /* IN system handle */
+{
+  Four e;       /* for errors */
+  Four i;       /* index of the check */
+  Four nFailed; /* # of the failed checks */
+
+  printf("Loading EduOM_APITest() complete...\n");
+
+  nFailed = 0;
+  for (i = 0; i < sizeof(apiTests) / sizeof(apiTests[0]); i++) {
+    e = apiTests[i](volId, &nFailed);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  printf("%ld check(s) failed\n", (long)nFailed);
+
+  return (nFailed);
+
+} /* EduOM_APITest() */
+
+/*@================================
+ * eduom_APITestCreateObjects()
+ *================================*/
+/*
+ * Function: Four eduom_APITestCreateObjects(Four, Four*)
+ *
+ * Description :
+ *  Check that EduOM_CreateObjects() creates every object of a batch with
+ *  its own length and data.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestCreateObjects(Four volId,     /* IN volume of the file */
+                                Four *nFailed)  /* INOUT # of failed checks */
+{
+  Four e;                                 /* for errors */
+  Four i;                                 /* index */
+  FileID fid;                             /* file identifier */
+  ObjectID catObj;                        /* catalog object of the file */
+  ObjectCreateInfo objInfo[APITEST_BATCH]; /* objects to create */
+  ObjectID oids[APITEST_BATCH];           /* created objects */
+  char data[APITEST_BATCH][APITEST_OBJECT_SIZE]; /* data of the objects */
+  Boolean passed;                         /* is the check passed? */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  for (i = 0; i < APITEST_BATCH; i++) {
+    objInfo[i].objHdr = NULL;
+    objInfo[i].length = APITEST_OBJECT_SIZE * (i + 1) / APITEST_BATCH;
+    objInfo[i].data = data[i];
+    eduom_APITestFill(data[i], i, objInfo[i].length);
+  }
+
+  e = EduOM_CreateObjects(&catObj, NULL, APITEST_BATCH, objInfo, oids);
+
+  passed = (e == eNOERROR && eduom_APITestCount(&catObj) == APITEST_BATCH);
+  for (i = 0; passed && i < APITEST_BATCH; i++)
+    passed = eduom_APITestHasData(&oids[i], i, objInfo[i].length);
+  eduom_APITestResult("EduOM_CreateObjects creates the whole batch", passed,
+                      nFailed);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestCreateObjects() */
+
+/*@================================
+ * eduom_APITestBulkLoad()
+ *================================*/
+/*
+ * Function: Four eduom_APITestBulkLoad(Four, Four*)
+ *
+ * Description :
+ *  Check that the objects loaded by EduOM_NextBulkLoad() are in the file
+ *  after EduOM_FinalBulkLoad().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestBulkLoad(Four volId,    /* IN volume of the file */
+                           Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;                          /* for errors */
+  Four i;                          /* index */
+  FileID fid;                      /* file identifier */
+  ObjectID catObj;                 /* catalog object of the file */
+  BulkLoadInfo blkLdInfo;          /* state of the bulk load */
+  ObjectID oids[APITEST_MANY];     /* loaded objects */
+  char data[APITEST_OBJECT_SIZE];  /* data of an object */
+  Boolean passed;                  /* is the check passed? */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  e = EduOM_InitBulkLoad(&catObj, 100, &blkLdInfo);
+  for (i = 0; e >= eNOERROR && i < APITEST_MANY; i++) {
+    eduom_APITestFill(data, i, APITEST_OBJECT_SIZE);
+    e = EduOM_NextBulkLoad(&blkLdInfo, NULL, APITEST_OBJECT_SIZE, data,
+                           &oids[i]);
+  }
+  if (e >= eNOERROR) e = EduOM_FinalBulkLoad(&blkLdInfo, &dlPool, &dlHead);
+
+  passed = (e == eNOERROR && eduom_APITestCount(&catObj) == APITEST_MANY);
+  for (i = 0; passed && i < APITEST_MANY; i++)
+    passed = eduom_APITestHasData(&oids[i], i, APITEST_OBJECT_SIZE);
+  eduom_APITestResult("EduOM_NextBulkLoad loads every object", passed,
+                      nFailed);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestBulkLoad() */
+
+/*@================================
+ * eduom_APITestPinObject()
+ *================================*/
+/*
+ * Function: Four eduom_APITestPinObject(Four, Four*)
+ *
+ * Description :
+ *  Check that EduOM_PinObject() returns the object data in the buffer, that
+ *  a pinned object cannot be destroyed, and that it can be destroyed after
+ *  EduOM_UnpinObject().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestPinObject(Four volId,    /* IN volume of the file */
+                            Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;                         /* for errors */
+  Four n;                         /* # of accessible bytes */
+  FileID fid;                     /* file identifier */
+  ObjectID catObj;                /* catalog object of the file */
+  ObjectID oid;                   /* object to pin */
+  char *buf;                      /* object data in the buffer */
+  char data[APITEST_OBJECT_SIZE]; /* expected data of the object */
+  Boolean passed;                 /* is the check passed? */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_APITestCreateNear(&catObj, APITEST_BATCH, &oid);
+  if (e < eNOERROR) ERR(e);
+
+  eduom_APITestFill(data, APITEST_BATCH - 1, APITEST_OBJECT_SIZE);
+  n = EduOM_PinObject(&oid, 0, REMAINDER, &buf);
+  passed = (n == APITEST_OBJECT_SIZE && memcmp(buf, data, n) == 0);
+  eduom_APITestResult("EduOM_PinObject returns the object in the buffer",
+                      passed, nFailed);
+  if (n < eNOERROR) ERR(n);
+
+  e = EduOM_DestroyObject(&catObj, &oid, &dlPool, &dlHead);
+  eduom_APITestResult("EduOM_DestroyObject refuses a pinned object",
+                      e == eOBJECTPINNED_EDUOM, nFailed);
+
+  e = EduOM_UnpinObject(&oid);
+  if (e >= eNOERROR) e = EduOM_DestroyObject(&catObj, &oid, &dlPool, &dlHead);
+  passed = (e == eNOERROR && eduom_APITestCount(&catObj) == APITEST_BATCH - 1);
+  eduom_APITestResult("EduOM_UnpinObject allows the object to be destroyed",
+                      passed, nFailed);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestPinObject() */
+
+/*@================================
+ * eduom_APITestPageScan()
+ *================================*/
+/*
+ * Function: Four eduom_APITestPageScan(Four, Four*)
+ *
+ * Description :
+ *  Check that EduOM_NextPageObjects() returns every object of the file once
+ *  with its data in the buffer.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestPageScan(Four volId,    /* IN volume of the file */
+                           Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;                                /* for errors */
+  Four i;                                /* index */
+  Four nEntries;                         /* # of objects of a batch */
+  Four nScanned;                         /* # of scanned objects */
+  FileID fid;                            /* file identifier */
+  ObjectID catObj;                       /* catalog object of the file */
+  ObjectID oid;                          /* last created object */
+  PageScanInfo scan;                     /* state of the scan */
+  ObjectBatchEntry batch[APITEST_BATCH]; /* objects of a batch */
+  Boolean passed;                        /* is the check passed? */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_APITestCreateNear(&catObj, APITEST_MANY, &oid);
+  if (e < eNOERROR) ERR(e);
+
+  e = EduOM_OpenPageScan(&catObj, &scan);
+  if (e < eNOERROR) ERR(e);
+
+  passed = TRUE;
+  nScanned = 0;
+  while ((e = EduOM_NextPageObjects(&scan, batch, APITEST_BATCH,
+                                    &nEntries)) == eNOERROR) {
+    for (i = 0; i < nEntries; i++)
+      if (batch[i].data == NULL || batch[i].length != APITEST_OBJECT_SIZE)
+        passed = FALSE;
+    nScanned += nEntries;
+  }
+  passed = passed && e == EOS && nScanned == APITEST_MANY;
+
+  e = EduOM_ClosePageScan(&scan);
+  if (e < eNOERROR) ERR(e);
+
+  eduom_APITestResult("EduOM_NextPageObjects returns every object", passed,
+                      nFailed);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestPageScan() */
+
+/*@================================
+ * eduom_APITestScanCursor()
+ *================================*/
+/*
+ * Function: Four eduom_APITestScanCursor(Four, Four*)
+ *
+ * Description :
+ *  Check that a scan cursor visits every object of the file forward and
+ *  backward, and the objects of the pages linked after it is opened.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestScanCursor(Four volId,    /* IN volume of the file */
+                             Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;            /* for errors */
+  Four nForward;     /* # of objects visited forward */
+  Four nBackward;    /* # of objects visited backward */
+  Four nGrown;       /* # of objects visited while the file grows */
+  FileID fid;        /* file identifier */
+  ObjectID catObj;   /* catalog object of the file */
+  ObjectID oid;      /* visited object */
+  ObjectID last;     /* last created object */
+  ScanCursor cursor; /* the scan cursor */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_APITestCreateNear(&catObj, APITEST_MANY, &oid);
+  if (e < eNOERROR) ERR(e);
+
+  e = EduOM_OpenScanCursor(&catObj, &cursor);
+  if (e < eNOERROR) ERR(e);
+
+  nForward = 0;
+  while ((e = EduOM_NextScanCursor(&cursor, &oid, NULL)) == eNOERROR)
+    nForward++;
+
+  e = EduOM_CloseScanCursor(&cursor);
+  if (e < eNOERROR) ERR(e);
+
+  e = EduOM_OpenScanCursor(&catObj, &cursor);
+  if (e < eNOERROR) ERR(e);
+
+  nBackward = 0;
+  while ((e = EduOM_PrevScanCursor(&cursor, &oid, NULL)) == eNOERROR)
+    nBackward++;
+
+  e = EduOM_CloseScanCursor(&cursor);
+  if (e < eNOERROR) ERR(e);
+
+  eduom_APITestResult("EduOM_NextScanCursor/PrevScanCursor visit all",
+                      nForward == APITEST_MANY && nBackward == APITEST_MANY,
+                      nFailed);
+
+  // Cursor가 위치한 후 file에 page들을 추가함
+  e = EduOM_OpenScanCursor(&catObj, &cursor);
+  if (e < eNOERROR) ERR(e);
+
+  nGrown = 0;
+  if ((e = EduOM_NextScanCursor(&cursor, &oid, NULL)) == eNOERROR) nGrown++;
+
+  e = eduom_APITestCreateNear(&catObj, APITEST_MANY, &last);
+  if (e < eNOERROR) ERR(e);
+
+  while ((e = EduOM_NextScanCursor(&cursor, &oid, NULL)) == eNOERROR)
+    nGrown++;
+
+  e = EduOM_CloseScanCursor(&cursor);
+  if (e < eNOERROR) ERR(e);
+
+  eduom_APITestResult("EduOM_NextScanCursor visits pages linked after open",
+                      nGrown == 2 * APITEST_MANY, nFailed);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestScanCursor() */
+
+/*@================================
+ * eduom_APITestPlacementPolicy()
+ *================================*/
+/*
+ * Function: Four eduom_APITestPlacementPolicy(Four, Four*)
+ *
+ * Description :
+ *  Check that EduOM_GetPlacementPolicy() returns the policy set by
+ *  EduOM_SetPlacementPolicy() and that an unknown policy is refused.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestPlacementPolicy(Four volId,    /* IN volume of the file */
+                                  Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;          /* for errors */
+  FileID fid;      /* file identifier */
+  ObjectID catObj; /* catalog object of the file */
+  ObjectID oid;    /* last created object */
+  Two policy;      /* policy of the file */
+  Boolean passed;  /* is the check passed? */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  e = EduOM_SetPlacementPolicy(&catObj, PLACEMENT_APPEND_ONLY);
+  if (e >= eNOERROR) e = EduOM_GetPlacementPolicy(&catObj, &policy);
+  passed = (e == eNOERROR && policy == PLACEMENT_APPEND_ONLY);
+  passed = passed && EduOM_SetPlacementPolicy(&catObj, -1) == eBADPARAMETER_OM;
+
+  e = eduom_APITestCreateNear(&catObj, APITEST_MANY, &oid);
+  passed = passed && e == eNOERROR &&
+           eduom_APITestCount(&catObj) == APITEST_MANY;
+  eduom_APITestResult("EduOM_SetPlacementPolicy sets the policy", passed,
+                      nFailed);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestPlacementPolicy() */
+
+/*@================================
+ * eduom_APITestCompaction()
+ *================================*/
+/*
+ * Function: Four eduom_APITestCompaction(Four, Four*)
+ *
+ * Description :
+ *  Check that the pages queued by the destructions are compacted by
+ *  EduOM_CompactPendingPages() and by the compaction worker, keeping the
+ *  data of the remaining objects.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestCompaction(Four volId,    /* IN volume of the file */
+                             Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;                     /* for errors */
+  Four i;                     /* index */
+  Four nCompacted;            /* # of compacted pages */
+  FileID fid;                 /* file identifier */
+  ObjectID catObj;            /* catalog object of the file */
+  ObjectID oids[APITEST_BATCH * 2]; /* objects of the file */
+  char data[APITEST_OBJECT_SIZE];   /* data of an object */
+  Boolean passed;             /* is the check passed? */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  for (i = 0; i < APITEST_BATCH * 2; i++) {
+    eduom_APITestFill(data, i, APITEST_OBJECT_SIZE);
+    e = EduOM_CreateObject(&catObj, (i == 0) ? NULL : &oids[i - 1], NULL,
+                           APITEST_OBJECT_SIZE, data, &oids[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  e = EduOM_SetCompactThreshold(0);
+  if (e < eNOERROR) ERR(e);
+
+  // Destroy every fourth object so that the page has unused bytes
+  for (i = 1; i < APITEST_BATCH * 2; i += 4) {
+    e = EduOM_DestroyObject(&catObj, &oids[i], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  e = EduOM_CompactPendingPages(APITEST_MANY, &nCompacted);
+  passed = (e == eNOERROR && nCompacted >= 1);
+  for (i = 0; passed && i < APITEST_BATCH * 2; i += 2)
+    passed = eduom_APITestHasData(&oids[i], i, APITEST_OBJECT_SIZE);
+  eduom_APITestResult("EduOM_CompactPendingPages compacts queued pages",
+                      passed, nFailed);
+
+  // Destroy other objects while the worker is running
+  e = EduOM_StartCompactor();
+  passed = (e == eNOERROR && EduOM_StartCompactor() == eBADPARAMETER_OM);
+  for (i = 3; e >= eNOERROR && i < APITEST_BATCH * 2; i += 4)
+    e = EduOM_DestroyObject(&catObj, &oids[i], &dlPool, &dlHead);
+  if (e >= eNOERROR) e = EduOM_StopCompactor();
+  passed = passed && e == eNOERROR &&
+           EduOM_StopCompactor() == eBADPARAMETER_OM;
+  for (i = 0; passed && i < APITEST_BATCH * 2; i += 2)
+    passed = eduom_APITestHasData(&oids[i], i, APITEST_OBJECT_SIZE);
+  eduom_APITestResult("EduOM_StartCompactor/StopCompactor run the worker",
+                      passed, nFailed);
+
+  e = EduOM_SetCompactThreshold(NIL);
+  if (e >= eNOERROR) e = EduOM_CompactPendingPages(APITEST_MANY, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestCompaction() */
+
+/*@================================
+ * eduom_APITestUpdateObject()
+ *================================*/
+/*
+ * Function: Four eduom_APITestUpdateObject(Four, Four*)
+ *
+ * Description :
+ *  Check EduOM_WriteObject(), EduOM_AppendToObject() and
+ *  EduOM_TruncateObject() on an object updated in its page,
+ *  EduOM_AppendToObject() on an object which outgrows its page, and
+ *  EduOM_PinObject() on the moved object.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestUpdateObject(Four volId,    /* IN volume of the file */
+                               Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;                             /* for errors */
+  Four n;                             /* # of objects of the file */
+  Four nPinned;                       /* # of accessible bytes */
+  FileID fid;                         /* file identifier */
+  ObjectID catObj;                    /* catalog object of the file */
+  ObjectID first;                     /* first object of the file */
+  ObjectID oid;                       /* last created object */
+  char expected[PAGESIZE];            /* expected data of the object */
+  char buf[PAGESIZE];                 /* data read from the object */
+  char *data;                         /* pinned data of the object */
+  Boolean passed;                     /* is the check passed? */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  // Fill the first page so that the first object cannot grow in it
+  eduom_APITestFill(expected, 0, APITEST_OBJECT_SIZE);
+  e = EduOM_CreateObject(&catObj, NULL, NULL, APITEST_OBJECT_SIZE, expected,
+                         &first);
+  if (e < eNOERROR) ERR(e);
+  for (oid = first, n = 1; n < PAGESIZE / APITEST_OBJECT_SIZE; n++) {
+    e = EduOM_CreateObject(&catObj, &oid, NULL, APITEST_OBJECT_SIZE, expected,
+                           &oid);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  // 1. Write, append and truncate in the page
+  e = EduOM_WriteObject(&catObj, &first, 10, 5, "WRITE", &dlPool, &dlHead);
+  memcpy(&expected[10], "WRITE", 5);
+  if (e >= eNOERROR)
+    e = EduOM_TruncateObject(&catObj, &first, 50, &dlPool, &dlHead);
+  if (e >= eNOERROR)
+    e = EduOM_AppendToObject(&catObj, &first, 6, "APPEND", &dlPool, &dlHead);
+  memcpy(&expected[50], "APPEND", 6);
+
+  passed = (e == eNOERROR &&
+            EduOM_ReadObject(&first, 0, REMAINDER, buf) == 56 &&
+            memcmp(buf, expected, 56) == 0);
+  eduom_APITestResult("EduOM_Write/Truncate/AppendToObject update data",
+                      passed, nFailed);
+
+  // 2. Append more than the page can hold
+  eduom_APITestFill(&expected[56], 1, PAGESIZE / 2);
+  e = EduOM_AppendToObject(&catObj, &first, PAGESIZE / 2, &expected[56],
+                           &dlPool, &dlHead);
+
+  passed = (e == eNOERROR &&
+            EduOM_ReadObject(&first, 0, REMAINDER, buf) == 56 + PAGESIZE / 2 &&
+            memcmp(buf, expected, 56 + PAGESIZE / 2) == 0 &&
+            eduom_APITestCount(&catObj) == n);
+  eduom_APITestResult("EduOM_AppendToObject moves a grown object", passed,
+                      nFailed);
+
+  // 3. Pin the moved object, which cannot be updated until it is unpinned
+  nPinned = EduOM_PinObject(&first, 0, REMAINDER, &data);
+  passed = (nPinned == 56 + PAGESIZE / 2 &&
+            memcmp(data, expected, nPinned) == 0 &&
+            EduOM_AppendToObject(&catObj, &first, 1, "X", &dlPool, &dlHead) ==
+                eOBJECTPINNED_EDUOM);
+  if (nPinned >= eNOERROR)
+    passed = passed && EduOM_UnpinObject(&first) == eNOERROR;
+  eduom_APITestResult("EduOM_PinObject pins a moved object", passed, nFailed);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestUpdateObject() */
+
+/*@================================
+ * eduom_APITestReadahead()
+ *================================*/
+/*
+ * Function: Four eduom_APITestReadahead(Four, Four*)
+ *
+ * Description :
+ *  Check that EduOM_SetReadahead() refuses a window larger than the maximum
+ *  and that a scan with readahead visits every object.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestReadahead(Four volId,    /* IN volume of the file */
+                            Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;            /* for errors */
+  Four n;            /* # of visited objects */
+  FileID fid;        /* file identifier */
+  ObjectID catObj;   /* catalog object of the file */
+  ObjectID oid;      /* visited object */
+  ScanCursor cursor; /* the scan cursor */
+  Boolean passed;    /* is the check passed? */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_APITestCreateNear(&catObj, APITEST_MANY, &oid);
+  if (e < eNOERROR) ERR(e);
+
+  passed = (EduOM_SetReadahead(READAHEAD_MAX_PAGES + 1) == eBADPARAMETER_OM &&
+            EduOM_SetReadahead(2) == eNOERROR);
+
+  e = EduOM_OpenScanCursor(&catObj, &cursor);
+  if (e < eNOERROR) ERR(e);
+
+  n = 0;
+  while ((e = EduOM_NextScanCursor(&cursor, &oid, NULL)) == eNOERROR) n++;
+  passed = passed && e == EOS && n == APITEST_MANY;
+
+  e = EduOM_CloseScanCursor(&cursor);
+  if (e < eNOERROR) ERR(e);
+
+  eduom_APITestResult("EduOM_SetReadahead sets the readahead window", passed,
+                      nFailed);
+
+  e = EduOM_SetReadahead(READAHEAD_DEFAULT_PAGES);
+  if (e < eNOERROR) ERR(e);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestReadahead() */
+
+/*@================================
+ * eduom_APITestPreallocation()
+ *================================*/
+/*
+ * Function: Four eduom_APITestPreallocation(Four, Four*)
+ *
+ * Description :
+ *  Check that the objects are created in a file with preallocation and that
+ *  EduOM_ReleasePreallocatedPages() releases the unused pages, or the
+ *  destruction of the last object of the file if it is not called.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestPreallocation(Four volId,    /* IN volume of the file */
+                                Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;               /* for errors */
+  FileID fid;           /* file identifier */
+  ObjectID catObj;      /* catalog object of the file */
+  ObjectID oid;         /* last created object */
+  Boolean passed;       /* is the check passed? */
+  eduom_FileInfo *info; /* in-memory information of the file */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  e = EduOM_SetPreallocation(&catObj, 8);
+  if (e >= eNOERROR) e = eduom_APITestCreateNear(&catObj, APITEST_MANY, &oid);
+  if (e >= eNOERROR)
+    e = EduOM_ReleasePreallocatedPages(&catObj, &dlPool, &dlHead);
+
+  passed = (e == eNOERROR && eduom_APITestCount(&catObj) == APITEST_MANY &&
+            eduom_APITestHasData(&oid, APITEST_MANY - 1, APITEST_OBJECT_SIZE));
+  eduom_APITestResult("EduOM_SetPreallocation allocates pages in runs",
+                      passed, nFailed);
+
+  // 미리 할당 받은 page들을 반환하지 않고 file의 모든 object를 삭제함
+  e = eduom_APITestCreateNear(&catObj, APITEST_MANY, &oid);
+  while (e >= eNOERROR &&
+         (e = EduOM_NextObject(&catObj, NULL, &oid, NULL)) == eNOERROR)
+    e = EduOM_DestroyObject(&catObj, &oid, &dlPool, &dlHead);
+  if (e >= eNOERROR) e = eduom_GetFileInfo(&fid, &info);
+
+  passed = (e >= eNOERROR && info->prealloc.nextPage == info->prealloc.nPages);
+  eduom_APITestResult("EduOM_DestroyObject releases preallocated pages",
+                      passed, nFailed);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestPreallocation() */
+
+/*@================================
+ * eduom_APITestElementPool()
+ *================================*/
+/*
+ * Function: Four eduom_APITestElementPool(Four, Four*)
+ *
+ * Description :
+ *  Check that EduOM_FlushElementPool() returns the cached elements and
+ *  refuses a NULL pool.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestElementPool(Four volId,    /* IN volume of the file */
+                              Four *nFailed) /* INOUT # of failed checks */
+{
+  eduom_APITestResult("EduOM_FlushElementPool flushes the cache",
+                      EduOM_FlushElementPool(NULL) == eBADPARAMETER_OM &&
+                          EduOM_FlushElementPool(&dlPool) == eNOERROR,
+                      nFailed);
+
+  return (eNOERROR);
+
+} /* eduom_APITestElementPool() */
+
+/*@================================
+ * eduom_APITestStats()
+ *================================*/
+/*
+ * Function: Four eduom_APITestStats(Four, Four*)
+ *
+ * Description :
+ *  Check that EduOM_GetStats() counts the creations of the file since
+ *  EduOM_ResetStats().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestStats(Four volId,    /* IN volume of the file */
+                        Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;            /* for errors */
+  FileID fid;        /* file identifier */
+  ObjectID catObj;   /* catalog object of the file */
+  ObjectID oid;      /* last created object */
+  EduOM_Stats stats; /* statistics of the file */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  e = EduOM_ResetStats();
+  if (e >= eNOERROR) e = eduom_APITestCreateNear(&catObj, APITEST_BATCH, &oid);
+  if (e >= eNOERROR) e = EduOM_GetStats(&catObj, &stats);
+
+  eduom_APITestResult("EduOM_GetStats counts the operations",
+                      e == eNOERROR &&
+                          stats.ops[STATS_OP_CREATE] == APITEST_BATCH,
+                      nFailed);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestStats() */
+
+/*@================================
+ * eduom_APITestReportFile()
+ *================================*/
+/*
+ * Function: Four eduom_APITestReportFile(Four, Four*)
+ *
+ * Description :
+ *  Check that EduOM_ReportFile() writes a report of the file.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestReportFile(Four volId,    /* IN volume of the file */
+                             Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;          /* for errors */
+  FileID fid;      /* file identifier */
+  ObjectID catObj; /* catalog object of the file */
+  ObjectID oid;    /* last created object */
+  FILE *fp;        /* stream of the report */
+  Boolean passed;  /* is the check passed? */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_APITestCreateNear(&catObj, APITEST_MANY, &oid);
+  if (e < eNOERROR) ERR(e);
+
+  fp = tmpfile();
+  passed = (fp != NULL && EduOM_ReportFile(&catObj, fp) == eNOERROR &&
+            ftell(fp) > 0);
+  if (fp != NULL) fclose(fp);
+  eduom_APITestResult("EduOM_ReportFile writes the report", passed, nFailed);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestReportFile() */
+
+/*@================================
+ * eduom_APITestReorganizeFile()
+ *================================*/
+/*
+ * Function: Four eduom_APITestReorganizeFile(Four, Four*)
+ *
+ * Description :
+ *  Check that EduOM_ReorganizeFile() keeps every remaining object of a
+ *  fragmented file with moved objects, and does not add pages.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestReorganizeFile(Four volId,    /* IN volume of the file */
+                                 Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;                          /* for errors */
+  Four i;                          /* index */
+  Four nLive;                      /* # of remaining objects */
+  Four nReleased;                  /* # of released pages */
+  FileID fid;                      /* file identifier */
+  ObjectID catObj;                 /* catalog object of the file */
+  ObjectID oids[APITEST_REORG];    /* objects of the file */
+  char data[APITEST_OBJECT_SIZE * 4]; /* data of an object */
+  Boolean passed;                  /* is the check passed? */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  // Grow every third object out of its page, then destroy 7 of 10 objects
+  for (i = 0; i < APITEST_REORG; i++) {
+    eduom_APITestFill(data, i, APITEST_OBJECT_SIZE * 4);
+    e = EduOM_CreateObject(&catObj, (i == 0) ? NULL : &oids[i - 1], NULL,
+                           APITEST_OBJECT_SIZE, data, &oids[i]);
+    if (e >= eNOERROR && i % 3 == 0)
+      e = EduOM_AppendToObject(&catObj, &oids[i], APITEST_OBJECT_SIZE * 3,
+                               &data[APITEST_OBJECT_SIZE], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  nLive = 0;
+  for (i = 0; i < APITEST_REORG; i++) {
+    if (i % 10 < 7) {
+      e = EduOM_DestroyObject(&catObj, &oids[i], &dlPool, &dlHead);
+      if (e < eNOERROR) ERR(e);
+    } else {
+      nLive++;
+    }
+  }
+
+  e = EduOM_ReorganizeFile(&catObj, 90, &dlPool, &dlHead, &nReleased);
+
+  passed = (e == eNOERROR && nReleased >= 0 &&
+            eduom_APITestCount(&catObj) == nLive);
+  for (i = 0; passed && i < APITEST_REORG; i++)
+    if (i % 10 >= 7)
+      passed = eduom_APITestHasData(
+          &oids[i], i, APITEST_OBJECT_SIZE * ((i % 3 == 0) ? 4 : 1));
+  eduom_APITestResult("EduOM_ReorganizeFile keeps the remaining objects",
+                      passed, nFailed);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestReorganizeFile() */
+
+/*@================================
+ * eduom_APITestClusterRadius()
+ *================================*/
+/*
+ * Function: Four eduom_APITestClusterRadius(Four, Four*)
+ *
+ * Description :
+ *  Check that EduOM_SetClusterRadius() refuses a negative radius and that
+ *  the objects are created near each other with clustering enabled.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestClusterRadius(Four volId,    /* IN volume of the file */
+                                Four *nFailed) /* INOUT # of failed checks */
+{
+  Four e;          /* for errors */
+  FileID fid;      /* file identifier */
+  ObjectID catObj; /* catalog object of the file */
+  ObjectID oid;    /* last created object */
+  Boolean passed;  /* is the check passed? */
+
+  e = eduom_APITestCreateFile(volId, &fid, &catObj);
+  if (e < eNOERROR) ERR(e);
+
+  passed = (EduOM_SetClusterRadius(-1) == eBADPARAMETER_OM &&
+            EduOM_SetClusterRadius(2) == eNOERROR);
+
+  e = eduom_APITestCreateNear(&catObj, APITEST_MANY, &oid);
+  passed = passed && e == eNOERROR &&
+           eduom_APITestCount(&catObj) == APITEST_MANY;
+  eduom_APITestResult("EduOM_SetClusterRadius sets the search radius",
+                      passed, nFailed);
+
+  e = EduOM_SetClusterRadius(0);
+  if (e < eNOERROR) ERR(e);
+
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestClusterRadius() */
+
+/*@================================
+ * eduom_APITestCreateFile()
+ *================================*/
+/*
+ * Function: Four eduom_APITestCreateFile(Four, FileID*, ObjectID*)
+ *
+ * Description :
+ *  Create a data file for a check.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_APITestCreateFile(Four volId,       /* IN volume of the file */
+                             FileID *fid,      /* OUT file identifier */
+                             ObjectID *catObj) /* OUT catalog object */
+{
+  Four e; /* for errors */
+
+  e = SM_CreateFile(volId, fid, FALSE, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, fid, catObj);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_APITestCreateFile() */
+
+/*@================================
+ * eduom_APITestCreateNear()
+ *================================*/
+/*
+ * Function: Four eduom_APITestCreateNear(ObjectID*, Four, ObjectID*)
+ *
+ * Description :
+ *  Create 'n' objects in the file, each near the previous one. The data of
+ *  the i-th object is filled by eduom_APITestFill() with the seed i.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter oid
+ *     'oid' is set to the last created object
+ */
+Four eduom_APITestCreateNear(ObjectID *catObj, /* IN file of the objects */
+                             Four n,           /* IN # of objects */
+                             ObjectID *oid)    /* OUT last created object */
+{
+  Four e;                         /* for errors */
+  Four i;                         /* index */
+  char data[APITEST_OBJECT_SIZE]; /* data of an object */
+
+  for (i = 0; i < n; i++) {
+    eduom_APITestFill(data, i, APITEST_OBJECT_SIZE);
+    e = EduOM_CreateObject(catObj, (i == 0) ? NULL : oid, NULL,
+                           APITEST_OBJECT_SIZE, data, oid);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  return (eNOERROR);
+
+} /* eduom_APITestCreateNear() */
+
+/*@================================
+ * eduom_APITestCount()
+ *================================*/
+/*
+ * Function: Four eduom_APITestCount(ObjectID*)
+ *
+ * Description :
+ *  Count the objects of the file with EduOM_NextObject().
+ *
+ * Returns:
+ *  1) number of the objects (values greater than or equal to 0)
+ *  2) error code (negative values)
+ *    some errors caused by function calls
+ */
+Four eduom_APITestCount(ObjectID *catObj) /* IN file to count */
+{
+  Four e;       /* for errors */
+  Four n;       /* # of objects */
+  ObjectID oid; /* current object */
+
+  n = 0;
+  e = EduOM_NextObject(catObj, NULL, &oid, NULL);
+  while (e >= eNOERROR && e != EOS) {
+    n++;
+    e = EduOM_NextObject(catObj, &oid, &oid, NULL);
+  }
+  if (e < eNOERROR) ERR(e);
+
+  return (n);
+
+} /* eduom_APITestCount() */
+
+/*@================================
+ * eduom_APITestFill()
+ *================================*/
+/*
+ * Function: void eduom_APITestFill(char*, Four, Four)
+ *
+ * Description :
+ *  Fill 'length' bytes of 'buf' with letters depending on 'seed', so that
+ *  the objects of a check have different data.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_APITestFill(char *buf,   /* OUT buffer to fill */
+                       Four seed,   /* IN seed of the data */
+                       Four length) /* IN # of bytes to fill */
+{
+  Four i; /* index */
+
+  for (i = 0; i < length; i++) buf[i] = 'a' + (seed + i) % 26;
+
+} /* eduom_APITestFill() */
+
+/*@================================
+ * eduom_APITestHasData()
+ *================================*/
+/*
+ * Function: Boolean eduom_APITestHasData(ObjectID*, Four, Four)
+ *
+ * Description :
+ *  Check that the object has 'length' bytes filled by eduom_APITestFill()
+ *  with the seed 'seed'.
+ *
+ * Returns:
+ *  TRUE if the object has the data, FALSE otherwise
+ */
+Boolean eduom_APITestHasData(ObjectID *oid, /* IN object to check */
+                             Four seed,     /* IN seed of the data */
+                             Four length)   /* IN length of the data */
+{
+  char expected[PAGESIZE]; /* expected data */
+  char buf[PAGESIZE];      /* data read from the object */
+
+  if (length > PAGESIZE) return (FALSE);
+
+  eduom_APITestFill(expected, seed, length);
+
+  return (EduOM_ReadObject(oid, 0, REMAINDER, buf) == length &&
+          memcmp(buf, expected, length) == 0);
+
+} /* eduom_APITestHasData() */
+
+/*@================================
+ * eduom_APITestResult()
+ *================================*/
+/*
+ * Function: void eduom_APITestResult(char*, Boolean, Four*)
+ *
+ * Description :
+ *  Print the result of a check and count it if it has failed.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_APITestResult(char *name,     /* IN name of the check */
+                         Boolean passed, /* IN is the check passed? */
+                         Four *nFailed)  /* INOUT # of failed checks */
+{
+  printf("%-56s %s\n", name, passed ? "PASS" : "FAIL");
+
+  if (!passed) (*nFailed)++;
+
+} /* eduom_APITestResult() */
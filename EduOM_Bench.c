@@ -0,0 +1,754 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Bench.c
+ *
+ * Description :
+ *  Micro-benchmark of EduOM. A volume is formatted and mounted as in
+ *  EduOM_TestModule.c and the following workloads are run in order:
+ *    seqinsert   objects of a fixed size, each near the previous one
+ *    randinsert  objects of random sizes, each near the previous one
+ *    churn       destroy a random object and insert a new one of random size
+ *    pointread   read a random object in full
+ *    fwdscan     scan the file forward with a scan cursor
+ *    bwdscan     scan the file backward with a scan cursor
+ *  'seqinsert' fills a file of its own; the other workloads work on the file
+ *  filled by 'randinsert'. For each workload the throughput, the latency
+ *  percentiles, the # of pages of the file and some of the EduOM statistics
+ *  are reported. With '-R', the fragmentation report of the file of the
+ *  workloads (see EduOM_ReportFile()) is written to the given path at the end.
+ *  With '-C', the inserts near the previous object search the given number
+ *  of pages around the full page (see EduOM_SetClusterRadius()). With '-c',
+ *  the pages whose unused bytes exceed the given threshold are compacted by
+ *  the compaction worker during the workloads (see EduOM_StartCompactor()).
+ *
+ *  Usage: EduOM_Bench [-n ops] [-s size] [-m minSize] [-M maxSize]
+ *                     [-p pages] [-P policy] [-C radius] [-c threshold]
+ *                     [-r seed] [-R report]
+ *
+ * Exports:
+ *  Four main(int, char**)
+ *
+ * Internal Functions:
+ *  Four eduom_BenchRun(Four, BenchParam*)
+ *  Four eduom_BenchInsert(char*, ObjectID*, ObjectID*, BenchParam*, Boolean)
+ *  Four eduom_BenchChurn(ObjectID*, ObjectID*, BenchParam*)
+ *  Four eduom_BenchRead(ObjectID*, BenchParam*)
+ *  Four eduom_BenchScan(char*, ObjectID*, BenchParam*, Boolean)
+ *  Four eduom_BenchCountPages(ObjectID*)
+ *  Four eduom_BenchObjectSize(BenchParam*)
+ *  unsigned long long eduom_BenchElapsed(struct timespec*, struct timespec*)
+ *  void eduom_BenchReport(char*, Four, unsigned long long, ObjectID*,
+ *                         BenchParam*)
+ *  int eduom_BenchCompareLatency(const void*, const void*)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "EduOM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_TestModule.h"
+#include "EduOM_common.h"
+
+/* default values of the parameters */
+#define BENCH_DEFAULT_OPS 10000
+#define BENCH_DEFAULT_SIZE 64
+#define BENCH_DEFAULT_MIN_SIZE 16
+#define BENCH_DEFAULT_MAX_SIZE 256
+#define BENCH_DEFAULT_PAGES 8000
+
+/*
+ * Typedef for the parameters of the benchmark
+ */
+typedef struct {
+  Four nOps;                  /* # of operations of each workload */
+  Four size;                  /* object size of 'seqinsert' */
+  Four minSize;               /* minimum object size of the other workloads */
+  Four maxSize;               /* maximum object size of the other workloads */
+  Two policy;                 /* placement policy of the files, NIL if none */
+  unsigned long long *latency; /* latency of each operation in ns */
+  char *data;                 /* data of the objects to be inserted */
+  char *reportPath;           /* path of the file report, NULL if none */
+  Four compactThreshold;      /* compaction threshold, NIL if no worker */
+} BenchParam;
+
+Four eduom_BenchRun(Four, BenchParam *);
+Four eduom_BenchInsert(char *, ObjectID *, ObjectID *, BenchParam *, Boolean);
+Four eduom_BenchChurn(ObjectID *, ObjectID *, BenchParam *);
+Four eduom_BenchRead(ObjectID *, BenchParam *);
+Four eduom_BenchScan(char *, ObjectID *, BenchParam *, Boolean);
+Four eduom_BenchCountPages(ObjectID *);
+Four eduom_BenchObjectSize(BenchParam *);
+unsigned long long eduom_BenchElapsed(struct timespec *, struct timespec *);
+void eduom_BenchReport(char *, Four, unsigned long long, ObjectID *,
+                       BenchParam *);
+int eduom_BenchCompareLatency(const void *, const void *);
+
+/*@================================
+ * main()
+ *================================*/
+/*
+ * Function: Four main(int, char**)
+ *
+ * Description :
+ *  Parse the parameters, format and mount the benchmark volume and run the
+ *  workloads in a transaction.
+ *
+ * Returns:
+ *  0 on success, 1 on failure
+ */
+Four main(int argc, char *argv[]) {
+  Four e;                                    /* for errors */
+  Four opt;                                  /* option character */
+  Four handle;                               /* system handle */
+  Four numDevices;                           /* # of devices of the volume */
+  char *devNames[MAX_DEVICES_IN_VOLUME];     /* device name */
+  Four volId;                                /* volume identifier */
+  Four numPagesInDevices[MAX_DEVICES_IN_VOLUME]; /* # of pages of devices */
+  XactID xactId;                             /* transaction identifier */
+  BenchParam param;                          /* parameters of the benchmark */
+  Four seed;                                 /* seed of the random numbers */
+  Four radius;                               /* cluster radius of inserts */
+
+  // 1. 파라미터를 읽음
+  param.nOps = BENCH_DEFAULT_OPS;
+  param.size = BENCH_DEFAULT_SIZE;
+  param.minSize = BENCH_DEFAULT_MIN_SIZE;
+  param.maxSize = BENCH_DEFAULT_MAX_SIZE;
+  param.policy = NIL;
+  param.reportPath = NULL;
+  param.compactThreshold = NIL;
+  numPagesInDevices[0] = BENCH_DEFAULT_PAGES;
+  seed = 1;
+  radius = 0;
+
+  while ((opt = getopt(argc, argv, "n:s:m:M:p:P:C:c:r:R:")) != -1) {
+    switch (opt) {
+      case 'n':
+        param.nOps = atoi(optarg);
+        break;
+      case 's':
+        param.size = atoi(optarg);
+        break;
+      case 'm':
+        param.minSize = atoi(optarg);
+        break;
+      case 'M':
+        param.maxSize = atoi(optarg);
+        break;
+      case 'p':
+        numPagesInDevices[0] = atoi(optarg);
+        break;
+      case 'P':
+        param.policy = atoi(optarg);
+        break;
+      case 'C':
+        radius = atoi(optarg);
+        break;
+      case 'c':
+        param.compactThreshold = atoi(optarg);
+        break;
+      case 'r':
+        seed = atoi(optarg);
+        break;
+      case 'R':
+        param.reportPath = optarg;
+        break;
+      default:
+        printf(
+            "Usage: %s [-n ops] [-s size] [-m minSize] [-M maxSize] "
+            "[-p pages] [-P policy] [-C radius] [-c threshold] [-r seed] "
+            "[-R report]\n",
+            argv[0]);
+        exit(1);
+    }
+  }
+
+  // Large object은 slotted page에 저장되지 않으므로 크기를 제한함
+  if (param.nOps <= 0 || param.size <= 0 || param.minSize <= 0 ||
+      param.maxSize < param.minSize ||
+      ALIGNED_LENGTH(MAX(param.size, param.maxSize)) > LRGOBJ_THRESHOLD ||
+      EduOM_SetClusterRadius(radius) < eNOERROR ||
+      EduOM_SetCompactThreshold(param.compactThreshold) < eNOERROR) {
+    printf("Invalid parameters!!!\n");
+    exit(1);
+  }
+  srand(seed);
+
+  param.latency = (unsigned long long *)malloc(sizeof(unsigned long long) *
+                                               param.nOps);
+  param.data = (char *)malloc(MAX(param.size, param.maxSize));
+  if (param.latency == NULL || param.data == NULL) {
+    printf("Memory allocation failed!!!\n");
+    exit(1);
+  }
+  memset(param.data, 'x', MAX(param.size, param.maxSize));
+
+  // 2. Volume을 format 하고 mount 함
+  e = LRDS_Init();
+  if (e < eNOERROR) {
+    printf("LRDS_Init failed!!!\n");
+    exit(1);
+  }
+
+  e = LRDS_AllocHandle(&handle);
+  if (e < eNOERROR) {
+    printf("LRDS_AllocHandle failed!!!\n");
+    LRDS_Final();
+    exit(1);
+  }
+
+  numDevices = 1;
+  devNames[0] = "bench.vol";
+  volId = 1001;
+
+  e = LRDS_FormatDataVolume(numDevices, devNames, "bench", volId, 16,
+                            numPagesInDevices, 16);
+  if (e < eNOERROR) {
+    printf("LRDS_FormatDataVolume failed!!!\n");
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+    exit(1);
+  }
+
+  e = LRDS_Mount(numDevices, devNames, &volId);
+  if (e < eNOERROR) {
+    printf("LRDS_Mount failed!!!\n");
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+    exit(1);
+  }
+
+  // 3. Transaction 안에서 workload들을 수행함
+  e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+  if (e < eNOERROR) {
+    printf("LRDS_BeginTransaction failed!!!\n");
+    LRDS_Dismount(volId);
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+    exit(1);
+  }
+
+  e = eduom_BenchRun(volId, &param);
+  if (e < eNOERROR) {
+    printf("EduOM_Bench failed!!! (error %ld)\n", (long)e);
+    LRDS_AbortTransaction(&xactId);
+    LRDS_Dismount(volId);
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+    exit(1);
+  }
+
+  e = LRDS_CommitTransaction(&xactId);
+  if (e < eNOERROR) {
+    printf("LRDS_CommitTransaction failed!!!\n");
+    LRDS_Dismount(volId);
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+    exit(1);
+  }
+
+  // 4. Volume을 dismount 하고 시스템을 종료함
+  e = LRDS_Dismount(volId);
+  if (e < eNOERROR) {
+    printf("LRDS_Dismount failed!!!\n");
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+    exit(1);
+  }
+
+  e = LRDS_FreeHandle(handle);
+  if (e < eNOERROR) {
+    printf("LRDS_FreeHandle failed!!!\n");
+    LRDS_Final();
+    exit(1);
+  }
+
+  e = LRDS_Final();
+  if (e < eNOERROR) {
+    printf("LRDS_Final failed!!!\n");
+    exit(1);
+  }
+
+  free(param.latency);
+  free(param.data);
+
+  return 0;
+}
+
+/*@================================
+ * eduom_BenchRun()
+ *================================*/
+/*
+ * Function: Four eduom_BenchRun(Four, BenchParam*)
+ *
+ * Description :
+ *  Create the files of the benchmark and run the workloads in order, with the
+ *  compaction worker running if it is requested. Then write the report of
+ *  the file of the workloads if it is requested.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUOM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four eduom_BenchRun(Four volId,        /* IN volume of the files */
+                    BenchParam *param) /* IN parameters of the benchmark */
+{
+  Four e;              /* error number */
+  Four e2;             /* error number of the cleanup */
+  FileID fid;          /* ID of a file */
+  ObjectID seqCatObj;  /* catalog object of the file of 'seqinsert' */
+  ObjectID catObj;     /* catalog object of the file of the other workloads */
+  ObjectID *oids;      /* objects of the file of the other workloads */
+  FILE *fp;            /* stream of the file report */
+  Boolean compactor;   /* is the compaction worker started? */
+
+  printf("EduOM_Bench: %ld ops, size %ld, random size %ld-%ld, policy %ld\n",
+         (long)param->nOps, (long)param->size, (long)param->minSize,
+         (long)param->maxSize, (long)param->policy);
+  printf("%-12s %8s %12s %8s %10s %10s %10s %10s %8s %8s %10s\n", "workload",
+         "ops", "ops/sec", "pages", "p50(us)", "p90(us)", "p99(us)",
+         "max(us)", "fix/op", "compact", "allocated");
+
+  oids = (ObjectID *)malloc(sizeof(ObjectID) * param->nOps);
+  if (oids == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+  // 1. File을 생성하고 placement policy를 설정함
+  e = SM_CreateFile(volId, &fid, FALSE, NULL);
+  if (e >= eNOERROR)
+    e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &seqCatObj);
+  if (e >= eNOERROR) e = SM_CreateFile(volId, &fid, FALSE, NULL);
+  if (e >= eNOERROR)
+    e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catObj);
+  if (e >= eNOERROR && param->policy != NIL) {
+    e = EduOM_SetPlacementPolicy(&seqCatObj, param->policy);
+    if (e >= eNOERROR) e = EduOM_SetPlacementPolicy(&catObj, param->policy);
+  }
+
+  // 2. Workload들을 차례대로 수행함
+  // 요청된 경우, workload들을 수행하는 동안 compaction worker를 실행함
+  compactor = FALSE;
+  if (e >= eNOERROR && param->compactThreshold != NIL) {
+    e = EduOM_StartCompactor();
+    if (e >= eNOERROR) compactor = TRUE;
+  }
+  if (e >= eNOERROR)
+    e = eduom_BenchInsert("seqinsert", &seqCatObj, oids, param, FALSE);
+  if (e >= eNOERROR)
+    e = eduom_BenchInsert("randinsert", &catObj, oids, param, TRUE);
+  if (e >= eNOERROR) e = eduom_BenchChurn(&catObj, oids, param);
+  if (e >= eNOERROR) e = eduom_BenchRead(oids, param);
+  if (e >= eNOERROR) e = eduom_BenchScan("fwdscan", &catObj, param, TRUE);
+  if (e >= eNOERROR) e = eduom_BenchScan("bwdscan", &catObj, param, FALSE);
+
+  if (compactor) {
+    e2 = EduOM_StopCompactor();
+    if (e >= eNOERROR) e = e2;
+  }
+
+  free(oids);
+  if (e < eNOERROR) ERR(e);
+
+  // 3. File의 fragmentation report를 출력함
+  if (param->reportPath != NULL) {
+    fp = fopen(param->reportPath, "w");
+    if (fp == NULL) ERR(eBADPARAMETER_OM);
+
+    e = EduOM_ReportFile(&catObj, fp);
+    fclose(fp);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  return (eNOERROR);
+
+} /* eduom_BenchRun() */
+
+/*@================================
+ * eduom_BenchInsert()
+ *================================*/
+/*
+ * Function: Four eduom_BenchInsert(char*, ObjectID*, ObjectID*, BenchParam*,
+ *                                  Boolean)
+ *
+ * Description :
+ *  Insert 'nOps' objects into the file, each near the previous one. The
+ *  objects are of the size 'size', or of random sizes if 'randomSize' is
+ *  TRUE. The IDs of the inserted objects are returned in 'oids'.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_BenchInsert(char *name,         /* IN name of the workload */
+                       ObjectID *catObj,   /* IN file to insert into */
+                       ObjectID *oids,     /* OUT inserted objects */
+                       BenchParam *param,  /* IN parameters of the benchmark */
+                       Boolean randomSize) /* IN use random sizes? */
+{
+  Four e;                   /* error number */
+  Four i;                   /* index variable */
+  Four length;              /* length of the object */
+  struct timespec start;    /* start time of the workload */
+  struct timespec opStart;  /* start time of the operation */
+  struct timespec opEnd;    /* end time of the operation */
+
+  EduOM_ResetStats();
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (i = 0; i < param->nOps; i++) {
+    length = randomSize ? eduom_BenchObjectSize(param) : param->size;
+
+    clock_gettime(CLOCK_MONOTONIC, &opStart);
+    e = EduOM_CreateObject(catObj, i == 0 ? NULL : &oids[i - 1], NULL, length,
+                           param->data, &oids[i]);
+    clock_gettime(CLOCK_MONOTONIC, &opEnd);
+    if (e < eNOERROR) ERR(e);
+
+    param->latency[i] = eduom_BenchElapsed(&opStart, &opEnd);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &opEnd);
+  eduom_BenchReport(name, param->nOps, eduom_BenchElapsed(&start, &opEnd),
+                    catObj, param);
+
+  return (eNOERROR);
+
+} /* eduom_BenchInsert() */
+
+/*@================================
+ * eduom_BenchChurn()
+ *================================*/
+/*
+ * Function: Four eduom_BenchChurn(ObjectID*, ObjectID*, BenchParam*)
+ *
+ * Description :
+ *  Destroy a random object of 'oids' and insert a new object of random size
+ *  in its place, 'nOps' times. An operation is the pair of the destroy and
+ *  the insert.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_BenchChurn(ObjectID *catObj,  /* IN file of the objects */
+                      ObjectID *oids,    /* INOUT objects of the file */
+                      BenchParam *param) /* IN parameters of the benchmark */
+{
+  Four e;                   /* error number */
+  Four i;                   /* index variable */
+  Four victim;              /* index of the object to be destroyed */
+  Four length;              /* length of the new object */
+  struct timespec start;    /* start time of the workload */
+  struct timespec opStart;  /* start time of the operation */
+  struct timespec opEnd;    /* end time of the operation */
+
+  EduOM_ResetStats();
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (i = 0; i < param->nOps; i++) {
+    victim = rand() % param->nOps;
+    length = eduom_BenchObjectSize(param);
+
+    clock_gettime(CLOCK_MONOTONIC, &opStart);
+    e = EduOM_DestroyObject(catObj, &oids[victim], &dlPool, &dlHead);
+    if (e >= eNOERROR)
+      e = EduOM_CreateObject(catObj, NULL, NULL, length, param->data,
+                             &oids[victim]);
+    clock_gettime(CLOCK_MONOTONIC, &opEnd);
+    if (e < eNOERROR) ERR(e);
+
+    param->latency[i] = eduom_BenchElapsed(&opStart, &opEnd);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &opEnd);
+  eduom_BenchReport("churn", param->nOps, eduom_BenchElapsed(&start, &opEnd),
+                    catObj, param);
+
+  return (eNOERROR);
+
+} /* eduom_BenchChurn() */
+
+/*@================================
+ * eduom_BenchRead()
+ *================================*/
+/*
+ * Function: Four eduom_BenchRead(ObjectID*, BenchParam*)
+ *
+ * Description :
+ *  Read a random object of 'oids' in full, 'nOps' times.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_BenchRead(ObjectID *oids,    /* IN objects to read */
+                     BenchParam *param) /* IN parameters of the benchmark */
+{
+  Four e;                   /* error number */
+  Four i;                   /* index variable */
+  ObjectID *oid;            /* object to read */
+  struct timespec start;    /* start time of the workload */
+  struct timespec opStart;  /* start time of the operation */
+  struct timespec opEnd;    /* end time of the operation */
+
+  EduOM_ResetStats();
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (i = 0; i < param->nOps; i++) {
+    oid = &oids[rand() % param->nOps];
+
+    clock_gettime(CLOCK_MONOTONIC, &opStart);
+    e = EduOM_ReadObject(oid, 0, REMAINDER, param->data);
+    clock_gettime(CLOCK_MONOTONIC, &opEnd);
+    if (e < eNOERROR) ERR(e);
+
+    param->latency[i] = eduom_BenchElapsed(&opStart, &opEnd);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &opEnd);
+  eduom_BenchReport("pointread", param->nOps,
+                    eduom_BenchElapsed(&start, &opEnd), NULL, param);
+
+  return (eNOERROR);
+
+} /* eduom_BenchRead() */
+
+/*@================================
+ * eduom_BenchScan()
+ *================================*/
+/*
+ * Function: Four eduom_BenchScan(char*, ObjectID*, BenchParam*, Boolean)
+ *
+ * Description :
+ *  Scan the whole file forward with EduOM_NextScanCursor(), or backward with
+ *  EduOM_PrevScanCursor() if 'forward' is FALSE. An operation is a call which
+ *  returns an object; the latencies of the first 'nOps' calls are kept.
+ *  The scan cursor is used since it skips the empty slots and reports the
+ *  end of the scan.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_BenchScan(char *name,        /* IN name of the workload */
+                     ObjectID *catObj,  /* IN file to scan */
+                     BenchParam *param, /* IN parameters of the benchmark */
+                     Boolean forward)   /* IN scan direction */
+{
+  Four e;                   /* error number */
+  Four nObjects;            /* # of objects returned */
+  ObjectID oid;             /* current object */
+  ScanCursor cursor;        /* cursor of the scan */
+  struct timespec start;    /* start time of the workload */
+  struct timespec opStart;  /* start time of the operation */
+  struct timespec opEnd;    /* end time of the operation */
+
+  EduOM_ResetStats();
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  e = EduOM_OpenScanCursor(catObj, &cursor);
+  if (e < eNOERROR) ERR(e);
+
+  for (nObjects = 0;; nObjects++) {
+    clock_gettime(CLOCK_MONOTONIC, &opStart);
+    if (forward) {
+      e = EduOM_NextScanCursor(&cursor, &oid, NULL);
+    } else {
+      e = EduOM_PrevScanCursor(&cursor, &oid, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &opEnd);
+    if (e < eNOERROR || e == EOS) break;
+
+    if (nObjects < param->nOps)
+      param->latency[nObjects] = eduom_BenchElapsed(&opStart, &opEnd);
+  }
+
+  EduOM_CloseScanCursor(&cursor);
+  if (e < eNOERROR) ERR(e);
+
+  clock_gettime(CLOCK_MONOTONIC, &opEnd);
+  eduom_BenchReport(name, nObjects, eduom_BenchElapsed(&start, &opEnd),
+                    catObj, param);
+
+  return (eNOERROR);
+
+} /* eduom_BenchScan() */
+
+/*@================================
+ * eduom_BenchCountPages()
+ *================================*/
+/*
+ * Function: Four eduom_BenchCountPages(ObjectID*)
+ *
+ * Description :
+ *  Count the pages of the file by following the page list of the file from
+ *  its first page.
+ *
+ * Returns:
+ *  # of pages of the file
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_BenchCountPages(ObjectID *catObj) /* IN file to count */
+{
+  Four e;                    /* error number */
+  Four nPages;               /* # of pages */
+  PageID pid;                /* current page */
+  SlottedPage *apage;        /* buffer holding the current page */
+  ShortPageID nextPage;      /* next page of the current page */
+  eduom_CatalogDesc catDesc; /* cached catalog information of the file */
+
+  e = eduom_GetCatalogDesc(catObj, &catDesc);
+  if (e < eNOERROR) ERR(e);
+
+  MAKE_PAGEID(pid, catDesc.fid.volNo, catDesc.firstPage);
+  for (nPages = 1;; nPages++) {
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    nextPage = apage->header.nextPage;
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (pid.pageNo == catDesc.lastPage || nextPage == NIL) break;
+    pid.pageNo = nextPage;
+  }
+
+  return (nPages);
+
+} /* eduom_BenchCountPages() */
+
+/*@================================
+ * eduom_BenchObjectSize()
+ *================================*/
+/*
+ * Function: Four eduom_BenchObjectSize(BenchParam*)
+ *
+ * Description :
+ *  Choose a random object size between 'minSize' and 'maxSize'.
+ *
+ * Returns:
+ *  object size
+ */
+Four eduom_BenchObjectSize(BenchParam *param) /* IN parameters */
+{
+  return (param->minSize + rand() % (param->maxSize - param->minSize + 1));
+
+} /* eduom_BenchObjectSize() */
+
+/*@================================
+ * eduom_BenchElapsed()
+ *================================*/
+/*
+ * Function: unsigned long long eduom_BenchElapsed(struct timespec*,
+ *                                                 struct timespec*)
+ *
+ * Description :
+ *  Compute the time between the two given times.
+ *
+ * Returns:
+ *  elapsed time in ns
+ */
+unsigned long long eduom_BenchElapsed(struct timespec *start, /* IN start */
+                                      struct timespec *end)   /* IN end */
+{
+  return ((unsigned long long)(end->tv_sec - start->tv_sec) * 1000000000ULL +
+          end->tv_nsec - start->tv_nsec);
+
+} /* eduom_BenchElapsed() */
+
+/*@================================
+ * eduom_BenchReport()
+ *================================*/
+/*
+ * Function: void eduom_BenchReport(char*, Four, unsigned long long,
+ *                                  ObjectID*, BenchParam*)
+ *
+ * Description :
+ *  Print the result of a workload: the throughput, the latency percentiles
+ *  of the kept latencies, the # of pages of the file, if given, and the
+ *  buffer fixes per operation, the compactions and the pages allocated
+ *  during the workload.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_BenchReport(char *name,               /* IN name of the workload */
+                       Four nOps,                /* IN # of operations */
+                       unsigned long long total, /* IN elapsed time in ns */
+                       ObjectID *catObj,         /* IN file, or NULL */
+                       BenchParam *param)        /* IN parameters */
+{
+  Four nKept;         /* # of the kept latencies */
+  Four nPages;        /* # of pages of the file */
+  EduOM_Stats stats;  /* statistics of the workload */
+  unsigned long long *lat; /* sorted latencies */
+
+  nKept = MIN(nOps, param->nOps);
+  lat = param->latency;
+  qsort(lat, nKept, sizeof(unsigned long long), eduom_BenchCompareLatency);
+
+  nPages = catObj != NULL ? eduom_BenchCountPages(catObj) : 0;
+  if (EduOM_GetStats(NULL, &stats) < eNOERROR) memset(&stats, 0, sizeof(stats));
+
+  printf("%-12s %8ld %12.0f %8ld %10.2f %10.2f %10.2f %10.2f %8.2f %8llu "
+         "%10llu\n",
+         name, (long)nOps, total > 0 ? nOps * 1e9 / total : 0.0,
+         (long)nPages, nKept > 0 ? lat[nKept * 50 / 100] / 1e3 : 0.0,
+         nKept > 0 ? lat[nKept * 90 / 100] / 1e3 : 0.0,
+         nKept > 0 ? lat[nKept * 99 / 100] / 1e3 : 0.0,
+         nKept > 0 ? lat[nKept - 1] / 1e3 : 0.0,
+         nOps > 0 ? (double)stats.bufferFixes / nOps : 0.0, stats.compactions,
+         stats.pagesAllocated);
+
+} /* eduom_BenchReport() */
+
+/*@================================
+ * eduom_BenchCompareLatency()
+ *================================*/
+/*
+ * Function: int eduom_BenchCompareLatency(const void*, const void*)
+ *
+ * Description :
+ *  Compare two latencies for qsort().
+ *
+ * Returns:
+ *  negative, zero or positive as the first latency is smaller, equal or larger
+ */
+int eduom_BenchCompareLatency(const void *a, /* IN first latency */
+                              const void *b) /* IN second latency */
+{
+  unsigned long long x = *(unsigned long long *)a; /* first latency */
+  unsigned long long y = *(unsigned long long *)b; /* second latency */
+
+  return (x < y) ? -1 : (x > y);
+
+} /* eduom_BenchCompareLatency() */
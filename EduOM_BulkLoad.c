@@ -0,0 +1,458 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_BulkLoad.c
+ *
+ * Description :
+ *  Bulk load of objects into a data file. Objects are appended into freshly
+ *  allocated pages filled up to a given fill factor; the pages are put into
+ *  the available space lists only once, when the load is finished.
+ *
+ * Exports:
+ *  Four EduOM_InitBulkLoad(ObjectID*, Two, BulkLoadInfo*)
+ *  Four EduOM_NextBulkLoad(BulkLoadInfo*, ObjectHdr*, Four, char*, ObjectID*)
+ *  Four EduOM_FinalBulkLoad(BulkLoadInfo*, Pool*, DeallocListElem*)
+ *
+ * Internal Functions:
+ *  Four eduom_NextBulkLoad(BulkLoadInfo*, ObjectHdr*, Four, char*, ObjectID*)
+ *  Four eduom_FinalBulkLoad(BulkLoadInfo*, Pool*, DeallocListElem*)
+ *  Four eduom_FinishBulkLoadPage(BulkLoadInfo*)
+ */
+
+#include <stdlib.h>
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_basictypes.h"
+#include "EduOM_common.h"
+#include "RDsM.h" /* for the raw disk manager call */
+#include "Util.h" /* to get Pool */
+
+Four eduom_NextBulkLoad(BulkLoadInfo *, ObjectHdr *, Four, char *,
+                        ObjectID *);
+Four eduom_FinalBulkLoad(BulkLoadInfo *, Pool *, DeallocListElem *);
+Four eduom_FinishBulkLoadPage(BulkLoadInfo *);
+
+/*@================================
+ * EduOM_InitBulkLoad()
+ *================================*/
+/*
+ * Function: Four EduOM_InitBulkLoad(ObjectID*, Two, BulkLoadInfo*)
+ *
+ * Description :
+ *  Start a bulk load into the given data file. Each page allocated by the
+ *  load is filled until 'fillFactor' percent of its data area is used; the
+ *  remaining space is left for later updates and insertions.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter blkLdInfo
+ *     'blkLdInfo' is initialized to hold the state of the bulk load.
+ */
+Four EduOM_InitBulkLoad(
+    ObjectID *catObjForFile, /* IN file into which objects are loaded */
+    Two fillFactor,          /* IN % of each page to be filled (1 ~ 100) */
+    BulkLoadInfo *blkLdInfo) /* OUT state of the bulk load */
+{
+  Four e;                         /* error number */
+  PhysicalFileID pFid;            /* physical ID of file */
+  SlottedPage *catPage;           /* pointer to buffer containing the catalog */
+  sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (fillFactor < 1 || fillFactor > 100) ERR(eBADPARAMETER_OM);
+
+  if (blkLdInfo == NULL) ERR(eBADPARAMETER_OM);
+
+  // 1. Catalog object로부터 file 정보를 얻어 bulk load 상태에 저장함
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+  blkLdInfo->catObjForFile = *catObjForFile;
+  blkLdInfo->fid = catEntry->fid;
+  blkLdInfo->eff = catEntry->eff;
+  MAKE_PAGEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+  MAKE_PAGEID(blkLdInfo->pid, catEntry->fid.volNo, catEntry->lastPage);
+
+  e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  e = RDsM_PageIdToExtNo((PageID *)&pFid, &(blkLdInfo->firstExt));
+  if (e < eNOERROR) ERR(e);
+
+  // 2. 나머지 상태를 초기화함, 현재 채우고 있는 page는 아직 없음
+  blkLdInfo->fillLimit =
+      ((Four)(PAGESIZE - SP_FIXED + sizeof(SlottedPageSlot)) * fillFactor) /
+      100;
+  blkLdInfo->apage = NULL;
+  blkLdInfo->loadedPages = NULL;
+  blkLdInfo->nLoadedPages = 0;
+  blkLdInfo->maxLoadedPages = 0;
+  blkLdInfo->nAllocPages = 0;
+  blkLdInfo->nextAllocPage = 0;
+
+  return (eNOERROR);
+
+} /* EduOM_InitBulkLoad() */
+
+/*@================================
+ * EduOM_NextBulkLoad()
+ *================================*/
+/*
+ * Function: Four EduOM_NextBulkLoad(BulkLoadInfo*, ObjectHdr*, Four, char*,
+ * ObjectID*)
+ *
+ * Description :
+ *  Append a new object to the data file being bulk loaded. The object is put
+ *  into the current page if the page stays within the fill factor, otherwise
+ *  into a new page linked at the end of the file. New pages are taken from a
+ *  run of BULKLOAD_TRAINS pages allocated at once.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter oid
+ *     'oid' is set to the ObjectID of the newly created object.
+ */
+Four EduOM_NextBulkLoad(
+    BulkLoadInfo *blkLdInfo, /* INOUT state of the bulk load */
+    ObjectHdr *objHdr,       /* IN from which tag is to be set */
+    Four length,             /* IN amount of data */
+    char *data,              /* IN the initial data for the object */
+    ObjectID *oid)           /* OUT the object's ObjectID */
+{
+  Four e;                  /* error number */
+  struct timespec opStart; /* time when the operation starts */
+
+  /*@ parameter checking */
+  if (blkLdInfo == NULL) ERR(eBADPARAMETER_OM);
+
+  if (length < 0) ERR(eBADLENGTH_OM);
+
+  if (length > 0 && data == NULL) ERR(eBADUSERBUF_OM);
+
+  if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+  /* Error check whether using not supported functionality by EduOM */
+  if (ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
+
+  // File의 구성 page list를 변경하므로 file을 exclusive mode로 latch 함
+  eduom_StatsStartOp(&opStart);
+  e = eduom_LatchFile(&(blkLdInfo->catObjForFile), LATCH_EXCLUSIVE);
+  if (e >= eNOERROR) {
+    e = eduom_NextBulkLoad(blkLdInfo, objHdr, length, data, oid);
+    eduom_UnlatchFile(&(blkLdInfo->catObjForFile));
+  }
+
+  eduom_StatsEndOp(&(blkLdInfo->catObjForFile), STATS_OP_BULKLOAD, &opStart);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_NextBulkLoad() */
+
+/*@================================
+ * eduom_NextBulkLoad()
+ *================================*/
+/*
+ * Function: Four eduom_NextBulkLoad(BulkLoadInfo*, ObjectHdr*, Four, char*,
+ * ObjectID*)
+ *
+ * Description :
+ *  Append the object of EduOM_NextBulkLoad() whose parameters are already
+ *  checked. The caller holds the exclusive latch on the file.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUOM
+ *    some errors caused by function calls
+ */
+Four eduom_NextBulkLoad(
+    BulkLoadInfo *blkLdInfo, /* INOUT state of the bulk load */
+    ObjectHdr *objHdr,       /* IN from which tag is to be set */
+    Four length,             /* IN amount of data */
+    char *data,              /* IN the initial data for the object */
+    ObjectID *oid)           /* OUT the object's ObjectID */
+{
+  Four e;              /* error number */
+  Four neededSpace;    /* space needed to put new object */
+  Four usedSpace;      /* space already used in the current page */
+  ObjectHdr objectHdr; /* ObjectHdr with tag set from parameter */
+  PageID nearPid;      /* the new page is linked after this page */
+  ShortPageID *loadedPages; /* expanded array of the loaded pages */
+
+  objectHdr.properties = 0x0;
+  objectHdr.length = 0;
+  objectHdr.tag = (objHdr != NULL) ? objHdr->tag : 0;
+
+  neededSpace =
+      sizeof(ObjectHdr) + ALIGNED_LENGTH(length) + sizeof(SlottedPageSlot);
+
+  // 1. 현재 page가 fill factor를 넘지 않고 object를 담을 수 있는지 확인함
+  // 비어 있는 page에는 fill factor와 관계없이 object 한 개를 삽입함
+  if (blkLdInfo->apage != NULL) {
+    usedSpace = blkLdInfo->apage->header.free +
+                blkLdInfo->apage->header.nSlots * sizeof(SlottedPageSlot);
+
+    if (SP_CFREE(blkLdInfo->apage) < neededSpace ||
+        (blkLdInfo->apage->header.nSlots > 0 &&
+         usedSpace + neededSpace > blkLdInfo->fillLimit)) {
+      e = eduom_FinishBulkLoadPage(blkLdInfo);
+      if (e < eNOERROR) ERR(e);
+    }
+  }
+
+  // 2. 현재 page가 없는 경우, 미리 할당 받은 page들 중 하나를 file의 마지막
+  // page로 삽입함, 미리 할당 받은 page가 없으면 BULKLOAD_TRAINS 개의 page를
+  // 한 번에 할당 받음
+  // Link 한 page를 기록할 자리를 먼저 확보함
+  if (blkLdInfo->apage == NULL) {
+    if (blkLdInfo->nLoadedPages == blkLdInfo->maxLoadedPages) {
+      loadedPages = (ShortPageID *)realloc(
+          blkLdInfo->loadedPages,
+          (blkLdInfo->maxLoadedPages + BULKLOAD_TRAINS) * sizeof(ShortPageID));
+      if (loadedPages == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+      blkLdInfo->loadedPages = loadedPages;
+      blkLdInfo->maxLoadedPages += BULKLOAD_TRAINS;
+    }
+
+    nearPid = blkLdInfo->pid;
+
+    if (blkLdInfo->nextAllocPage == blkLdInfo->nAllocPages) {
+      e = RDsM_AllocTrains(blkLdInfo->fid.volNo, blkLdInfo->firstExt, &nearPid,
+                           blkLdInfo->eff, BULKLOAD_TRAINS, PAGESIZE2,
+                           blkLdInfo->allocPages);
+      if (e < eNOERROR) ERR(e);
+
+      blkLdInfo->nAllocPages = BULKLOAD_TRAINS;
+      blkLdInfo->nextAllocPage = 0;
+    }
+
+    blkLdInfo->pid = blkLdInfo->allocPages[blkLdInfo->nextAllocPage++];
+    e = eduom_LinkNewPage(&(blkLdInfo->catObjForFile), &(blkLdInfo->fid),
+                          &nearPid, &(blkLdInfo->pid), &(blkLdInfo->apage));
+    if (e < eNOERROR) {
+      blkLdInfo->apage = NULL;
+      ERR(e);
+    }
+
+    blkLdInfo->loadedPages[blkLdInfo->nLoadedPages++] = blkLdInfo->pid.pageNo;
+  }
+
+  // 3. 현재 page를 exclusive mode로 latch 하고 object를 삽입함
+  e = eduom_LatchPage(&(blkLdInfo->pid), LATCH_EXCLUSIVE);
+  if (e >= eNOERROR) {
+    e = eduom_InsertIntoPage(blkLdInfo->apage, &(blkLdInfo->pid), &objectHdr,
+                             length, data, oid);
+    eduom_UnlatchPage(&(blkLdInfo->pid));
+  }
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_NextBulkLoad() */
+
+/*@================================
+ * EduOM_FinalBulkLoad()
+ *================================*/
+/*
+ * Function: Four EduOM_FinalBulkLoad(BulkLoadInfo*, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  Finish the bulk load. Every page filled by the load is put into the proper
+ *  available space list, and the pages allocated but never used are inserted
+ *  into the dealloc list.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_FinalBulkLoad(
+    BulkLoadInfo *blkLdInfo, /* IN state of the bulk load */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead) /* INOUT head of dealloc list */
+{
+  Four e;  /* error number */
+  Four e2; /* error number of the cleanup */
+
+  /*@ parameter checking */
+  if (blkLdInfo == NULL) ERR(eBADPARAMETER_OM);
+
+  if (dlPool == NULL || dlHead == NULL) ERR(eBADPARAMETER_OM);
+
+  e = eduom_LatchFile(&(blkLdInfo->catObjForFile), LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_FinalBulkLoad(blkLdInfo, dlPool, dlHead);
+
+  eduom_UnlatchFile(&(blkLdInfo->catObjForFile));
+
+  // Cache 된 element들을 pool에 반환함
+  e2 = eduom_FlushElementPool(dlPool);
+  if (e >= eNOERROR) e = e2;
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_FinalBulkLoad() */
+
+/*@================================
+ * eduom_FinalBulkLoad()
+ *================================*/
+/*
+ * Function: Four eduom_FinalBulkLoad(BulkLoadInfo*, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  Finish the bulk load of EduOM_FinalBulkLoad() whose parameters are
+ *  already checked. The caller holds the exclusive latch on the file.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FinalBulkLoad(
+    BulkLoadInfo *blkLdInfo, /* IN state of the bulk load */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead) /* INOUT head of dealloc list */
+{
+  Four e;                         /* error number */
+  ObjectID *catObjForFile;        /* catalog object of the file */
+  Four e2;                        /* error number of the cleanup */
+  Four i;                         /* index */
+  PageID pid;                     /* page to be put into the avail space list */
+  SlottedPage *apage;             /* pointer to the buffer holding the page */
+  SlottedPage *catPage;           /* pointer to buffer containing the catalog */
+  sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+  DeallocListElem *dlElem;        /* pointer to element of dealloc list */
+
+  // 1. 현재 채우고 있는 page를 unfix 함
+  if (blkLdInfo->apage != NULL) {
+    e = eduom_FinishBulkLoadPage(blkLdInfo);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  // 2. Bulk load가 link 한 page들을 각각 알맞은 available space list에
+  // 삽입하고 free space map을 갱신함
+  // Load 도중 CreateObject() 나 DestroyObject() 가 이미 list에 삽입한 page는
+  // list에서 삭제한 후 다시 삽입하고, object가 모두 삭제되어 file에서 삭제된
+  // page는 건너뜀
+  catObjForFile = &(blkLdInfo->catObjForFile);
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+  for (i = 0; i < blkLdInfo->nLoadedPages && e >= eNOERROR; i++) {
+    MAKE_PAGEID(pid, blkLdInfo->fid.volNo, blkLdInfo->loadedPages[i]);
+
+    e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+    if (e < eNOERROR) break;
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e >= eNOERROR) {
+      if (apage->header.nSlots > 0) {
+        e = eduom_RemoveFromAvailSpaceList(catObjForFile, catEntry, &pid,
+                                           apage);
+        if (e >= eNOERROR)
+          e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+        if (e >= eNOERROR)
+          e = eduom_FsmSetFreeSpace(&blkLdInfo->fid, pid.pageNo,
+                                    SP_FREE(apage));
+      }
+
+      e2 = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+      if (e >= eNOERROR) e = e2;
+    }
+
+    eduom_UnlatchPage(&pid);
+  }
+
+  e2 = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  if (e < eNOERROR) ERR(e);
+
+  // 3. 할당 받았지만 사용하지 않은 page들을 dealloc list에 삽입함
+  while (blkLdInfo->nextAllocPage < blkLdInfo->nAllocPages) {
+    e = eduom_GetElementFromPool(dlPool, &dlElem);
+    if (e < eNOERROR) ERR(e);
+
+    dlElem->type = DL_PAGE;
+    dlElem->elem.pid = blkLdInfo->allocPages[blkLdInfo->nextAllocPage++];
+    dlElem->next = dlHead->next;
+    dlHead->next = dlElem;
+  }
+
+  free(blkLdInfo->loadedPages);
+  blkLdInfo->loadedPages = NULL;
+  blkLdInfo->nLoadedPages = 0;
+  blkLdInfo->maxLoadedPages = 0;
+
+  return (eNOERROR);
+
+} /* eduom_FinalBulkLoad() */
+
+/*@================================
+ * eduom_FinishBulkLoadPage()
+ *================================*/
+/*
+ * Function: Four eduom_FinishBulkLoadPage(BulkLoadInfo*)
+ *
+ * Description :
+ *  Mark the page currently being filled as dirty and free it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FinishBulkLoadPage(
+    BulkLoadInfo *blkLdInfo) /* INOUT state of the bulk load */
+{
+  Four e; /* error number */
+
+  e = BfM_SetDirty((TrainID *)&(blkLdInfo->pid), PAGE_BUF);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)&(blkLdInfo->pid), PAGE_BUF);
+
+  e = BfM_FreeTrain((TrainID *)&(blkLdInfo->pid), PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  blkLdInfo->apage = NULL;
+
+  return (eNOERROR);
+
+} /* eduom_FinishBulkLoadPage() */
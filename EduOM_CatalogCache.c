@@ -0,0 +1,169 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_CatalogCache.c
+ *
+ * Description :
+ *  Cache of the catalog information of the data files. The scans read the
+ *  first and the last page of a file from the cached descriptor instead of
+ *  fixing the page of the catalog object on every call. A descriptor is
+ *  invalidated when EduOM changes the list of pages of its file, and is
+ *  read again from the catalog object on the next use.
+ *
+ * Exports:
+ *  Four eduom_GetCatalogDesc(ObjectID*, eduom_CatalogDesc**)
+ *  void eduom_InvalidateCatalogDesc(ObjectID*)
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+/* table of the cached catalog descriptors */
+static eduom_CatalogDesc *catalogDescTable = NULL;
+
+/* protects the descriptor table */
+static pthread_mutex_t catalogDescMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*@================================
+ * eduom_GetCatalogDesc()
+ *================================*/
+/*
+ * Function: Four eduom_GetCatalogDesc(ObjectID*, eduom_CatalogDesc*)
+ *
+ * Description :
+ *  Find the cached descriptor of the data file whose catalog object is
+ *  given. If there is no valid descriptor, the catalog object is read and
+ *  the descriptor is filled. A copy of the descriptor is returned since
+ *  the entry may be refilled by another thread.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eMEMORYALLOCERR_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter desc
+ *     'desc' is set to the descriptor of the file
+ */
+Four eduom_GetCatalogDesc(
+    ObjectID *catObjForFile, /* IN catalog object of the file */
+    eduom_CatalogDesc *desc) /* OUT descriptor of the file */
+{
+  Four e;                         /* error number */
+  eduom_CatalogDesc *entry;       /* entry of the descriptor table */
+  SlottedPage *catPage;           /* buffer page containing the catalog */
+  sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  pthread_mutex_lock(&catalogDescMutex);
+
+  // 1. Descriptor table에서 file의 descriptor를 탐색함
+  for (entry = catalogDescTable; entry != NULL; entry = entry->next) {
+    if (EQUAL_OBJECTID(entry->catObjForFile, *catObjForFile)) break;
+  }
+
+  if (entry != NULL && entry->valid) {
+    *desc = *entry;
+    pthread_mutex_unlock(&catalogDescMutex);
+    return (eNOERROR);
+  }
+
+  // 2. Descriptor가 없는 경우 새로운 descriptor를 만들어 table에 삽입함
+  if (entry == NULL) {
+    entry = (eduom_CatalogDesc *)malloc(sizeof(eduom_CatalogDesc));
+    if (entry == NULL) {
+      pthread_mutex_unlock(&catalogDescMutex);
+      ERR(eMEMORYALLOCERR_EDUOM);
+    }
+
+    memset(entry, 0, sizeof(eduom_CatalogDesc));
+    entry->catObjForFile = *catObjForFile;
+    entry->valid = FALSE;
+
+    entry->next = catalogDescTable;
+    catalogDescTable = entry;
+  }
+
+  // 3. Catalog object를 읽어 descriptor를 채움
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) {
+    pthread_mutex_unlock(&catalogDescMutex);
+    ERR(e);
+  }
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+  entry->fid = catEntry->fid;
+  entry->eff = catEntry->eff;
+  entry->firstPage = catEntry->firstPage;
+  entry->lastPage = catEntry->lastPage;
+  entry->valid = TRUE;
+
+  *desc = *entry;
+
+  e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  pthread_mutex_unlock(&catalogDescMutex);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_GetCatalogDesc() */
+
+/*@================================
+ * eduom_InvalidateCatalogDesc()
+ *================================*/
+/*
+ * Function: void eduom_InvalidateCatalogDesc(ObjectID*)
+ *
+ * Description :
+ *  Invalidate the cached descriptor of the data file whose catalog object
+ *  is given. Called whenever the catalog information of the file changes.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_InvalidateCatalogDesc(
+    ObjectID *catObjForFile) /* IN catalog object of the file */
+{
+  eduom_CatalogDesc *entry; /* entry of the descriptor table */
+
+  pthread_mutex_lock(&catalogDescMutex);
+
+  for (entry = catalogDescTable; entry != NULL; entry = entry->next) {
+    if (EQUAL_OBJECTID(entry->catObjForFile, *catObjForFile)) {
+      entry->valid = FALSE;
+      break;
+    }
+  }
+
+  pthread_mutex_unlock(&catalogDescMutex);
+
+} /* eduom_InvalidateCatalogDesc() */
@@ -0,0 +1,171 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_Cluster.c
+ *
+ * Description :
+ *  Clustered insertion. When the page of the near object has no room, the
+ *  pages around it in the list of pages of the file are searched before a new
+ *  page is allocated, so that the objects created near each other stay in
+ *  the same extent and are read together.
+ *
+ * Exports:
+ *  Four EduOM_SetClusterRadius(Four)
+ *  Four eduom_GetClusterPage(FileID*, PageID*, SlottedPage*, Four, PageID*,
+ * SlottedPage**)
+ */
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+#include "RDsM.h" /* for the raw disk manager call */
+
+/* max # of pages searched on each side of the near page */
+#define CLUSTER_MAX_RADIUS PREALLOC_MAX_PAGES
+
+/* # of pages searched on each side of the near page, 0 if disabled */
+static Four clusterRadius = 0;
+
+/*@================================
+ * EduOM_SetClusterRadius()
+ *================================*/
+/*
+ * Function: Four EduOM_SetClusterRadius(Four)
+ *
+ * Description :
+ *  Set the number of pages searched on each side of the near page when the
+ *  near page has no room for a new object. 0 disables the clustered
+ *  insertion, which is the default; a new page is then allocated right after
+ *  the near page.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_SetClusterRadius(Four radius) /* IN # of pages on each side */
+{
+  if (radius < 0 || radius > CLUSTER_MAX_RADIUS) ERR(eBADPARAMETER_OM);
+
+  clusterRadius = radius;
+
+  return (eNOERROR);
+
+} /* EduOM_SetClusterRadius() */
+
+/*@================================
+ * eduom_GetClusterPage()
+ *================================*/
+/*
+ * Function: Four eduom_GetClusterPage(FileID*, PageID*, SlottedPage*, Four,
+ * PageID*, SlottedPage**)
+ *
+ * Description :
+ *  Find a page having 'neededSpace' bytes of room among the pages around the
+ *  near page. The next and the previous pages in the list of pages of the
+ *  file are checked alternately, nearest first, up to the cluster radius on
+ *  each side; a side is not searched any more once it leaves the extent of
+ *  the near page. The insertion pages of the other threads are skipped,
+ *  since a partitioned file keeps them out of the available space lists.
+ *  The caller holds the latch on the file, so the list is not changed
+ *  during the search.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter pid
+ *     'pid' is set to the found page, pid->pageNo is NIL if none is found
+ *  2) parameter apage
+ *     'apage' is set to the buffer of the found page, which is fixed
+ */
+Four eduom_GetClusterPage(
+    FileID *fid,           /* IN ID of the file */
+    PageID *nearPid,       /* IN page of the near object */
+    SlottedPage *nearPage, /* IN buffer of the near page */
+    Four neededSpace,      /* IN space needed for the new object */
+    PageID *pid,           /* OUT found page */
+    SlottedPage **apage)   /* OUT buffer of the found page */
+{
+  Four e;                /* error number */
+  Four i;                /* distance from the near page */
+  Four dir;              /* 0: next pages, 1: previous pages */
+  Four nearExt;          /* extent of the near page */
+  Four ext;              /* extent of the candidate page */
+  Four owner;            /* partition owning the candidate page */
+  ShortPageID cursor[2]; /* next candidate page on each side */
+
+  pid->volNo = nearPid->volNo;
+  pid->pageNo = NIL;
+
+  if (clusterRadius == 0) return (eNOERROR);
+
+  e = RDsM_PageIdToExtNo(nearPid, &nearExt);
+  if (e < eNOERROR) ERR(e);
+
+  cursor[0] = nearPage->header.nextPage;
+  cursor[1] = nearPage->header.prevPage;
+
+  // 1. Near page에서 가까운 page부터 다음 page와 이전 page를 번갈아 검사함
+  for (i = 0; i < clusterRadius; i++) {
+    for (dir = 0; dir < 2; dir++) {
+      if (cursor[dir] == NIL) continue;
+
+      // 2. Near page와 다른 extent의 page에 도달한 경우, 해당 방향의 검색을
+      // 중단함
+      pid->pageNo = cursor[dir];
+      e = RDsM_PageIdToExtNo(pid, &ext);
+      if (e < eNOERROR) ERR(e);
+
+      if (ext != nearExt) {
+        cursor[dir] = NIL;
+        continue;
+      }
+
+      e = eduom_GetPartitionOwner(fid, pid->pageNo, &owner);
+      if (e < eNOERROR) ERR(e);
+
+      e = BfM_GetTrain((TrainID *)pid, (char **)apage, PAGE_BUF);
+      if (e < eNOERROR) ERR(e);
+
+      // 3. 다른 thread의 삽입 page가 아니고 여유 공간이 있는 page를 찾은
+      // 경우, fix 된 상태로 반환함
+      if ((owner == NIL || owner == eduom_GetPartitionNo()) &&
+          eduom_HasRoomInPage(pid, *apage, neededSpace))
+        return (eNOERROR);
+
+      cursor[dir] = (dir == 0) ? (*apage)->header.nextPage
+                               : (*apage)->header.prevPage;
+
+      e = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+      if (e < eNOERROR) ERR(e);
+    }
+  }
+
+  pid->pageNo = NIL;
+
+  return (eNOERROR);
+
+} /* eduom_GetClusterPage() */
@@ -32,14 +32,33 @@
  *
  * Exports:
  *  Four EduOM_CompactPage(SlottedPage*, Two)
+ *
+ * Internal Functions:
+ *  int eduom_CompareSlotOffset(const void*, const void*)
+ *  void eduom_ReverseBytes(char*, Four)
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "EduOM_Internal.h"
 #include "EduOM_common.h"
 #include "LOT.h"
 
+/*
+ * Typedef for an entry of the offset-sorted permutation of the slots
+ */
+typedef struct {
+  Two offset; /* offset of the object in the data area */
+  Two slotNo; /* slot of the object */
+} SlotOffsetEntry;
+
+/* maximum # of slots in a page */
+#define MAX_SLOTS_IN_PAGE (PAGESIZE / sizeof(SlottedPageSlot))
+
+int eduom_CompareSlotOffset(const void *, const void *);
+void eduom_ReverseBytes(char *, Four);
+
 /*@================================
  * EduOM_CompactPage()
  *================================*/
@@ -57,19 +76,30 @@
  *  the beginning of the page.
  *
  *  (2) How to do?
- *  a. Save the given page into the temporary page
- *  b. FOR each nonempty slot DO
- *	Fill the original page by copying the object from the saved page
- *          to the data area of original page pointed by 'apageDataOffset'
- *	Update the slot offset
- *	Get 'apageDataOffet' to point the next moved position
+ *  a. IF the page holds pinned objects THEN
+ *	Return eOBJECTPINNED_EDUOM without moving any object
+ *     ENDIF
+ *  b. Sort the nonempty slots by the object offset
+ *     FOR each nonempty slot in the order of the object offset DO
+ *	IF there is a hole before the object THEN
+ *	    Move the object toward the beginning of the data area
+ *	    Update the slot offset
+ *	ENDIF
  *     ENDFOR
- *   c. Update the 'freeStart' and 'unused' field of the page
- *   d. Return
+ *     Objects located before the first hole are never moved.
+ *  c. IF 'slotNo' is given and its object is not the last one THEN
+ *	Rotate the data area from the object to the end of the objects in
+ *	place so that the object goes to the end
+ *	Update the slot offsets of the objects after it
+ *     ENDIF
+ *  d. Update the 'freeStart' and 'unused' field of the page
+ *  e. Count the compaction and the bytes moved in the statistics
+ *  f. Return
  *
  * Returns:
  *  error code
  *    eNOERROR
+ *    eOBJECTPINNED_EDUOM
  *
  * Side Effects :
  *  The slotted page is reorganized to comact the space.
@@ -77,63 +107,146 @@
 Four EduOM_CompactPage(SlottedPage *apage, /* IN slotted page to compact */
                        Two slotNo)         /* IN slotNo to go to the end */
 {
-  SlottedPage tpage;   /* temporay page used to save the given page */
   Object *obj;         /* pointer to the object in the data area */
   Two apageDataOffset; /* where the next object is to be moved */
-  Four len;            /* length of object + length of ObjectHdr */
+  Four len;            /* length of object + length of ObjectHdr in page */
   Two lastSlot;        /* last non empty slot */
   Two i;               /* index variable */
+  SlotOffsetEntry order[MAX_SLOTS_IN_PAGE]; /* slots sorted by offset */
+  Two nObjects;        /* # of objects in the page */
+  Two slotIdx;         /* index of the object of 'slotNo' in 'order' */
+  Two slotOffset;      /* offset of the object of 'slotNo' after moving */
+  Four slotLen;        /* length of the object of 'slotNo' */
+  Four restLen;        /* length of the objects after the object of 'slotNo' */
+  Four moved;          /* # of bytes moved */
+  EduOM_Stats *stats;  /* statistics of the current thread */
+
+  // Pin 된 object가 있는 page는 object를 이동할 수 없으므로 compact 하지
+  // 않음, 호출자가 page의 exclusive latch를 가지므로 확인 후 pin 될 수 없음
+  if (eduom_IsPinnedPage(&apage->header.pid)) ERR(eOBJECTPINNED_EDUOM);
 
   // Page의 데이터 영역의 모든 자유 공간이 연속된 하나의 contiguous free
   // area를 형성하도록 object들의 offset를 조정함
   lastSlot = apage->header.nSlots - 1;
 
-  if (slotNo != NIL) {
-    // 1. 파라미터로 주어진 slotNo가 NIL(-1)이 아닌 경우
-    // slotNo에 대응하는 object를 제외한 page의 모든 object들을 데이터 영역의
-    // 가장 앞부분부터 연속되게 저장함
-    // slotNo에 대응하는 object를 데이터 영역 상에서의 마지막 object로 저장함
-    char temp[100];
-
-    apageDataOffset = 0;
-    for (i = 0; i <= lastSlot; ++i) {
-      obj = &(apage->data[apage->slot[-i].offset]);
-      len = sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length);
-
-      if (apage->slot[-i].offset == EMPTYSLOT) {
-        continue;
-      }
-
-      if (i == slotNo) {
-        memcpy(temp, (char *)obj, len);
-      } else {
-        memcpy(&(apage->data[apageDataOffset]), (char *)obj, len);
-        (apage->slot[-i]).offset = apageDataOffset;
-        apageDataOffset += len;
-      }
+  if (slotNo != NIL &&
+      (slotNo > lastSlot || apage->slot[-slotNo].offset == EMPTYSLOT)) {
+    slotNo = NIL;
+  }
+
+  // 1. 비어있지 않은 slot들을 object의 offset 순서대로 정렬함
+  nObjects = 0;
+  for (i = 0; i <= lastSlot; ++i) {
+    if (apage->slot[-i].offset == EMPTYSLOT) {
+      continue;
     }
-    memcpy(&(apage->data[apageDataOffset]), temp, len);
-    (apage->slot[slotNo]).offset = apageDataOffset;
+
+    order[nObjects].offset = apage->slot[-i].offset;
+    order[nObjects].slotNo = i;
+    nObjects++;
+  }
+  qsort(order, nObjects, sizeof(SlotOffsetEntry), eduom_CompareSlotOffset);
+
+  // 2. 정렬된 순서대로 object들을 데이터 영역의 가장 앞부분부터 연속되게
+  // 저장함, 첫 번째 hole 이전의 object들은 이동하지 않음
+  apageDataOffset = 0;
+  moved = 0;
+  slotIdx = NIL;
+  slotOffset = 0;
+  slotLen = 0;
+
+  for (i = 0; i < nObjects; ++i) {
+    obj = (Object *)&(apage->data[order[i].offset]);
+    len = LENGTH_WITH_HDR(obj);
+
+    if (order[i].offset != apageDataOffset) {
+      memmove(&(apage->data[apageDataOffset]), (char *)obj, len);
+      apage->slot[-order[i].slotNo].offset = apageDataOffset;
+      moved += len;
+    }
+
+    if (order[i].slotNo == slotNo) {
+      slotIdx = i;
+      slotOffset = apageDataOffset;
+      slotLen = len;
+    }
+
     apageDataOffset += len;
+  }
+
+  // 3. 파라미터로 주어진 slotNo가 NIL(-1)이 아닌 경우, slotNo에 대응하는
+  // object를 데이터 영역 상에서의 마지막 object로 저장함
+  // 해당 object와 그 뒤의 object들로 이루어진 영역을 제자리에서 회전시킴
+  restLen = apageDataOffset - slotOffset - slotLen;
+  if (slotIdx != NIL && restLen > 0) {
+    eduom_ReverseBytes(&(apage->data[slotOffset]), slotLen);
+    eduom_ReverseBytes(&(apage->data[slotOffset + slotLen]), restLen);
+    eduom_ReverseBytes(&(apage->data[slotOffset]), slotLen + restLen);
 
-  } else {
-    // 2. 파라미터로 주어진 slotNo가 NIL (-1) 인 경우
-    // Page의 모든 object들을 데이터 영역의 가장 앞부분부터 연속되게 저장함
-    apageDataOffset = 0;
-    for (i = 0; i <= lastSlot; ++i) {
-      obj = &(apage->data[apage->slot[-i].offset]);
-      len = sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length);
-
-      memcpy(&(apage->data[apageDataOffset]), (char *)obj, len);
-      (apage->slot[-i]).offset = apageDataOffset;
-      apageDataOffset += len;
+    for (i = slotIdx + 1; i < nObjects; ++i) {
+      apage->slot[-order[i].slotNo].offset -= slotLen;
     }
+    apage->slot[-slotNo].offset = slotOffset + restLen;
+    moved += slotLen + restLen;
   }
 
-  // 3. Page header를 갱신함
+  // 4. Page header를 갱신함
   apage->header.free = apageDataOffset;
   apage->header.unused = 0;
 
+  // 5. Compaction 횟수 및 이동한 byte 수를 통계에 기록함
+  stats = eduom_GetThreadStats(NULL);
+  if (stats != NULL) {
+    stats->compactions++;
+    stats->bytesMoved += moved;
+  }
+
   return (eNOERROR);
 
 } /* EduOM_CompactPage */
+
+/*@================================
+ * eduom_CompareSlotOffset()
+ *================================*/
+/*
+ * Function: int eduom_CompareSlotOffset(const void*, const void*)
+ *
+ * Description :
+ *  Compare two entries of the permutation of the slots by the object offset.
+ *
+ * Returns:
+ *  negative, zero or positive as the first offset is smaller, equal or larger
+ */
+int eduom_CompareSlotOffset(const void *a, /* IN first entry */
+                            const void *b) /* IN second entry */
+{
+  return ((SlotOffsetEntry *)a)->offset - ((SlotOffsetEntry *)b)->offset;
+
+} /* eduom_CompareSlotOffset() */
+
+/*@================================
+ * eduom_ReverseBytes()
+ *================================*/
+/*
+ * Function: void eduom_ReverseBytes(char*, Four)
+ *
+ * Description :
+ *  Reverse the order of the bytes of the given area in place.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_ReverseBytes(char *area, /* INOUT area to be reversed */
+                        Four len)   /* IN length of the area */
+{
+  char *lo;  /* first byte not yet swapped */
+  char *hi;  /* last byte not yet swapped */
+  char byte; /* temporary byte */
+
+  for (lo = area, hi = area + len - 1; lo < hi; lo++, hi--) {
+    byte = *lo;
+    *lo = *hi;
+    *hi = byte;
+  }
+
+} /* eduom_ReverseBytes() */
@@ -0,0 +1,359 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_Compactor.c
+ *
+ * Description :
+ *  Deferred page compaction. When an object is destroyed and the unused bytes
+ *  of its page exceed the compaction threshold, the page is queued as a
+ *  candidate. The queued pages are compacted off the insert path, so that the
+ *  insertion finds a contiguous free area and does not pay for the
+ *  compaction: either by the compaction worker thread, which
+ *  EduOM_StartCompactor() starts and which compacts the pages as soon as
+ *  they are queued, or by EduOM_CompactPendingPages(), which the application
+ *  calls itself (e.g. when it is idle).
+ *
+ *  The worker compacts the pages without a transaction, so it must be
+ *  stopped by EduOM_StopCompactor() before the volume is dismounted.
+ *
+ * Exports:
+ *  Four EduOM_SetCompactThreshold(Four)
+ *  Four EduOM_CompactPendingPages(Four, Four*)
+ *  Four EduOM_StartCompactor(void)
+ *  Four EduOM_StopCompactor(void)
+ *  Four eduom_AddCompactCandidate(PageID*, SlottedPage*)
+ *
+ * Internal Functions:
+ *  void *eduom_Compactor(void*)
+ */
+
+#include <pthread.h>
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+/* # of candidate pages which can be queued */
+#define COMPACT_QUEUE_SIZE 256
+
+/* max # of pages compacted by the worker before checking for the stop */
+#define COMPACT_WORKER_BATCH 16
+
+void *eduom_Compactor(void *);
+
+/* unused bytes of a page from which the page is queued, NIL if disabled */
+static Four compactThreshold = NIL;
+
+/* circular queue of the candidate pages */
+static PageID compactQueue[COMPACT_QUEUE_SIZE];
+static Four compactQueueHead = 0;
+static Four nCompactCandidates = 0;
+
+/* protects the queue and the state of the worker */
+static pthread_mutex_t compactMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t compactCond = PTHREAD_COND_INITIALIZER; /* page queued */
+
+static pthread_t compactor;             /* the compaction worker */
+static Boolean compactorRunning = FALSE; /* is the worker started? */
+static Boolean compactorStopping = FALSE; /* is the worker asked to stop? */
+
+/*@================================
+ * EduOM_SetCompactThreshold()
+ *================================*/
+/*
+ * Function: Four EduOM_SetCompactThreshold(Four)
+ *
+ * Description :
+ *  Set the number of unused bytes of a page from which the page is queued for
+ *  the deferred compaction. NIL disables the deferred compaction, which is
+ *  the default; the pages already queued remain queued.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_SetCompactThreshold(Four threshold) /* IN threshold in bytes */
+{
+  if (threshold != NIL && (threshold < 0 || threshold >= PAGESIZE))
+    ERR(eBADPARAMETER_OM);
+
+  compactThreshold = threshold;
+
+  return (eNOERROR);
+
+} /* EduOM_SetCompactThreshold() */
+
+/*@================================
+ * EduOM_CompactPendingPages()
+ *================================*/
+/*
+ * Function: Four EduOM_CompactPendingPages(Four, Four*)
+ *
+ * Description :
+ *  Compact at most 'maxPages' pages of the candidate queue. Each page is fixed
+ *  and latched in exclusive mode only while it is compacted. The pages which
+ *  have no unused bytes any more, no longer are slotted pages, or hold pinned
+ *  objects are dropped from the queue without compaction.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter nCompacted
+ *     'nCompacted' is set to the number of the compacted pages if not NULL
+ */
+Four EduOM_CompactPendingPages(Four maxPages,    /* IN max # of pages */
+                               Four *nCompacted) /* OUT # of compacted pages */
+{
+  Four e;             /* error number */
+  Four n;             /* # of compacted pages */
+  PageID pid;         /* candidate page */
+  SlottedPage *apage; /* pointer to the buffer of the page */
+  Boolean compacted;  /* is the page compacted? */
+
+  /*@ parameter checking */
+  if (maxPages < 0) ERR(eBADPARAMETER_OM);
+
+  n = 0;
+  while (n < maxPages) {
+    // 1. Queue에서 첫 번째 candidate page를 꺼냄
+    pthread_mutex_lock(&compactMutex);
+    if (nCompactCandidates == 0) {
+      pthread_mutex_unlock(&compactMutex);
+      break;
+    }
+    pid = compactQueue[compactQueueHead];
+    compactQueueHead = (compactQueueHead + 1) % COMPACT_QUEUE_SIZE;
+    nCompactCandidates--;
+    pthread_mutex_unlock(&compactMutex);
+
+    e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) {
+      eduom_UnlatchPage(&pid);
+      ERR(e);
+    }
+
+    // 2. Page가 여전히 slotted page이고 unused 영역이 있는 경우 compact 함
+    // Pin 된 object가 있는 page는 compact 되지 않으므로 건너뜀
+    compacted = FALSE;
+    if ((apage->header.flags & PAGE_TYPE_VECTOR_MASK) == SLOTTED_PAGE_TYPE &&
+        EQUAL_PAGEID(apage->header.pid, pid) && apage->header.unused > 0) {
+      e = EduOM_CompactPage(apage, NIL);
+      if (e < eNOERROR && e != eOBJECTPINNED_EDUOM) {
+        eduom_UnlatchPage(&pid);
+        ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+      }
+      compacted = (e == eNOERROR) ? TRUE : FALSE;
+    }
+
+    if (compacted) {
+      e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+      if (e < eNOERROR) {
+        eduom_UnlatchPage(&pid);
+        ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+      }
+      n++;
+    }
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    eduom_UnlatchPage(&pid);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  if (nCompacted != NULL) *nCompacted = n;
+
+  return (eNOERROR);
+
+} /* EduOM_CompactPendingPages() */
+
+/*@================================
+ * EduOM_StartCompactor()
+ *================================*/
+/*
+ * Function: Four EduOM_StartCompactor(void)
+ *
+ * Description :
+ *  Start the compaction worker thread, which compacts the candidate pages
+ *  as soon as they are queued. The pages are queued only while the
+ *  compaction threshold is set by EduOM_SetCompactThreshold().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eMEMORYALLOCERR_EDUOM
+ */
+Four EduOM_StartCompactor(void)
+{
+  pthread_mutex_lock(&compactMutex);
+
+  if (compactorRunning) {
+    pthread_mutex_unlock(&compactMutex);
+    ERR(eBADPARAMETER_OM);
+  }
+
+  compactorStopping = FALSE;
+  if (pthread_create(&compactor, NULL, eduom_Compactor, NULL) != 0) {
+    pthread_mutex_unlock(&compactMutex);
+    ERR(eMEMORYALLOCERR_EDUOM);
+  }
+  compactorRunning = TRUE;
+
+  pthread_mutex_unlock(&compactMutex);
+
+  return (eNOERROR);
+
+} /* EduOM_StartCompactor() */
+
+/*@================================
+ * EduOM_StopCompactor()
+ *================================*/
+/*
+ * Function: Four EduOM_StopCompactor(void)
+ *
+ * Description :
+ *  Stop the compaction worker thread and wait until it exits. The pages
+ *  still queued remain queued.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_StopCompactor(void)
+{
+  pthread_mutex_lock(&compactMutex);
+
+  if (!compactorRunning) {
+    pthread_mutex_unlock(&compactMutex);
+    ERR(eBADPARAMETER_OM);
+  }
+
+  compactorStopping = TRUE;
+  pthread_cond_signal(&compactCond);
+
+  pthread_mutex_unlock(&compactMutex);
+
+  pthread_join(compactor, NULL);
+
+  pthread_mutex_lock(&compactMutex);
+  compactorRunning = FALSE;
+  pthread_mutex_unlock(&compactMutex);
+
+  return (eNOERROR);
+
+} /* EduOM_StopCompactor() */
+
+/*@================================
+ * eduom_AddCompactCandidate()
+ *================================*/
+/*
+ * Function: Four eduom_AddCompactCandidate(PageID*, SlottedPage*)
+ *
+ * Description :
+ *  Queue the page for the deferred compaction if the deferred compaction is
+ *  enabled and the unused bytes of the page exceed the threshold. A page
+ *  already queued is not queued twice; if the queue is full, the page is
+ *  not queued and is compacted by the insertion as before.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four eduom_AddCompactCandidate(PageID *pid,        /* IN page to be queued */
+                               SlottedPage *apage) /* IN buffer of the page */
+{
+  Four i; /* index variable */
+
+  if (compactThreshold == NIL || apage->header.unused <= compactThreshold)
+    return (eNOERROR);
+
+  pthread_mutex_lock(&compactMutex);
+
+  if (nCompactCandidates == COMPACT_QUEUE_SIZE) {
+    pthread_mutex_unlock(&compactMutex);
+    return (eNOERROR);
+  }
+
+  for (i = 0; i < nCompactCandidates; i++) {
+    if (EQUAL_PAGEID(compactQueue[(compactQueueHead + i) % COMPACT_QUEUE_SIZE],
+                     *pid)) {
+      pthread_mutex_unlock(&compactMutex);
+      return (eNOERROR);
+    }
+  }
+
+  compactQueue[(compactQueueHead + nCompactCandidates) % COMPACT_QUEUE_SIZE] =
+      *pid;
+  nCompactCandidates++;
+
+  pthread_cond_signal(&compactCond);
+
+  pthread_mutex_unlock(&compactMutex);
+
+  return (eNOERROR);
+
+} /* eduom_AddCompactCandidate() */
+
+/*@================================
+ * eduom_Compactor()
+ *================================*/
+/*
+ * Function: void *eduom_Compactor(void*)
+ *
+ * Description :
+ *  Body of the compaction worker thread. Compact the queued pages a batch
+ *  at a time, waiting when none is queued, until the worker is asked to
+ *  stop. A page which cannot be compacted because of an error is dropped
+ *  from the queue.
+ *
+ * Returns:
+ *  None
+ */
+void *eduom_Compactor(void *arg) /* IN not used */
+{
+  (void)arg;
+
+  pthread_mutex_lock(&compactMutex);
+
+  for (;;) {
+    while (nCompactCandidates == 0 && !compactorStopping)
+      pthread_cond_wait(&compactCond, &compactMutex);
+
+    if (compactorStopping) break;
+
+    pthread_mutex_unlock(&compactMutex);
+    (void)EduOM_CompactPendingPages(COMPACT_WORKER_BATCH, NULL);
+    pthread_mutex_lock(&compactMutex);
+  }
+
+  pthread_mutex_unlock(&compactMutex);
+
+  return (NULL);
+
+} /* eduom_Compactor() */
@@ -31,6 +31,24 @@
  * Exports:
  *  Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*,
  * ObjectID*)
+ *
+ * Internal Functions:
+ *  Four eduom_TryCreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*,
+ * ObjectID*, Boolean*)
+ *  Four eduom_SelectPage(ObjectID*, sm_CatOverlayForData*, ObjectID*, Four,
+ * Boolean, Two*, PageID*, PageID*, SlottedPage**, Four*)
+ *  Four eduom_ReturnInsertPage(ObjectID*, sm_CatOverlayForData*, Two, Boolean,
+ * PageID*, SlottedPage*)
+ *  Four eduom_AllocNewPage(ObjectID*, sm_CatOverlayForData*, Four, PageID*,
+ * PageID*, SlottedPage**)
+ *  Four eduom_LinkNewPage(ObjectID*, FileID*, PageID*, PageID*, SlottedPage**)
+ *  Four eduom_InsertIntoPage(SlottedPage*, PageID*, ObjectHdr*, Four, char*,
+ * ObjectID*)
+ *  Four eduom_GetUnique(PageID*, SlottedPage*, Unique*)
+ *  Four eduom_GetAvailSpaceListPage(sm_CatOverlayForData*, Four, PageID*,
+ * SlottedPage**)
+ *  Four eduom_RemoveFromAvailSpaceList(ObjectID*, sm_CatOverlayForData*,
+ * PageID*, SlottedPage*)
  */
 
 #include <string.h>
@@ -57,6 +75,8 @@
  * If there is no room in the page holding the specified object,
  * it trys to insert into the page in the available space list. If fail, then
  * the new object will be put into the newly allocated page.
+ * An object larger than LRGOBJ_THRESHOLD is created empty and its data is
+ * appended by OM_AppendToObject(), which stores it as a large object tree.
  *
  * (2) How to do?
  *	a. Read in the near slotted page
@@ -95,6 +115,9 @@ Four EduOM_CreateObject(
 {
   Four e;              /* error number */
   ObjectHdr objectHdr; /* ObjectHdr with tag set from parameter */
+  PageID pid;          /* page holding the new object */
+  Boolean done;        /* is the object created in an existing page? */
+  struct timespec opStart; /* time when the operation starts */
 
   /*@ parameter checking */
 
@@ -104,9 +127,6 @@ Four EduOM_CreateObject(
 
   if (length > 0 && data == NULL) return (eBADUSERBUF_OM);
 
-  /* Error check whether using not supported functionality by EduOM */
-  if (ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
-
   // File을 구성하는 page들 중 파라미터로 지정한 object와 같은 (또는
   // 인접한) page에 새로운 object를 삽입하고, 삽입된 object의 ID를 반환함
 
@@ -118,9 +138,62 @@ Four EduOM_CreateObject(
   else
     objectHdr.tag = 0;
 
-  // 2. eduom_CreateObject()를 호출하여 page에 object를 삽입하고, 삽입된
-  // object의 ID를 반환함
-  eduom_CreateObject(catObjForFile, nearObj, &objectHdr, length, data, oid);
+  // 2. 작은 object는 먼저 file을 shared mode로 latch 하고 file에 이미 있는
+  // page에 삽입함, 여러 thread가 동시에 삽입할 수 있음
+  eduom_StatsStartOp(&opStart);
+  done = FALSE;
+  if (ALIGNED_LENGTH(length) <= LRGOBJ_THRESHOLD) {
+    e = eduom_LatchFile(catObjForFile, LATCH_SHARED);
+    if (e >= eNOERROR) {
+      e = eduom_TryCreateObject(catObjForFile, nearObj, &objectHdr, length,
+                                data, oid, &done);
+      eduom_UnlatchFile(catObjForFile);
+    }
+
+    if (e < eNOERROR) {
+      eduom_StatsEndOp(catObjForFile, STATS_OP_CREATE, &opStart);
+      ERR(e);
+    }
+  }
+
+  if (done) {
+    eduom_StatsEndOp(catObjForFile, STATS_OP_CREATE, &opStart);
+    return (eNOERROR);
+  }
+
+  // 3. 새로운 page가 필요한 경우, file의 page list 등을 변경하므로 file을
+  // exclusive mode로 latch 하고 eduom_CreateObject()를 호출하여 page에
+  // object를 삽입하고, 삽입된 object의 ID를 반환함
+  e = eduom_LatchFile(catObjForFile, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) {
+    eduom_StatsEndOp(catObjForFile, STATS_OP_CREATE, &opStart);
+    ERR(e);
+  }
+
+  if (ALIGNED_LENGTH(length) <= LRGOBJ_THRESHOLD) {
+    e = eduom_CreateObject(catObjForFile, nearObj, &objectHdr, length, data,
+                           oid);
+  } else {
+    // 한 page에 저장할 수 없는 object는 데이터의 앞부분으로 작은 object를
+    // 만든 후 나머지 데이터를 덧붙여 large object tree로 저장함
+    e = eduom_CreateObject(catObjForFile, nearObj, &objectHdr,
+                           MIN_OBJECT_DATA_SIZE, data, oid);
+
+    if (e >= eNOERROR) {
+      MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+      e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+    }
+
+    if (e >= eNOERROR) {
+      e = OM_AppendToObject(catObjForFile, oid, length - MIN_OBJECT_DATA_SIZE,
+                            &data[MIN_OBJECT_DATA_SIZE], NULL, NULL);
+      eduom_UnlatchPage(&pid);
+    }
+  }
+
+  eduom_UnlatchFile(catObjForFile);
+  eduom_StatsEndOp(catObjForFile, STATS_OP_CREATE, &opStart);
+  if (e < eNOERROR) ERR(e);
 
   return (eNOERROR);
 }
@@ -138,11 +211,19 @@ Four EduOM_CreateObject(
  *
  *  eduom_CreateObject() creates a new object near the specified object; the
  * near page is the page holding the near object. If there is no room in the
- * near page and the near object 'nearObj' is not NULL, a new page is allocated
+ * near page and the near object 'nearObj' is not NULL, the pages around the
+ * near page within its extent are searched up to the cluster radius set by
+ * EduOM_SetClusterRadius(), skipping the insertion pages of the other
+ * threads of a partitioned file, and if none has room, a new page is allocated
  * for object creation (In this case, the newly allocated page is inserted after
  * the near page in the list of pages consiting in the file). If there is no
  * room in the near page and the near object 'nearObj' is NULL, it trys to
- * create a new object in the page in the available space list. If fail, then
+ * create a new object in the page selected by the placement policy of the file:
+ * the page with the least free space among the pages having enough room
+ * (best-fit), the first page of the fitting available space list or the last
+ * page (first-fit), the last page (append-only), or the insertion page of the
+ * current thread or the best-fit page not used by another thread
+ * (partitioned). If fail, then
  * the new object will be put into the newly allocated page(In this case, the
  * newly allocated page is appended at the tail of the list of pages cosisting
  * in the file).
@@ -163,6 +244,7 @@ Four eduom_CreateObject(
     ObjectID *oid)           /* OUT the object's ObjectID */
 {
   Four e;                  /* error number */
+  Four e2;                 /* error number of the cleanup */
   Four neededSpace;        /* space needed to put new object [+ header] */
   SlottedPage *apage;      /* pointer to the slotted page buffer */
   Four alignedLen;         /* aligned length of initial data */
@@ -170,14 +252,11 @@ Four eduom_CreateObject(
   PageID pid;              /* PageID in which new object to be inserted */
   PageID nearPid;
   Four firstExt;                  /* first Extent No of the file */
-  Object *obj;                    /* point to the newly created object */
-  Two i;                          /* index variable */
   sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
   SlottedPage *catPage;           /* pointer to buffer containing the catalog */
-  FileID fid; /* ID of file where the new object is placed */
-  Two eff;    /* extent fill factor of file */
-  Boolean isTmp;
   PhysicalFileID pFid;
+  Two policy;                     /* placement policy of the file */
+  Four source;                    /* where the page is found(STATS_PLACE_XXX) */
 
   /*@ parameter checking */
 
@@ -190,112 +269,575 @@ Four eduom_CreateObject(
 
   // File을 구성하는 page들 중 파라미터로 지정한 object와 같은 (또는 인접한)
   // page에 새로운 object를 삽입하고, 삽입된 object의 ID를 반환함
-  BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
   GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
   MAKE_PAGEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
-  RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+  e = RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
 
   // 1. Object 삽입을 위해 필요한 자유 공간의 크기를 계산함
   alignedLen = ALIGNED_LENGTH(length);
   neededSpace = sizeof(ObjectHdr) + alignedLen + sizeof(SlottedPageSlot);
 
   // 2. Object를 삽입할 page를 선정함
-  // 2-1. 파라미터로 주어진 nearObj가 NULL 이 아닌 경우
+  // 선정된 page가 없는 경우, 새로운 page를 할당 받아 object를 삽입할 page로
+  // 선정함, 할당 받은 page를 file 구성 page들로 이루어진 list에서 nearPid의
+  // 다음 page로 삽입함
+  e = eduom_SelectPage(catObjForFile, catEntry, nearObj, neededSpace, FALSE,
+                       &policy, &nearPid, &pid, &apage, &source);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  needToAllocPage = (pid.pageNo == NIL);
+  if (needToAllocPage) {
+    e = eduom_AllocNewPage(catObjForFile, catEntry, firstExt, &nearPid, &pid,
+                           &apage);
+    if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+    source = STATS_PLACE_NEWPAGE;
+  }
+
+  // 선정된 page를 찾은 곳을 통계에 기록함
+  if (source != NIL) eduom_StatsAddPlacement(catObjForFile, source);
+
+  // 3. 선정된 page를 exclusive mode로 latch 한 후 object를 삽입함
+  e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) {
+    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+  }
+
+  if (!needToAllocPage) {
+    // 선정된 page를 현재 available space list에서 삭제함
+    e = eduom_RemoveFromAvailSpaceList(catObjForFile, catEntry, &pid, apage);
+    if (e < eNOERROR) {
+      BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+      eduom_UnlatchPage(&pid);
+      ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+    }
+
+    // 필요시 선정된 page를 compact 함
+    // nearObj의 slot 번호는 선정된 page가 nearObj가 저장된 page인 경우에만
+    // 의미가 있음
+    if (SP_CFREE(apage) < neededSpace) {
+      if (nearObj != NULL && EQUAL_PAGEID(pid, nearPid))
+        e = EduOM_CompactPage(apage, nearObj->slotNo);
+      else
+        e = EduOM_CompactPage(apage, NIL);
+    }
+  }
+
+  if (e >= eNOERROR)
+    e = eduom_InsertIntoPage(apage, &pid, objHdr, length, data, oid);
+
+  // 4. Page를 알맞은 available space list에 삽입하고 free space map을 갱신함
+  // 삽입에 실패한 경우에도 page를 available space list에 다시 삽입하여
+  // page가 list에서 빠지지 않도록 함
+  e2 = eduom_ReturnInsertPage(catObjForFile, catEntry, policy,
+                              (e >= eNOERROR), &pid, apage);
+  if (e >= eNOERROR) e = e2;
+
+  e2 = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  e2 = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  eduom_UnlatchPage(&pid);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_CreateObject() */
+
+/*@================================
+ * eduom_TryCreateObject()
+ *================================*/
+/*
+ * Function: Four eduom_TryCreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four,
+ * char*, ObjectID*, Boolean*)
+ *
+ * Description :
+ *  Create a new object as eduom_CreateObject() does, but only in a page
+ *  already in the file, so that the caller may hold the latch on the file in
+ *  shared mode and many threads may insert at the same time. The page is
+ *  selected and the available space lists, the free space map and the
+ *  insertion pages are changed under the space latch of the file. The room
+ *  of the selected page is checked again under its exclusive latch since
+ *  another thread may have filled it meanwhile. If a new page is needed or
+ *  the selected page has been filled, nothing is changed and 'done' is set
+ *  to FALSE; the caller then calls eduom_CreateObject() holding the
+ *  exclusive latch on the file.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter oid
+ *     'oid' is set to the ObjectID of the newly created object.
+ *  2) parameter done
+ *     'done' is set to TRUE if the object is created
+ */
+Four eduom_TryCreateObject(
+    ObjectID *catObjForFile, /* IN file in which object is to be placed */
+    ObjectID *nearObj,       /* IN create the new object near this object */
+    ObjectHdr *objHdr,       /* IN from which tag & properties are set */
+    Four length,             /* IN amount of data */
+    char *data,              /* IN the initial data for the object */
+    ObjectID *oid,           /* OUT the object's ObjectID */
+    Boolean *done)           /* OUT is the object created? */
+{
+  Four e;                         /* error number */
+  Four e2;                        /* error number of the cleanup */
+  Four neededSpace;               /* space needed to put new object */
+  SlottedPage *apage;             /* pointer to the slotted page buffer */
+  PageID pid;                     /* page in which new object is inserted */
+  PageID nearPid;                 /* page of the near object */
+  sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+  SlottedPage *catPage;           /* pointer to buffer containing the catalog */
+  Two policy;                     /* placement policy of the file */
+  Four source;                    /* where the page is found(STATS_PLACE_XXX) */
+
+  *done = FALSE;
+
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+  neededSpace =
+      sizeof(ObjectHdr) + ALIGNED_LENGTH(length) + sizeof(SlottedPageSlot);
+
+  // 1. Space latch를 가진 동안 object를 삽입할 page를 선정함
+  // 새로운 page가 필요한 경우, file의 exclusive latch가 필요하므로 중단함
+  e = eduom_LatchFileSpace(catObjForFile);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  e = eduom_SelectPage(catObjForFile, catEntry, nearObj, neededSpace, TRUE,
+                       &policy, &nearPid, &pid, &apage, &source);
+  eduom_UnlatchFileSpace(catObjForFile);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  if (pid.pageNo == NIL) {
+    e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return (eNOERROR);
+  }
+
+  // 2. 선정된 page를 exclusive mode로 latch 한 후, space latch를 가진 동안
+  // page에 여전히 여유 공간이 있는지 확인하고 available space list에서
+  // 삭제함
+  e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) {
+    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+  }
+
+  e = eduom_LatchFileSpace(catObjForFile);
+  if (e < eNOERROR) {
+    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    eduom_UnlatchPage(&pid);
+    ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+  }
+
+  if (!eduom_HasRoomInPage(&pid, apage, neededSpace)) {
+    eduom_UnlatchFileSpace(catObjForFile);
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    eduom_UnlatchPage(&pid);
+    if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return (eNOERROR);
+  }
+
+  e = eduom_RemoveFromAvailSpaceList(catObjForFile, catEntry, &pid, apage);
+  eduom_UnlatchFileSpace(catObjForFile);
+  if (e < eNOERROR) {
+    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    eduom_UnlatchPage(&pid);
+    ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+  }
+
+  if (source != NIL) eduom_StatsAddPlacement(catObjForFile, source);
+
+  // 3. 필요시 page를 compact 한 후 object를 삽입함
+  if (SP_CFREE(apage) < neededSpace) {
+    if (nearObj != NULL && EQUAL_PAGEID(pid, nearPid))
+      e = EduOM_CompactPage(apage, nearObj->slotNo);
+    else
+      e = EduOM_CompactPage(apage, NIL);
+  }
+
+  if (e >= eNOERROR)
+    e = eduom_InsertIntoPage(apage, &pid, objHdr, length, data, oid);
+
+  // 4. Space latch를 가진 동안 page를 알맞은 available space list에 삽입하고
+  // free space map을 갱신함
+  e2 = eduom_LatchFileSpace(catObjForFile);
+  if (e2 >= eNOERROR) {
+    e2 = eduom_ReturnInsertPage(catObjForFile, catEntry, policy,
+                                (e >= eNOERROR), &pid, apage);
+    eduom_UnlatchFileSpace(catObjForFile);
+  }
+  if (e >= eNOERROR) e = e2;
+
+  e2 = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  e2 = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  eduom_UnlatchPage(&pid);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  *done = TRUE;
+
+  return (eNOERROR);
+
+} /* eduom_TryCreateObject() */
+
+/*@================================
+ * eduom_SelectPage()
+ *================================*/
+/*
+ * Function: Four eduom_SelectPage(ObjectID*, sm_CatOverlayForData*,
+ * ObjectID*, Four, Boolean, Two*, PageID*, PageID*, SlottedPage**, Four*)
+ *
+ * Description :
+ *  Select the page of the file into which a new object of 'neededSpace'
+ *  bytes is inserted, as described in eduom_CreateObject(). The selected
+ *  page is returned fixed in the buffer; the caller must free it. If no page
+ *  has enough room, 'pid->pageNo' is set to NIL and 'nearPid' is set to the
+ *  page after which a new page is to be linked. If 'shared' is TRUE, the
+ *  caller holds the shared file latch and the space latch, so no page is
+ *  latched here: a partitioned file then selects only the insertion page of
+ *  the current thread.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter policy
+ *     'policy' is set to the placement policy applied
+ *  2) parameter source
+ *     'source' is set to where the page is found(STATS_PLACE_XXX), or NIL
+ *     if it is already counted
+ */
+Four eduom_SelectPage(
+    ObjectID *catObjForFile,        /* IN file in which object is to be placed */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    ObjectID *nearObj,              /* IN create the new object near this */
+    Four neededSpace,               /* IN space needed in the page */
+    Boolean shared,                 /* IN is the file latched in shared mode? */
+    Two *policy,                    /* OUT placement policy applied */
+    PageID *nearPid,                /* OUT page after which a new page goes */
+    PageID *pid,                    /* OUT selected page */
+    SlottedPage **apage,            /* OUT pointer to the buffer of the page */
+    Four *source)                   /* OUT where the page is found */
+{
+  Four e;     /* error number */
+  Four e2;    /* error number of the cleanup */
+  Four owner; /* partition owning the page */
+
+  *policy = PLACEMENT_BEST_FIT;
+
+  // 1. 파라미터로 주어진 nearObj가 NULL 이 아닌 경우
   if (nearObj != NULL) {
-    MAKE_PAGEID(nearPid, nearObj->volNo, nearObj->pageNo);
-    BfM_GetTrain((TrainID *)&nearPid, (char **)&apage, PAGE_BUF);
-
-    // nearObj가 저장된 page에 여유 공간이 있는 경우, 해당 page를 object를
-    // 삽입할 page로 선정함, 선정된 page를 현재 available space list에서 삭제함
-    if (SP_FREE(apage) >= neededSpace) {
-      pid = nearPid;
-      om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
-
-      // 필요시 선정된 page를 compact 함
-      if (SP_CFREE(apage) < neededSpace) {
-        EduOM_CompactPage(apage, nearObj->slotNo);
-      }
+    MAKE_PAGEID(*nearPid, nearObj->volNo, nearObj->pageNo);
+    e = eduom_GetPartitionOwner(&catEntry->fid, nearPid->pageNo, &owner);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_GetTrain((TrainID *)nearPid, (char **)apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    // nearObj가 저장된 page가 다른 thread의 삽입 page가 아니고 여유 공간이
+    // 있는 경우, 해당 page를 object를 삽입할 page로 선정함
+    // 그렇지 않은 경우, 같은 extent 내의 인접한 page들 중 여유 공간이 있는
+    // page를 선정함
+    // 그러한 page가 없는 경우, 새로운 page를 nearObj가 저장된 page의 다음
+    // page로 삽입하도록 함
+    if ((owner == NIL || owner == eduom_GetPartitionNo()) &&
+        eduom_HasRoomInPage(nearPid, *apage, neededSpace)) {
+      *pid = *nearPid;
+      *source = STATS_PLACE_NEAR;
     } else {
-      // nearObj가 저장된 page에 여유 공간이 없는 경우, 새로운 page를 할당 받아
-      // object를 삽입할 page로 선정함, 선정된 page의 header를 초기화함, 선정된
-      // page를 file 구성 page들로 이루어진 list에서 nearObj 가 저장된 page의
-      // 다음 page로 삽입함
-      BfM_FreeTrain((TrainID *)&nearPid, PAGE_BUF);
-      RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff,
-                       1, PAGESIZE2, &pid);
-      BfM_GetNewTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-
-      apage->header.fid = catEntry->fid;
-      apage->header.flags = 0x2;
-      apage->header.free = 0;
-      apage->header.unused = 0;
-
-      om_FileMapAddPage(catObjForFile, &nearPid, &pid);
+      e = eduom_GetClusterPage(&catEntry->fid, nearPid, *apage, neededSpace,
+                               pid, apage);
+      e2 = BfM_FreeTrain((TrainID *)nearPid, PAGE_BUF);
+      if (e >= eNOERROR) e = e2;
+      if (e < eNOERROR) ERR(e);
+      *source = STATS_PLACE_CLUSTER;
+
+      if (pid->pageNo != NIL) {
+        e = eduom_GetPartitionOwner(&catEntry->fid, pid->pageNo, &owner);
+        if (e < eNOERROR) ERRB1(e, (TrainID *)pid, PAGE_BUF);
+      }
     }
+
+    // 선정된 page가 현재 thread의 삽입 page인 경우, available space list에
+    // 삽입되지 않도록 partitioned placement를 적용함
+    if (pid->pageNo != NIL && owner != NIL) *policy = PLACEMENT_PARTITIONED;
+
+    return (eNOERROR);
+  }
+
+  // 2. 파라미터로 주어진 nearObj가 NULL 인 경우, file의 placement policy에
+  // 따라 object를 삽입할 page를 선정함
+  e = eduom_GetPlacementPolicy(catEntry, policy);
+  if (e < eNOERROR) ERR(e);
+
+  if (*policy == PLACEMENT_BEST_FIT) {
+    // Free space map에서 object 삽입을 위해 필요한 자유 공간을 가지는 page
+    // 중 자유 공간이 가장 작은 page를 선정함
+    e = eduom_FsmGetPage(catEntry, neededSpace, pid, apage);
+    if (e < eNOERROR) ERR(e);
+    *source = STATS_PLACE_FSM;
+  } else if (*policy == PLACEMENT_FIRST_FIT) {
+    // Object 삽입을 위해 필요한 자유 공간의 크기에 알맞은 available space
+    // list의 첫 번째 page를 선정함
+    e = eduom_GetAvailSpaceListPage(catEntry, neededSpace, pid, apage);
+    if (e < eNOERROR) ERR(e);
+    *source = MIN(STATS_PLACE_LIST10 + (neededSpace - 1) / SP_10SIZE,
+                  STATS_PLACE_LIST50);
+  } else if (*policy == PLACEMENT_PARTITIONED) {
+    // 현재 thread의 삽입 page를 선정함, 여유 공간이 없는 경우 다른 thread의
+    // 삽입 page가 아닌 page 중 자유 공간이 가장 작은 page를 선정함
+    // 여러 thread가 file의 마지막 page에 몰리지 않도록 마지막 page는
+    // 선정하지 않음
+    e = eduom_GetPartitionPage(catObjForFile, catEntry, neededSpace, shared,
+                               pid, apage);
+    if (e < eNOERROR) ERR(e);
+    *source = NIL; /* counted by eduom_GetPartitionPage() */
   } else {
-    // 2-2. 파라미터로 주어진 nearObj가 NULL 인 경우, Object 삽입을 위해 필요한
-    // 자유 공간의 크기에 알맞은 available space list가 존재하는 경우, 해당
-    // available space list의 첫 번째 page를 object를 삽입할 page로 선정함
-    // 선정된 page를 현재 available space list에서 삭제함
-    PageNo possibleAvailPageNum = NIL;
-    if (neededSpace <= SP_10SIZE)
-      possibleAvailPageNum = catEntry->availSpaceList10;
-    else if (neededSpace <= SP_20SIZE)
-      possibleAvailPageNum = catEntry->availSpaceList20;
-    else if (neededSpace <= SP_30SIZE)
-      possibleAvailPageNum = catEntry->availSpaceList30;
-    else if (neededSpace <= SP_40SIZE)
-      possibleAvailPageNum = catEntry->availSpaceList40;
-    else if (neededSpace <= SP_50SIZE)
-      possibleAvailPageNum = catEntry->availSpaceList50;
-
-    if (possibleAvailPageNum != NIL) {
-      MAKE_PAGEID(pid, pFid.volNo, possibleAvailPageNum);
-      BfM_GetNewTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-      om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
-
-      // 필요시 선정된 page를 compact 함
-      if (SP_CFREE(apage) < neededSpace) {
-        EduOM_CompactPage(apage, nearObj->slotNo);
-      }
-    } else {
-      // Object 삽입을 위해 필요한 자유 공간의 크기에 알맞은 available space
-      // list가 존재하지 않고, file의 마지막 page에 여유 공간이 있는 경우,
-      // File의 마지막 page를 object를 삽입할 page로 선정함
-      MAKE_PAGEID(pid, pFid.volNo, catEntry->lastPage);
-      BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-      if (SP_FREE(apage) >= neededSpace) {
-        om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
-
-        // 필요시 선정된 page를 compact 함
-        if (SP_CFREE(apage) < neededSpace) {
-          EduOM_CompactPage(apage, nearObj->slotNo);
-        }
-
-      } else {
-        // Object 삽입을 위해 필요한 자유 공간의 크기에 알맞은 available space
-        // list가 존재하지 않고, file의 마지막 page에 여유 공간이 없 는 경우,
-        // 새로운 page를 할당 받아 object를 삽입할 page로 선정함
-        // 선정된 page의 header를 초기화함
-        // 선정된 page를 file의 구성 page들로 이루어진 list에서 마지막 page로
-        // 삽입함
-        BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-        MAKE_PAGEID(nearPid, pFid.volNo, catEntry->lastPage);
-        RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff,
-                         1, PAGESIZE2, &pid);
-        BfM_GetNewTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-
-        apage->header.fid = catEntry->fid;
-        apage->header.flags = 0x2;
-        apage->header.free = 0;
-        apage->header.unused = 0;
-
-        om_FileMapAddPage(catObjForFile, &nearPid, &pid);
-      }
+    pid->pageNo = NIL;
+  }
+
+  if (pid->pageNo == NIL &&
+      (*policy == PLACEMENT_FIRST_FIT || *policy == PLACEMENT_APPEND_ONLY)) {
+    // 선정된 page가 없고 file의 마지막 page에 여유 공간이 있는 경우, file의
+    // 마지막 page를 선정함
+    MAKE_PAGEID(*pid, catEntry->fid.volNo, catEntry->lastPage);
+    e = BfM_GetTrain((TrainID *)pid, (char **)apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (!eduom_HasRoomInPage(pid, *apage, neededSpace)) {
+      e = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+      if (e < eNOERROR) ERR(e);
+      pid->pageNo = NIL;
     }
+    *source = STATS_PLACE_LASTPAGE;
   }
 
-  // 3. 선정된 page에 object를 삽입함
+  // 선정된 page가 없는 경우, 새로운 page를 file의 마지막 page로 삽입하도록 함
+  MAKE_PAGEID(*nearPid, catEntry->fid.volNo, catEntry->lastPage);
+
+  return (eNOERROR);
+
+} /* eduom_SelectPage() */
+
+/*@================================
+ * eduom_ReturnInsertPage()
+ *================================*/
+/*
+ * Function: Four eduom_ReturnInsertPage(ObjectID*, sm_CatOverlayForData*,
+ * Two, Boolean, PageID*, SlottedPage*)
+ *
+ * Description :
+ *  Put the page into which an object has been inserted back where the
+ *  placement policy of the file keeps it. The page of an append-only file
+ *  is not put into an available space list since only the last page is
+ *  inserted into. The page of a partitioned file becomes the insertion page
+ *  of the current thread; it is not put into an available space list and is
+ *  recorded with no free space in the free space map so that no other
+ *  thread selects it. Otherwise, or if the insertion has failed or the
+ *  current thread has no partition number, the page is put into the
+ *  available space list matching its free space and its free space is
+ *  recorded in the free space map.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_ReturnInsertPage(
+    ObjectID *catObjForFile,        /* IN file of the page */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    Two policy,                     /* IN placement policy applied */
+    Boolean inserted,               /* IN is the object inserted? */
+    PageID *pid,                    /* IN page into which object is inserted */
+    SlottedPage *apage)             /* IN buffer of the page */
+{
+  Four e; /* error number */
+
+  e = eNOERROR;
+  if (inserted && policy == PLACEMENT_PARTITIONED &&
+      eduom_GetPartitionNo() != NIL) {
+    e = eduom_SetPartitionPage(&catEntry->fid, pid->pageNo);
+    if (e >= eNOERROR) e = eduom_FsmSetFreeSpace(&catEntry->fid, pid->pageNo, 0);
+  } else if (policy != PLACEMENT_APPEND_ONLY) {
+    if (policy == PLACEMENT_PARTITIONED)
+      e = eduom_DropPartitionPage(&catEntry->fid, pid->pageNo);
+    if (e >= eNOERROR) e = om_PutInAvailSpaceList(catObjForFile, pid, apage);
+    if (e >= eNOERROR)
+      e = eduom_FsmSetFreeSpace(&catEntry->fid, pid->pageNo, SP_FREE(apage));
+  }
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_ReturnInsertPage() */
+
+/*@================================
+ * eduom_AllocNewPage()
+ *================================*/
+/*
+ * Function: Four eduom_AllocNewPage(ObjectID*, sm_CatOverlayForData*, Four,
+ * PageID*, PageID*, SlottedPage**)
+ *
+ * Description :
+ *  Allocate a new page for the data file, from the pages preallocated for
+ *  the file if any, initialize its slotted page header and link it into the
+ *  list of pages of the file right after 'nearPid'.
+ *  The new page is returned fixed in the buffer; the caller must free it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter pid
+ *     'pid' is set to the PageID of the newly allocated page.
+ *  2) parameter apage
+ *     'apage' points to the buffer holding the newly allocated page.
+ */
+Four eduom_AllocNewPage(
+    ObjectID *catObjForFile,        /* IN file to which the page is added */
+    sm_CatOverlayForData *catEntry, /* IN catalog information of the file */
+    Four firstExt,                  /* IN first extent No of the file */
+    PageID *nearPid,                /* IN the new page is linked after it */
+    PageID *pid,                    /* OUT PageID of the new page */
+    SlottedPage **apage)            /* OUT buffer holding the new page */
+{
+  Four e; /* error number */
+
+  e = eduom_AllocPage(catEntry, firstExt, nearPid, pid);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_LinkNewPage(catObjForFile, &(catEntry->fid), nearPid, pid, apage);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_AllocNewPage() */
+
+/*@================================
+ * eduom_LinkNewPage()
+ *================================*/
+/*
+ * Function: Four eduom_LinkNewPage(ObjectID*, FileID*, PageID*, PageID*,
+ * SlottedPage**)
+ *
+ * Description :
+ *  Initialize the slotted page header of a page already allocated to the data
+ *  file by RDsM_AllocTrains() and link it into the list of pages of the file
+ *  right after 'nearPid'. The caller holds the exclusive latch on the file;
+ *  'nearPid' and the page after it are latched in exclusive mode while the
+ *  links are changed. The page is returned fixed in the buffer; the caller
+ *  must free it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter apage
+ *     'apage' points to the buffer holding the page.
+ */
+Four eduom_LinkNewPage(
+    ObjectID *catObjForFile, /* IN file to which the page is added */
+    FileID *fid,             /* IN ID of the file */
+    PageID *nearPid,         /* IN the new page is linked after it */
+    PageID *pid,             /* IN PageID of the new page */
+    SlottedPage **apage)     /* OUT buffer holding the new page */
+{
+  Four e;               /* error number */
+  SlottedPage *nearPage; /* buffer holding the near page */
+  PageID nextPid;        /* page after the near page */
+
+  e = BfM_GetNewTrain((TrainID *)pid, (char **)apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  // 할당 받은 page의 header를 초기화함
+  (*apage)->header.pid = *pid;
+  (*apage)->header.fid = *fid;
+  (*apage)->header.flags = SLOTTED_PAGE_TYPE | SLOT_FREELIST_VALID;
+  (*apage)->header.reserved = NIL;
+  (*apage)->header.nSlots = 0;
+  (*apage)->header.free = 0;
+  (*apage)->header.unused = 0;
+  (*apage)->header.unique = 0;
+  (*apage)->header.uniqueLimit = 0;
+
+  // 할당 받은 page를 file 구성 page들로 이루어진 list에서 nearPid의 다음
+  // page로 삽입함, list를 따라가는 scan이 변경 중인 link를 읽지 않도록
+  // link가 바뀌는 nearPid와 그 다음 page를 exclusive mode로 latch 함
+  // List는 file의 exclusive latch를 가진 thread만 바꾸므로 latch 없이 다음
+  // page를 읽을 수 있음
+  e = BfM_GetTrain((TrainID *)nearPid, (char **)&nearPage, PAGE_BUF);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)pid, PAGE_BUF);
+  MAKE_PAGEID(nextPid, nearPid->volNo, nearPage->header.nextPage);
+  e = BfM_FreeTrain((TrainID *)nearPid, PAGE_BUF);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)pid, PAGE_BUF);
+
+  e = eduom_LatchPagePair(nearPid, &nextPid);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)pid, PAGE_BUF);
+
+  e = om_FileMapAddPage(catObjForFile, nearPid, pid);
+  eduom_UnlatchPagePair(nearPid, &nextPid);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)pid, PAGE_BUF);
+  eduom_InvalidateCatalogDesc(catObjForFile);
+
+  return (eNOERROR);
+
+} /* eduom_LinkNewPage() */
+
+/*@================================
+ * eduom_InsertIntoPage()
+ *================================*/
+/*
+ * Function: Four eduom_InsertIntoPage(SlottedPage*, PageID*, ObjectHdr*, Four,
+ * char*, ObjectID*)
+ *
+ * Description :
+ *  Copy a new object into the contiguous free area of the given page and
+ *  assign a slot to it. The caller must guarantee that the contiguous free
+ *  area is large enough, and is responsible for the available space list
+ *  membership and the dirty flag of the page.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter oid
+ *     'oid' is set to the ObjectID of the newly created object.
+ */
+Four eduom_InsertIntoPage(
+    SlottedPage *apage, /* INOUT page into which the object is inserted */
+    PageID *pid,        /* IN PageID of the page */
+    ObjectHdr *objHdr,  /* IN from which tag & properties are set */
+    Four length,        /* IN amount of data */
+    char *data,         /* IN the initial data for the object */
+    ObjectID *oid)      /* OUT the object's ObjectID */
+{
+  Four e;                        /* error number */
+  Two i;                         /* index variable */
+  Object *obj;                   /* point to the newly created object */
+  SlottedPageSlot *insertedSlot; /* slot assigned to the new object */
 
   // Object의 header를 갱신함
   obj = (Object *)&(apage->data[apage->header.free]);
@@ -307,27 +849,162 @@ Four eduom_CreateObject(
   memcpy(obj->data, data, length);
 
   // Slot array의 빈 slot 또는 새로운 slot 한 개를 할당 받아 복사한 object의
-  // 식별을 위한 정보를 저장함
-  for (i = 0; i < apage->header.nSlots; ++i) {
-    if (apage->slot[-i].offset == EMPTYSLOT) break;
-  }
-  SlottedPageSlot *insertedSlot = &(apage->slot[-i]);
+  // 식별을 위한 정보를 저장함, 빈 slot은 page의 빈 slot chain에서 얻음
+  i = eduom_AllocSlot(apage);
+  insertedSlot = &(apage->slot[-i]);
+  e = eduom_GetUnique(pid, apage, &(insertedSlot->unique));
+  if (e < eNOERROR) ERR(e);
   insertedSlot->offset = apage->header.free;
-  om_GetUnique(&pid, &(insertedSlot->unique));
 
   // Page의 header를 갱신함
   if (i == apage->header.nSlots) apage->header.nSlots++;
-  apage->header.free += (sizeof(ObjectHdr) + alignedLen);
+  apage->header.free += (sizeof(ObjectHdr) + ALIGNED_LENGTH(length));
+
+  MAKE_OBJECTID(*oid, pid->volNo, pid->pageNo, i, insertedSlot->unique);
+
+  return (eNOERROR);
+
+} /* eduom_InsertIntoPage() */
+
+/*@================================
+ * eduom_GetUnique()
+ *================================*/
+/*
+ * Function: Four eduom_GetUnique(PageID*, SlottedPage*, Unique*)
+ *
+ * Description :
+ *  Get a unique number for a new slot of the page, which is already fixed by
+ *  the caller. The numbers are handed out from the range reserved in the
+ *  'unique' and 'uniqueLimit' fields of the page header; a new range is
+ *  reserved from the volume by RDsM_GetUnique() only when the range is used
+ *  up. The caller is responsible for the dirty flag of the page.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter unique
+ *     'unique' is set to the unique number for the new slot
+ */
+Four eduom_GetUnique(PageID *pid,        /* IN PageID of the page */
+                     SlottedPage *apage, /* INOUT buffer of the page */
+                     Unique *unique)     /* OUT the unique number */
+{
+  Four e;    /* error number */
+  Four nums; /* # of unique numbers reserved from the volume */
 
-  // Page를 알맞은 available space list에 삽입함
-  om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+  // Page에 예약된 unique 번호를 모두 사용한 경우, volume에서 새로운 범위를
+  // 예약함
+  if ((UFour)apage->header.unique >= (UFour)apage->header.uniqueLimit) {
+    e = RDsM_GetUnique(pid, unique, &nums);
+    if (e < eNOERROR) ERR(e);
 
-  MAKE_OBJECTID(*oid, pid.volNo, pid.pageNo, i, insertedSlot->unique);
+    apage->header.unique = *unique;
+    apage->header.uniqueLimit = *unique + nums;
+  }
 
-  BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
-  BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-  BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  *unique = apage->header.unique++;
 
   return (eNOERROR);
 
-} /* eduom_CreateObject() */
+} /* eduom_GetUnique() */
+
+/*@================================
+ * eduom_GetAvailSpaceListPage()
+ *================================*/
+/*
+ * Function: Four eduom_GetAvailSpaceListPage(sm_CatOverlayForData*, Four,
+ * PageID*, SlottedPage**)
+ *
+ * Description :
+ *  Select the first page of the smallest available space list whose pages
+ *  have room for 'neededSpace' bytes. The selected page is returned fixed in
+ *  the buffer; the caller must free it. If there is no such list or its first
+ *  page cannot be used, 'pid->pageNo' is set to NIL.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter pid, apage
+ *     'pid' and 'apage' are set to the selected page
+ */
+Four eduom_GetAvailSpaceListPage(
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    Four neededSpace,               /* IN space needed in the page */
+    PageID *pid,                    /* OUT selected page */
+    SlottedPage **apage)            /* OUT pointer to the buffer of the page */
+{
+  Four e;                     /* error number */
+  ShortPageID availPageNo;    /* first page of the fitting list */
+
+  availPageNo = NIL;
+  if (neededSpace <= SP_10SIZE)
+    availPageNo = catEntry->availSpaceList10;
+  else if (neededSpace <= SP_20SIZE)
+    availPageNo = catEntry->availSpaceList20;
+  else if (neededSpace <= SP_30SIZE)
+    availPageNo = catEntry->availSpaceList30;
+  else if (neededSpace <= SP_40SIZE)
+    availPageNo = catEntry->availSpaceList40;
+  else if (neededSpace <= SP_50SIZE)
+    availPageNo = catEntry->availSpaceList50;
+
+  MAKE_PAGEID(*pid, catEntry->fid.volNo, availPageNo);
+  if (availPageNo == NIL) return (eNOERROR);
+
+  e = BfM_GetTrain((TrainID *)pid, (char **)apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  // Pin 된 object가 있어 compact 할 수 없는 page는 선정하지 않음
+  if (!eduom_HasRoomInPage(pid, *apage, neededSpace)) {
+    BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    pid->pageNo = NIL;
+  }
+
+  return (eNOERROR);
+
+} /* eduom_GetAvailSpaceListPage() */
+
+/*@================================
+ * eduom_RemoveFromAvailSpaceList()
+ *================================*/
+/*
+ * Function: Four eduom_RemoveFromAvailSpaceList(ObjectID*,
+ * sm_CatOverlayForData*, PageID*, SlottedPage*)
+ *
+ * Description :
+ *  Remove the page from its available space list if it is in one.
+ *  om_RemoveFromAvailSpaceList() assumes that the page is in the list
+ *  matching its free space, which does not hold for the pages filled by
+ *  append-only insertion.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_RemoveFromAvailSpaceList(
+    ObjectID *catObjForFile,        /* IN file containing the page */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    PageID *pid,                    /* IN page to be removed */
+    SlottedPage *apage)             /* INOUT buffer of the page */
+{
+  Four e; /* error number */
+
+  if (apage->header.spaceListPrev == NIL &&
+      apage->header.spaceListNext == NIL &&
+      catEntry->availSpaceList10 != pid->pageNo &&
+      catEntry->availSpaceList20 != pid->pageNo &&
+      catEntry->availSpaceList30 != pid->pageNo &&
+      catEntry->availSpaceList40 != pid->pageNo &&
+      catEntry->availSpaceList50 != pid->pageNo)
+    return (eNOERROR);
+
+  e = om_RemoveFromAvailSpaceList(catObjForFile, pid, apage);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_RemoveFromAvailSpaceList() */
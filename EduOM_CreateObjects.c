@@ -0,0 +1,276 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_CreateObjects.c
+ *
+ * Description :
+ *  EduOM_CreateObjects() creates a batch of new objects, packing as many of
+ *  them as possible into each page before moving on to the next one.
+ *
+ * Exports:
+ *  Four EduOM_CreateObjects(ObjectID*, ObjectID*, Four, ObjectCreateInfo*,
+ * ObjectID*)
+ *
+ * Internal Functions:
+ *  Four eduom_CreateObjects(ObjectID*, ObjectID*, Four, ObjectCreateInfo*,
+ * ObjectID*)
+ */
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_basictypes.h"
+#include "EduOM_common.h"
+#include "RDsM.h" /* for the raw disk manager call */
+
+/*@================================
+ * EduOM_CreateObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_CreateObjects(ObjectID*, ObjectID*, Four,
+ * ObjectCreateInfo*, ObjectID*)
+ *
+ * Description :
+ *  EduOM_CreateObjects() creates 'nObjects' new objects described by the
+ *  array 'objInfo' in the given file. The catalog object is fixed only once
+ *  for the whole batch, and the target page stays fixed as long as the next
+ *  object fits into it. When the page is full, a new page is allocated right
+ *  after it; thus the objects of a batch are stored consecutively.
+ *  The page of the first object is selected as EduOM_CreateObject() does:
+ *  near 'nearObj' if it is not NULL, otherwise by the placement policy of
+ *  the file. Each filled page is put back where the placement policy keeps
+ *  it. The batch is counted as one create operation in the statistics.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  0) 'nObjects' new objects are created.
+ *  1) parameter oids
+ *     'oids[i]' is set to the ObjectID of the object created from 'objInfo[i]'.
+ */
+Four EduOM_CreateObjects(
+    ObjectID *catObjForFile,  /* IN file in which objects are to be placed */
+    ObjectID *nearObj,        /* IN create the new objects near this object */
+    Four nObjects,            /* IN number of objects to create */
+    ObjectCreateInfo *objInfo, /* IN header, length and data of each object */
+    ObjectID *oids)           /* OUT the objects' ObjectIDs */
+{
+  Four e;                  /* error number */
+  Four i;                  /* index variable */
+  struct timespec opStart; /* time when the operation starts */
+
+  /*@ parameter checking */
+
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (nObjects < 0) ERR(eBADPARAMETER_OM);
+
+  if (nObjects > 0 && (objInfo == NULL || oids == NULL))
+    ERR(eBADPARAMETER_OM);
+
+  for (i = 0; i < nObjects; i++) {
+    if (objInfo[i].length < 0) ERR(eBADLENGTH_OM);
+
+    if (objInfo[i].length > 0 && objInfo[i].data == NULL)
+      ERR(eBADUSERBUF_OM);
+
+    /* Error check whether using not supported functionality by EduOM */
+    if (ALIGNED_LENGTH(objInfo[i].length) > LRGOBJ_THRESHOLD)
+      ERR(eNOTSUPPORTED_EDUOM);
+  }
+
+  if (nObjects == 0) return (eNOERROR);
+
+  // File의 available space list 등을 변경하므로 file을 exclusive mode로
+  // latch 함
+  eduom_StatsStartOp(&opStart);
+  e = eduom_LatchFile(catObjForFile, LATCH_EXCLUSIVE);
+  if (e >= eNOERROR) {
+    e = eduom_CreateObjects(catObjForFile, nearObj, nObjects, objInfo, oids);
+    eduom_UnlatchFile(catObjForFile);
+  }
+
+  eduom_StatsEndOp(catObjForFile, STATS_OP_CREATE, &opStart);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_CreateObjects() */
+
+/*@================================
+ * eduom_CreateObjects()
+ *================================*/
+/*
+ * Function: Four eduom_CreateObjects(ObjectID*, ObjectID*, Four,
+ * ObjectCreateInfo*, ObjectID*)
+ *
+ * Description :
+ *  Create the objects of EduOM_CreateObjects() whose parameters are already
+ *  checked. The caller holds the exclusive latch on the file; each page is
+ *  latched in exclusive mode while it is fixed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter oids
+ *     'oids[i]' is set to the ObjectID of the object created from 'objInfo[i]'.
+ */
+Four eduom_CreateObjects(
+    ObjectID *catObjForFile,  /* IN file in which objects are to be placed */
+    ObjectID *nearObj,        /* IN create the new objects near this object */
+    Four nObjects,            /* IN number of objects to create */
+    ObjectCreateInfo *objInfo, /* IN header, length and data of each object */
+    ObjectID *oids)           /* OUT the objects' ObjectIDs */
+{
+  Four e;                         /* error number */
+  Four e2;                        /* error number of the cleanup */
+  Four i;                         /* index variable */
+  Four neededSpace;               /* space needed to put new object */
+  ObjectHdr objectHdr;            /* ObjectHdr with tag set from parameter */
+  SlottedPage *apage;             /* pointer to the slotted page buffer */
+  PageID pid;                     /* PageID in which objects are inserted */
+  PageID nearPid;                 /* the new page is linked after this page */
+  Boolean newPage;                /* is the first page newly allocated? */
+  Four firstExt;                  /* first Extent No of the file */
+  PhysicalFileID pFid;            /* physical ID of file */
+  SlottedPage *catPage;           /* pointer to buffer containing the catalog */
+  sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+  Two policy;                     /* placement policy of the file */
+  Four source;                    /* where the page is found(STATS_PLACE_XXX) */
+
+  // 1. Catalog object를 한 번만 fix 하여 file 정보를 얻음
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+  MAKE_PAGEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+  e = RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  // 2. 첫 번째 object를 삽입할 page를 eduom_CreateObject()와 같이 선정함
+  // 선정된 page가 없는 경우, 새로운 page를 할당 받아 nearPid의 다음 page로
+  // 삽입함, 선정된 page는 현재 available space list에서 삭제함
+  neededSpace = sizeof(ObjectHdr) + ALIGNED_LENGTH(objInfo[0].length) +
+                sizeof(SlottedPageSlot);
+  e = eduom_SelectPage(catObjForFile, catEntry, nearObj, neededSpace, FALSE,
+                       &policy, &nearPid, &pid, &apage, &source);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  newPage = (pid.pageNo == NIL);
+  if (newPage) {
+    e = eduom_AllocNewPage(catObjForFile, catEntry, firstExt, &nearPid, &pid,
+                           &apage);
+    if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+    source = STATS_PLACE_NEWPAGE;
+  }
+
+  if (source != NIL) eduom_StatsAddPlacement(catObjForFile, source);
+
+  e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) {
+    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+  }
+
+  if (!newPage) {
+    e = eduom_RemoveFromAvailSpaceList(catObjForFile, catEntry, &pid, apage);
+    if (e < eNOERROR) {
+      BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+      eduom_UnlatchPage(&pid);
+      ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+    }
+  }
+
+  // 3. 각 object를 fix 된 page에 차례로 삽입함
+  for (i = 0; i < nObjects; i++) {
+    objectHdr.properties = 0x0;
+    objectHdr.length = 0;
+    objectHdr.tag = (objInfo[i].objHdr != NULL) ? objInfo[i].objHdr->tag : 0;
+
+    neededSpace = sizeof(ObjectHdr) + ALIGNED_LENGTH(objInfo[i].length) +
+                  sizeof(SlottedPageSlot);
+
+    if (!eduom_HasRoomInPage(&pid, apage, neededSpace)) {
+      // 현재 page에 여유 공간이 없는 경우, 현재 page를 file의 placement
+      // policy에 따라 반환하고 unfix 한 후, 새로운 page를 할당 받아 현재
+      // page의 다음 page로 삽입함
+      e = eduom_ReturnInsertPage(catObjForFile, catEntry, policy, FALSE, &pid,
+                                 apage);
+      e2 = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+      if (e >= eNOERROR) e = e2;
+      e2 = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+      if (e >= eNOERROR) e = e2;
+      eduom_UnlatchPage(&pid);
+      if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+      nearPid = pid;
+      e = eduom_AllocNewPage(catObjForFile, catEntry, firstExt, &nearPid, &pid,
+                             &apage);
+      if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+      eduom_StatsAddPlacement(catObjForFile, STATS_PLACE_NEWPAGE);
+
+      e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+      if (e < eNOERROR) {
+        BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+      }
+    } else if (SP_CFREE(apage) < neededSpace) {
+      // 필요시 page를 compact 함
+      e = EduOM_CompactPage(apage, NIL);
+      if (e < eNOERROR) break;
+    }
+
+    e = eduom_InsertIntoPage(apage, &pid, &objectHdr, objInfo[i].length,
+                             objInfo[i].data, &oids[i]);
+    if (e < eNOERROR) break;
+  }
+
+  // 4. 마지막 page를 file의 placement policy에 따라 반환함
+  // 삽입에 실패한 경우에도 page를 available space list에 다시 삽입하여
+  // page가 list에서 빠지지 않도록 함
+  e2 = eduom_ReturnInsertPage(catObjForFile, catEntry, policy,
+                              (e >= eNOERROR), &pid, apage);
+  if (e >= eNOERROR) e = e2;
+
+  e2 = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  e2 = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  eduom_UnlatchPage(&pid);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_CreateObjects() */
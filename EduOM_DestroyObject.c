@@ -30,6 +30,10 @@
  *
  * Exports:
  *  Four EduOM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*)
+ *
+ * Internal Functions:
+ *  Four eduom_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*)
+ *  Four eduom_UnlinkPage(ObjectID*, PageID*, SlottedPage*)
  */
 
 #include "BfM.h" /* for the buffer manager call */
@@ -69,13 +73,17 @@
  *    ELSE
  *	   Put this page into the proper 'availSpaceList'
  *    ENDIF
- * f. Return
+ * f. IF no more object in this page THEN
+ *	   Deallocate the pages preallocated for the file
+ *    ENDIF
+ * g. Return
  *
  * Returns:
  *  error code
  *    eBADCATALOGOBJECT_OM
  *    eBADOBJECTID_OM
  *    eBADFILEID_OM
+ *    eOBJECTPINNED_EDUOM
  *    some errors caused by function calls
  */
 Four EduOM_DestroyObject(
@@ -83,85 +91,273 @@ Four EduOM_DestroyObject(
     ObjectID *oid,           /* IN object to destroy */
     Pool *dlPool,            /* INOUT pool of dealloc list elements */
     DeallocListElem *dlHead) /* INOUT head of dealloc list */
+{
+  Four e;                  /* error number */
+  Four e2;                 /* error number of the cleanup */
+  struct timespec opStart; /* time when the operation starts */
+
+  /*@ Check parameters. */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+  // File의 available space list 등을 변경하므로 file을 exclusive mode로
+  // latch 함
+  eduom_StatsStartOp(&opStart);
+  e = eduom_LatchFile(catObjForFile, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_DestroyObject(catObjForFile, oid, dlPool, dlHead);
+
+  eduom_UnlatchFile(catObjForFile);
+
+  // Cache 된 element들을 pool에 반환함
+  e2 = eduom_FlushElementPool(dlPool);
+  if (e >= eNOERROR) e = e2;
+  eduom_StatsEndOp(catObjForFile, STATS_OP_DESTROY, &opStart);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_DestroyObject() */
+
+/*@================================
+ * eduom_DestroyObject()
+ *================================*/
+/*
+ * Function: Four eduom_DestroyObject(ObjectID*, ObjectID*, Pool*,
+ *DeallocListElem*)
+ *
+ * Description :
+ *  Destroy the object of EduOM_DestroyObject() whose parameters are already
+ *  checked. The caller holds the exclusive latch on the file; the page of
+ *  the object is latched in exclusive mode until the object is removed.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_DestroyObject(
+    ObjectID *catObjForFile, /* IN file containing the object */
+    ObjectID *oid,           /* IN object to destroy */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead) /* INOUT head of dealloc list */
 {
   Four e;               /* error number */
+  Four e2;              /* error number of the cleanup */
   Two i;                /* temporary variable */
   FileID fid;           /* ID of file where the object was placed */
   PageID pid;           /* page on which the object resides */
   SlottedPage *apage;   /* pointer to the buffer holding the page */
   Four offset;          /* start offset of object in data area */
   Object *obj;          /* points to the object in data area */
-  Four alignedLen;      /* aligned length of object */
+  Four alignedLen;      /* aligned length of object + header in the page */
   Boolean last;         /* indicates the object is the last one */
   SlottedPage *catPage; /* buffer page containing the catalog object */
   sm_CatOverlayForData
       *catEntry;           /* overlay structure for catalog object access */
   DeallocListElem *dlElem; /* pointer to element of dealloc list */
   PhysicalFileID pFid;     /* physical ID of file */
+  ObjectID fwdOid;         /* forwarded object of a moved object */
 
-  /*@ Check parameters. */
-  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+  // File을 구성하는 page에서 object를 삭제함
 
-  if (oid == NULL) ERR(eBADOBJECTID_OM);
+  // 삭제할 object가 이동된 object인 경우, forwarded object를 먼저 삭제함
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
 
-  // File을 구성하는 page에서 object를 삭제함
+  e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERR(e);
+  }
+
+  if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots ||
+      !IS_VALID_OBJECTID(oid, apage)) {
+    eduom_UnlatchPage(&pid);
+    ERRB1(eBADOBJECTID_OM, (TrainID *)&pid, PAGE_BUF);
+  }
+
+  // Pin 된 object는 삭제할 수 없음, 삭제된 slot만 재사용되므로 pin 된
+  // object의 slot도 재사용되지 않음
+  if (eduom_IsPinnedObject(oid)) {
+    eduom_UnlatchPage(&pid);
+    ERRB1(eOBJECTPINNED_EDUOM, (TrainID *)&pid, PAGE_BUF);
+  }
+
+  obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+  if (obj->header.properties & P_MOVED) {
+    fwdOid = *((ObjectID *)obj->data);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e >= eNOERROR)
+      e = eduom_DestroyObject(catObjForFile, &fwdOid, dlPool, dlHead);
+  } else {
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  }
+
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERR(e);
+  }
 
   // 1. 삭제할 object가 저장된 page를 현재 available space list에서 삭제함
-  BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERR(e);
+  }
   GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
-  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
-  BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
 
-  om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+  e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+  }
+
+  e = eduom_RemoveFromAvailSpaceList(catObjForFile, catEntry, &pid, apage);
+  if (e < eNOERROR) {
+    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    eduom_UnlatchPage(&pid);
+    ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+  }
 
   // 2. 삭제할 object에 대응하는 slot을 사용하지 않는 빈 slot으로 설정함
   obj = (Object *)&(apage->data[apage->slot[(oid->slotNo) * -1].offset]);
   offset = apage->slot[(oid->slotNo) * -1].offset;
+  alignedLen = LENGTH_WITH_HDR(obj);
+
+  // 삭제할 object가 large object인 경우, large object tree를 삭제함
+  // Tree를 구성하는 page들은 dealloc list에 삽입됨
+  if (obj->header.properties & P_LRGOBJ) {
+    e = LOT_DestroyObject(&pid, oid->slotNo, dlPool, dlHead);
+    if (e < eNOERROR) {
+      om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+      BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+      eduom_UnlatchPage(&pid);
+      ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+    }
+  }
+
   apage->slot[(oid->slotNo) * -1].offset = EMPTYSLOT;
 
   // 3. Page header를 갱신함
   // 삭제할 object에 대응하는 slot이 slot array의 마지막 slot인 경우, slot
   // array의 크기를 갱신함
+  // 그렇지 않은 경우, slot을 page의 빈 slot chain에 삽입함
   if (apage->header.nSlots == oid->slotNo + 1) {
     apage->header.nSlots--;
+  } else {
+    eduom_FreeSlot(apage, oid->slotNo);
   }
   // 삭제할 object의 데이터 영역 상에서의 offset에 따라 free 또는 unused 변수를
   // 갱신함
-  if (offset + (sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length)) ==
-      apage->header.free) {
-    apage->header.free -=
-        (sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length));
+  if (offset + alignedLen == apage->header.free) {
+    apage->header.free -= alignedLen;
   } else {
-    apage->header.unused +=
-        (sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length));
+    apage->header.unused += alignedLen;
   }
 
   // 4. 삭제된 object가 page의 유일한 object이고, 해당 page가 file의 첫 번째
   // page가 아닌 경우
   if (apage->header.nSlots == 0 &&
       apage->header.pid.pageNo != catEntry->firstPage) {
-    // Page를 file 구성 page들로 이루어진 list에서 삭제함
     // 파라미터로 주어진 dlPool에서 새로운 dealloc list element 한 개를 할당
-    // 받음, 할당 받은 element에 deallocate 할 page 정보를 저장함
-    // Deallocate 할 page 정보가 저장된 element를 dealloc list의 첫 번째
-    // element로 삽입함
-    om_FileMapDeletePage(catObjForFile, &pid);
-    Util_getElementFromPool(dlPool, &dlElem);
-
-    dlElem->type = DL_PAGE;
-    dlElem->elem.pid = pid;
-    dlElem->next = dlHead->next;
-    dlHead->next = dlElem;
+    // 받은 후 page를 file 구성 page들로 이루어진 list에서 삭제함
+    // 할당 받은 element에 deallocate 할 page 정보를 저장하고, dealloc list의
+    // 첫 번째 element로 삽입함
+    // Element를 할당 받지 못했거나 page를 삭제하지 못한 경우, page가 유실되지
+    // 않도록 page를 file에 남겨 두고 available space list에 다시 삽입함
+    e = eduom_GetElementFromPool(dlPool, &dlElem);
+    if (e >= eNOERROR) {
+      e = eduom_UnlinkPage(catObjForFile, &pid, apage);
+      if (e < eNOERROR) eduom_FreeElementToPool(dlPool, dlElem);
+    }
+
+    if (e < eNOERROR) {
+      om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+    } else {
+      eduom_InvalidateCatalogDesc(catObjForFile);
+
+      dlElem->type = DL_PAGE;
+      dlElem->elem.pid = pid;
+      dlElem->next = dlHead->next;
+      dlHead->next = dlElem;
+
+      // Deallocate 할 page를 free space map 및 삽입 page 목록에서 삭제함
+      e = eduom_FsmSetFreeSpace(&catEntry->fid, pid.pageNo, 0);
+      if (e >= eNOERROR)
+        e = eduom_DropPartitionPage(&catEntry->fid, pid.pageNo);
+    }
   } else {
     // 5. 삭제된 object가 page의 유일한 object가 아니거나, 해당 page가 file의 첫
-    // 번째 page인 경우, Page를 알맞은 available space list에 삽입함
-    om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+    // 번째 page인 경우, Page를 알맞은 available space list에 삽입하고 free
+    // space map을 갱신함
+    // Unused 영역이 threshold를 넘는 page는 deferred compaction 대상으로 등록함
+    e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+    if (e >= eNOERROR)
+      e = eduom_FsmSetFreeSpace(&catEntry->fid, pid.pageNo, SP_FREE(apage));
+    if (e >= eNOERROR) e = eduom_AddCompactCandidate(&pid, apage);
   }
 
-  BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
-  BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-  BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  // 6. Page에 object가 남아 있지 않은 경우, file이 줄어들고 있으므로 미리
+  // 할당 받은 page들을 dealloc list에 삽입함
+  for (i = 0; i < apage->header.nSlots; i++)
+    if (apage->slot[-i].offset != EMPTYSLOT) break;
+
+  if (e >= eNOERROR && i == apage->header.nSlots)
+    e = eduom_ReleasePreallocPages(catEntry, dlPool, dlHead);
+
+  e2 = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  e2 = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  eduom_UnlatchPage(&pid);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
 
   return (eNOERROR);
 
-} /* EduOM_DestroyObject() */
+} /* eduom_DestroyObject() */
+
+/*@================================
+ * eduom_UnlinkPage()
+ *================================*/
+/*
+ * Function: Four eduom_UnlinkPage(ObjectID*, PageID*, SlottedPage*)
+ *
+ * Description :
+ *  Remove the page from the list of pages of the file. The caller holds the
+ *  exclusive latch on the file and on the page. The previous and the next
+ *  pages, whose links are changed, are latched in exclusive mode meanwhile
+ *  so that the scans following the list do not read a link being changed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_UnlinkPage(ObjectID *catObjForFile, /* IN file of the page */
+                      PageID *pid,             /* IN page to unlink */
+                      SlottedPage *apage)      /* IN buffer of the page */
+{
+  Four e;         /* error number */
+  PageID prevPid; /* previous page in the list */
+  PageID nextPid; /* next page in the list */
+
+  MAKE_PAGEID(prevPid, pid->volNo, apage->header.prevPage);
+  MAKE_PAGEID(nextPid, pid->volNo, apage->header.nextPage);
+
+  e = eduom_LatchPagePair(&prevPid, &nextPid);
+  if (e < eNOERROR) ERR(e);
+
+  e = om_FileMapDeletePage(catObjForFile, pid);
+  eduom_UnlatchPagePair(&prevPid, &nextPid);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_UnlinkPage() */
@@ -0,0 +1,359 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_ElemPool.c
+ *
+ * Description :
+ *  Per-thread cache of the elements of the pools, e.g. the pool of the
+ *  dealloc list elements. Util_getElementFromPool() is not reentrant, so
+ *  each call would otherwise take the storage latch, and an operation
+ *  releasing many pages, e.g. a reorganization, takes one element for every
+ *  page it frees. A thread instead takes the elements from the shared pool
+ *  ELEMPOOL_BATCH at a time under one storage latch and hands them out from
+ *  its cache without any latch.
+ *
+ *  The elements cached by a thread are returned to the shared pool in bulk
+ *  by eduom_FlushElementPool() at the end of every EduOM call taking
+ *  elements from the caller's pool, so that no element stays cached when
+ *  the caller finalizes the pool, and when the thread exits.
+ *
+ * Exports:
+ *  Four EduOM_FlushElementPool(Pool*)
+ *  Four eduom_FlushElementPool(Pool*)
+ *  Four eduom_GetElementFromPool(Pool*, void*)
+ *  Four eduom_FreeElementToPool(Pool*, void*)
+ *
+ * Internal Functions:
+ *  ElemPoolCache *eduom_GetElemPoolCache(Pool*)
+ *  Four eduom_FlushElemPoolCache(ElemPoolCache*)
+ *  void eduom_InitElemPool(void)
+ *  void eduom_FinalElemPool(void*)
+ */
+
+#define EDUOM_LATCH_INTERNAL /* call Util_getElementFromPool() directly */
+
+#include <pthread.h>
+
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+#include "Util.h" /* to get Pool */
+
+/* max # of pools cached by a thread */
+#define ELEMPOOL_MAX_POOLS 4
+
+/* # of elements taken from the shared pool at once */
+#define ELEMPOOL_BATCH 32
+
+/* elements of a pool cached by the current thread */
+typedef struct {
+  Pool *pool;                  /* the pool, NULL if the entry is not used */
+  Four nElems;                 /* # of elements in 'elems' */
+  void *elems[ELEMPOOL_BATCH]; /* elements taken from the pool */
+} ElemPoolCache;
+
+ElemPoolCache *eduom_GetElemPoolCache(Pool *);
+Four eduom_FlushElemPoolCache(ElemPoolCache *);
+void eduom_InitElemPool(void);
+void eduom_FinalElemPool(void *);
+
+static pthread_once_t elemPoolOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t elemPoolKey; /* flushes the caches when a thread exits */
+
+static __thread ElemPoolCache elemPoolCaches[ELEMPOOL_MAX_POOLS];
+
+/*@================================
+ * EduOM_FlushElementPool()
+ *================================*/
+/*
+ * Function: Four EduOM_FlushElementPool(Pool*)
+ *
+ * Description :
+ *  Return the elements of the pool cached by the current thread to the pool.
+ *  The EduOM calls taking elements from a pool flush it before returning,
+ *  so this is needed only by a caller using the pool with
+ *  eduom_GetElementFromPool() directly.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_FlushElementPool(Pool *aPool) /* IN pool to flush */
+{
+  Four e; /* error number */
+
+  if (aPool == NULL) ERR(eBADPARAMETER_OM);
+
+  e = eduom_FlushElementPool(aPool);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_FlushElementPool() */
+
+/*@================================
+ * eduom_FlushElementPool()
+ *================================*/
+/*
+ * Function: Four eduom_FlushElementPool(Pool*)
+ *
+ * Description :
+ *  Return the elements of the pool cached by the current thread to the pool.
+ *  Called at the end of the EduOM calls taking elements from the pool.
+ *  Nothing is done if 'aPool' is NULL.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FlushElementPool(Pool *aPool) /* IN pool to flush */
+{
+  Four e; /* error number */
+  Four i; /* index */
+
+  if (aPool == NULL) return (eNOERROR);
+
+  for (i = 0; i < ELEMPOOL_MAX_POOLS; i++) {
+    if (elemPoolCaches[i].pool == aPool) {
+      e = eduom_FlushElemPoolCache(&elemPoolCaches[i]);
+      if (e < eNOERROR) ERR(e);
+
+      elemPoolCaches[i].pool = NULL;
+    }
+  }
+
+  return (eNOERROR);
+
+} /* eduom_FlushElementPool() */
+
+/*@================================
+ * eduom_GetElementFromPool()
+ *================================*/
+/*
+ * Function: Four eduom_GetElementFromPool(Pool*, void*)
+ *
+ * Description :
+ *  Get an element of the pool from the cache of the current thread. If the
+ *  cache is empty, it is refilled from the shared pool.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter elem
+ *     'elem' points to the pointer set to the element
+ */
+Four eduom_GetElementFromPool(Pool *aPool, /* IN pool of the elements */
+                              void *elem)  /* OUT pointer to the element */
+{
+  Four e;               /* error number */
+  ElemPoolCache *cache; /* cache of the pool */
+
+  if (aPool == NULL) ERR(eBADPARAMETER_OM);
+
+  cache = eduom_GetElemPoolCache(aPool);
+
+  // Cache가 없거나 비어 있는 경우 shared pool에서 element들을 한 번에 가져옴
+  if (cache == NULL || cache->nElems == 0) {
+    eduom_LatchStorage();
+
+    if (cache == NULL) {
+      e = Util_getElementFromPool(aPool, elem);
+      eduom_UnlatchStorage();
+      if (e < eNOERROR) ERR(e);
+
+      return (eNOERROR);
+    }
+
+    for (e = eNOERROR; cache->nElems < ELEMPOOL_BATCH; cache->nElems++) {
+      e = Util_getElementFromPool(aPool, &(cache->elems[cache->nElems]));
+      if (e < eNOERROR) break;
+    }
+
+    eduom_UnlatchStorage();
+    if (cache->nElems == 0) ERR(e);
+  }
+
+  *(void **)elem = cache->elems[--cache->nElems];
+
+  return (eNOERROR);
+
+} /* eduom_GetElementFromPool() */
+
+/*@================================
+ * eduom_FreeElementToPool()
+ *================================*/
+/*
+ * Function: Four eduom_FreeElementToPool(Pool*, void*)
+ *
+ * Description :
+ *  Give back an element got by eduom_GetElementFromPool() which is not used,
+ *  e.g. when the operation needing it fails. The element is kept in the
+ *  cache of the current thread if it has room, otherwise it is returned to
+ *  the shared pool.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four eduom_FreeElementToPool(Pool *aPool, /* IN pool of the element */
+                             void *elem)  /* IN the element */
+{
+  Four e;               /* error number */
+  ElemPoolCache *cache; /* cache of the pool */
+
+  if (aPool == NULL || elem == NULL) ERR(eBADPARAMETER_OM);
+
+  cache = eduom_GetElemPoolCache(aPool);
+
+  if (cache != NULL && cache->nElems < ELEMPOOL_BATCH) {
+    cache->elems[cache->nElems++] = elem;
+    return (eNOERROR);
+  }
+
+  eduom_LatchStorage();
+  e = Util_freeElementToPool(aPool, elem);
+  eduom_UnlatchStorage();
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_FreeElementToPool() */
+
+/*@================================
+ * eduom_GetElemPoolCache()
+ *================================*/
+/*
+ * Function: ElemPoolCache *eduom_GetElemPoolCache(Pool*)
+ *
+ * Description :
+ *  Find the cache of the pool of the current thread. A new cache is
+ *  assigned if the pool has no cache yet.
+ *
+ * Returns:
+ *  pointer to the cache, NULL if the thread caches too many pools
+ */
+ElemPoolCache *eduom_GetElemPoolCache(Pool *aPool) /* IN pool of the cache */
+{
+  Four i;                /* index */
+  ElemPoolCache *unused; /* cache which is not used */
+
+  unused = NULL;
+  for (i = 0; i < ELEMPOOL_MAX_POOLS; i++) {
+    if (elemPoolCaches[i].pool == aPool) return (&elemPoolCaches[i]);
+    if (elemPoolCaches[i].pool == NULL && unused == NULL)
+      unused = &elemPoolCaches[i];
+  }
+
+  if (unused != NULL) {
+    // Thread 종료 시 cache 된 element들을 pool에 반환하도록 등록함
+    pthread_once(&elemPoolOnce, eduom_InitElemPool);
+    pthread_setspecific(elemPoolKey, elemPoolCaches);
+
+    unused->pool = aPool;
+    unused->nElems = 0;
+  }
+
+  return (unused);
+
+} /* eduom_GetElemPoolCache() */
+
+/*@================================
+ * eduom_FlushElemPoolCache()
+ *================================*/
+/*
+ * Function: Four eduom_FlushElemPoolCache(ElemPoolCache*)
+ *
+ * Description :
+ *  Return all the elements of the cache to its pool under one storage latch.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FlushElemPoolCache(ElemPoolCache *cache) /* INOUT cache to flush */
+{
+  Four e; /* error number */
+
+  eduom_LatchStorage();
+
+  for (e = eNOERROR; cache->nElems > 0; cache->nElems--) {
+    e = Util_freeElementToPool(cache->pool, cache->elems[cache->nElems - 1]);
+    if (e < eNOERROR) break;
+  }
+
+  eduom_UnlatchStorage();
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_FlushElemPoolCache() */
+
+/*@================================
+ * eduom_InitElemPool()
+ *================================*/
+/*
+ * Function: void eduom_InitElemPool(void)
+ *
+ * Description :
+ *  Create the key whose destructor flushes the caches of an exiting thread.
+ *  Called once.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_InitElemPool(void)
+{
+  pthread_key_create(&elemPoolKey, eduom_FinalElemPool);
+
+} /* eduom_InitElemPool() */
+
+/*@================================
+ * eduom_FinalElemPool()
+ *================================*/
+/*
+ * Function: void eduom_FinalElemPool(void*)
+ *
+ * Description :
+ *  Return the cached elements of an exiting thread to their pools.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_FinalElemPool(void *caches) /* IN caches of the exiting thread */
+{
+  Four i; /* index */
+
+  for (i = 0; i < ELEMPOOL_MAX_POOLS; i++) {
+    if (((ElemPoolCache *)caches)[i].pool != NULL) {
+      eduom_FlushElemPoolCache(&((ElemPoolCache *)caches)[i]);
+      ((ElemPoolCache *)caches)[i].pool = NULL;
+    }
+  }
+
+} /* eduom_FinalElemPool() */
@@ -0,0 +1,160 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_FileInfo.c
+ *
+ * Description :
+ *  Table of the in-memory information kept by EduOM for each data file.
+ *
+ * Exports:
+ *  Four eduom_GetFileInfo(FileID*, eduom_FileInfo**)
+ *  Four eduom_GetPlacementPolicy(sm_CatOverlayForData*, Two*)
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+/* table of the in-memory file information */
+static eduom_FileInfo *fileInfoTable = NULL;
+
+/* protects the file info table */
+static pthread_mutex_t fileInfoMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*@================================
+ * eduom_GetFileInfo()
+ *================================*/
+/*
+ * Function: Four eduom_GetFileInfo(FileID*, eduom_FileInfo**)
+ *
+ * Description :
+ *  Find the in-memory information about the given data file. If there is
+ *  no information about the file yet, a new empty entry is created. The
+ *  entries are never freed; the caller accesses the entry holding the
+ *  exclusive latch on the file, or the shared latch and the space latch.
+ *
+ * Returns:
+ *  error code
+ *    eBADFILEID_OM
+ *    eMEMORYALLOCERR_EDUOM
+ *
+ * Side Effects :
+ *  1) parameter info
+ *     'info' points to the entry of the file
+ */
+Four eduom_GetFileInfo(FileID *fid,            /* IN ID of the file */
+                       eduom_FileInfo **info) /* OUT information of the file */
+{
+  eduom_FileInfo *entry; /* entry of the file info table */
+  Four i;                /* index */
+
+  if (fid == NULL) ERR(eBADFILEID_OM);
+
+  pthread_mutex_lock(&fileInfoMutex);
+
+  // 1. File info table에서 file의 entry를 탐색함
+  for (entry = fileInfoTable; entry != NULL; entry = entry->next) {
+    if (EQUAL_FILEID(entry->fid, *fid)) {
+      pthread_mutex_unlock(&fileInfoMutex);
+      *info = entry;
+      return (eNOERROR);
+    }
+  }
+
+  // 2. Entry가 없는 경우 새로운 entry를 만들어 table에 삽입함
+  entry = (eduom_FileInfo *)malloc(sizeof(eduom_FileInfo));
+  if (entry == NULL) {
+    pthread_mutex_unlock(&fileInfoMutex);
+    ERR(eMEMORYALLOCERR_EDUOM);
+  }
+
+  memset(entry, 0, sizeof(eduom_FileInfo));
+  entry->fid = *fid;
+  entry->placementPolicy = NIL;
+  entry->fsm.built = FALSE;
+  for (i = 0; i < PARTITION_SLOTS; i++) entry->partition.pages[i] = NIL;
+
+  entry->next = fileInfoTable;
+  fileInfoTable = entry;
+
+  pthread_mutex_unlock(&fileInfoMutex);
+
+  *info = entry;
+
+  return (eNOERROR);
+
+} /* eduom_GetFileInfo() */
+
+/*@================================
+ * eduom_GetPlacementPolicy()
+ *================================*/
+/*
+ * Function: Four eduom_GetPlacementPolicy(sm_CatOverlayForData*, Two*)
+ *
+ * Description :
+ *  Get the placement policy of the data file. The policy is read from the
+ *  flags of the first page of the file only when it is not cached yet.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter policy
+ *     'policy' is set to the placement policy of the file
+ */
+Four eduom_GetPlacementPolicy(
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    Two *policy)                    /* OUT placement policy of the file */
+{
+  Four e;               /* error number */
+  eduom_FileInfo *info; /* in-memory information of the file */
+  PageID pid;           /* first page of the file */
+  SlottedPage *apage;   /* pointer to the buffer of the first page */
+
+  e = eduom_GetFileInfo(&catEntry->fid, &info);
+  if (e < eNOERROR) ERR(e);
+
+  if (info->placementPolicy == NIL) {
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    info->placementPolicy =
+        (apage->header.flags & PLACEMENT_POLICY_MASK) >> PLACEMENT_POLICY_SHIFT;
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  *policy = info->placementPolicy;
+
+  return (eNOERROR);
+
+} /* eduom_GetPlacementPolicy() */
@@ -0,0 +1,411 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_FileReport.c
+ *
+ * Description :
+ *  Fragmentation and fill factor report of a data file. The pages of the
+ *  file are visited along the page list from the first page, and for each
+ *  page the slot usage, the free space and the available space list the
+ *  page is on are written; then the histograms and the totals of the file
+ *  follow. Every line is a record type followed by 'key=value' fields, e.g.
+ *
+ *    page pageNo=12 nSlots=80 live=71 empty=9 moved=0 forwarded=0
+ *         free=3700 unused=320 cfree=24 spfree=344 fill=91 list=10
+ *    hist name=fill bucket=90 pages=40
+ *    file volNo=1000 serial=3 pages=42 objects=3012 ... fill=87
+ *
+ *  (a 'page' record is a single line). 'fill' is the percentage of the data
+ *  area of the page (PAGESIZE - SP_FIXED) not available for new objects,
+ *  and 'list' is 10, 20, 30, 40, 50 or none. The 'fill' and 'unused'
+ *  histograms have buckets of 10%; the bucket is the lower bound.
+ *
+ * Exports:
+ *  Four EduOM_ReportFile(ObjectID*, FILE*)
+ *
+ * Internal Functions:
+ *  Four eduom_ReportFile(ObjectID*, FILE*)
+ *  Four eduom_CollectListMembers(VolNo, ShortPageID*, ListMember**, Four*)
+ *  Two eduom_FindListMember(ListMember*, Four, ShortPageID)
+ *  int eduom_CompareListMember(const void*, const void*)
+ */
+
+#include <stdlib.h>
+
+#include "BfM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+/* # of the buckets of the percentage histograms */
+#define REPORT_NUM_BUCKETS 10
+
+/* # of the available space lists */
+#define REPORT_NUM_LISTS 5
+
+/* size of the data area of a page which can hold objects */
+#define REPORT_DATA_AREA ((Four)(PAGESIZE - SP_FIXED))
+
+/* names of the available space lists, the last one for no list */
+static char *listName[REPORT_NUM_LISTS + 1] = {"10", "20", "30",
+                                               "40", "50", "none"};
+
+/*
+ * Typedef for a page on an available space list
+ */
+typedef struct {
+  ShortPageID pageNo; /* page on the list */
+  Two list;           /* index of the list, 0 for the 10% list */
+} ListMember;
+
+Four eduom_ReportFile(ObjectID *, FILE *);
+Four eduom_CollectListMembers(VolNo, ShortPageID *, ListMember **, Four *);
+Two eduom_FindListMember(ListMember *, Four, ShortPageID);
+int eduom_CompareListMember(const void *, const void *);
+
+/*@================================
+ * EduOM_ReportFile()
+ *================================*/
+/*
+ * Function: Four EduOM_ReportFile(ObjectID*, FILE*)
+ *
+ * Description :
+ *  Write the fragmentation and fill factor report of the given data file to
+ *  'fp'. The file is latched in exclusive mode while the report is made, so
+ *  that the pages and the available space lists do not change meanwhile;
+ *  the object creations holding the shared latch change the lists.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_ReportFile(ObjectID *catObjForFile, /* IN file to report */
+                      FILE *fp)                /* IN stream to write to */
+{
+  Four e; /* error number */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (fp == NULL) ERR(eBADPARAMETER_OM);
+
+  e = eduom_LatchFile(catObjForFile, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_ReportFile(catObjForFile, fp);
+
+  eduom_UnlatchFile(catObjForFile);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_ReportFile() */
+
+/*@================================
+ * eduom_ReportFile()
+ *================================*/
+/*
+ * Function: Four eduom_ReportFile(ObjectID*, FILE*)
+ *
+ * Description :
+ *  Make the report of EduOM_ReportFile(). The caller holds the latch on the
+ *  file.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_ReportFile(ObjectID *catObjForFile, /* IN file to report */
+                      FILE *fp)                /* IN stream to write to */
+{
+  Four e;                   /* error number */
+  Two i;                    /* index variable */
+  PageID pid;               /* current page */
+  SlottedPage *apage;       /* buffer holding the current page */
+  SlottedPage *catPage;     /* buffer page containing the catalog object */
+  sm_CatOverlayForData *catEntry; /* overlay for the catalog object */
+  FileID fid;               /* ID of the file */
+  ShortPageID firstPage;    /* first page of the file */
+  ShortPageID lastPage;     /* last page of the file */
+  ShortPageID nextPage;     /* next page of the current page */
+  ShortPageID heads[REPORT_NUM_LISTS]; /* heads of the avail space lists */
+  ListMember *members;      /* pages on the avail space lists */
+  Four nMembers;            /* # of entries of 'members' */
+  Four live, empty;         /* # of live and empty slots of the page */
+  Four moved, forwarded;    /* # of moved and forwarded objects of the page */
+  Four spFree;              /* free space of the page */
+  Four fill;                /* fill factor of the page in percent */
+  Two list;                 /* avail space list of the page */
+  Object *obj;              /* object in the page */
+  Four nPages;              /* # of pages of the file */
+  Four nObjects;            /* # of live slots of the file */
+  Four nEmpty;              /* # of empty slots of the file */
+  Four totalFree;           /* sum of 'free' of the pages */
+  Four totalUnused;         /* sum of 'unused' of the pages */
+  Four totalCFree;          /* sum of the contiguous free space of the pages */
+  Four totalSpFree;         /* sum of the free space of the pages */
+  Four fillHist[REPORT_NUM_BUCKETS];       /* histogram of the fill factor */
+  Four unusedHist[REPORT_NUM_BUCKETS];     /* histogram of 'unused' */
+  Four listHist[REPORT_NUM_LISTS + 1];     /* # of pages on each list */
+
+  // 1. Catalog object에서 file의 page list 및 available space list 정보를
+  // 읽음
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+  fid = catEntry->fid;
+  firstPage = catEntry->firstPage;
+  lastPage = catEntry->lastPage;
+  heads[0] = catEntry->availSpaceList10;
+  heads[1] = catEntry->availSpaceList20;
+  heads[2] = catEntry->availSpaceList30;
+  heads[3] = catEntry->availSpaceList40;
+  heads[4] = catEntry->availSpaceList50;
+
+  e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  // 2. 각 available space list에 속한 page들을 모음
+  e = eduom_CollectListMembers(fid.volNo, heads, &members, &nMembers);
+  if (e < eNOERROR) ERR(e);
+
+  nPages = nObjects = nEmpty = 0;
+  totalFree = totalUnused = totalCFree = totalSpFree = 0;
+  for (i = 0; i < REPORT_NUM_BUCKETS; i++) fillHist[i] = unusedHist[i] = 0;
+  for (i = 0; i <= REPORT_NUM_LISTS; i++) listHist[i] = 0;
+
+  // 3. File의 page list를 따라가며 각 page의 정보를 출력함
+  MAKE_PAGEID(pid, fid.volNo, firstPage);
+  while (pid.pageNo != NIL) {
+    e = eduom_LatchPage(&pid, LATCH_SHARED);
+    if (e < eNOERROR) {
+      free(members);
+      ERR(e);
+    }
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) {
+      eduom_UnlatchPage(&pid);
+      free(members);
+      ERR(e);
+    }
+
+    live = empty = moved = forwarded = 0;
+    for (i = 0; i < apage->header.nSlots; i++) {
+      if (apage->slot[-i].offset == EMPTYSLOT) {
+        empty++;
+        continue;
+      }
+
+      live++;
+      obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+      if (obj->header.properties & P_MOVED) moved++;
+      if (obj->header.properties & P_FORWARDED) forwarded++;
+    }
+
+    spFree = SP_FREE(apage);
+    fill = (REPORT_DATA_AREA - spFree) * 100 / REPORT_DATA_AREA;
+    list = eduom_FindListMember(members, nMembers, pid.pageNo);
+
+    fprintf(fp,
+            "page pageNo=%ld nSlots=%ld live=%ld empty=%ld moved=%ld "
+            "forwarded=%ld free=%ld unused=%ld cfree=%ld spfree=%ld fill=%ld "
+            "list=%s\n",
+            (long)pid.pageNo, (long)apage->header.nSlots, (long)live,
+            (long)empty, (long)moved, (long)forwarded,
+            (long)apage->header.free, (long)apage->header.unused,
+            (long)SP_CFREE(apage), (long)spFree, (long)fill, listName[list]);
+
+    nPages++;
+    nObjects += live;
+    nEmpty += empty;
+    totalFree += apage->header.free;
+    totalUnused += apage->header.unused;
+    totalCFree += SP_CFREE(apage);
+    totalSpFree += spFree;
+    fillHist[MIN(MAX(fill, 0) / 10, REPORT_NUM_BUCKETS - 1)]++;
+    unusedHist[MIN(apage->header.unused * 10 / REPORT_DATA_AREA,
+                   REPORT_NUM_BUCKETS - 1)]++;
+    listHist[list]++;
+
+    // 파일의 마지막 page인 경우 탐색을 종료함
+    nextPage = (pid.pageNo == lastPage) ? NIL : apage->header.nextPage;
+
+    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    eduom_UnlatchPage(&pid);
+
+    pid.pageNo = nextPage;
+  }
+
+  free(members);
+
+  // 4. File 단위의 histogram 및 합계를 출력함
+  for (i = 0; i < REPORT_NUM_BUCKETS; i++)
+    fprintf(fp, "hist name=fill bucket=%ld pages=%ld\n", (long)(i * 10),
+            (long)fillHist[i]);
+  for (i = 0; i < REPORT_NUM_BUCKETS; i++)
+    fprintf(fp, "hist name=unused bucket=%ld pages=%ld\n", (long)(i * 10),
+            (long)unusedHist[i]);
+  for (i = 0; i <= REPORT_NUM_LISTS; i++)
+    fprintf(fp, "hist name=list bucket=%s pages=%ld\n", listName[i],
+            (long)listHist[i]);
+
+  fprintf(fp,
+          "file volNo=%ld serial=%ld pages=%ld objects=%ld emptySlots=%ld "
+          "free=%ld unused=%ld cfree=%ld spfree=%ld fill=%ld\n",
+          (long)fid.volNo, (long)fid.serial, (long)nPages, (long)nObjects,
+          (long)nEmpty, (long)totalFree, (long)totalUnused, (long)totalCFree,
+          (long)totalSpFree,
+          nPages > 0 ? (long)((REPORT_DATA_AREA * nPages - totalSpFree) * 100 /
+                              (REPORT_DATA_AREA * nPages))
+                     : 0L);
+
+  return (eNOERROR);
+
+} /* eduom_ReportFile() */
+
+/*@================================
+ * eduom_CollectListMembers()
+ *================================*/
+/*
+ * Function: Four eduom_CollectListMembers(VolNo, ShortPageID*, ListMember**,
+ *                                         Four*)
+ *
+ * Description :
+ *  Collect the pages on the available space lists of the file by following
+ *  each list from its head. The pages are returned in 'members' sorted by
+ *  the page number; the caller must free 'members'.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUOM
+ *    some errors caused by function calls
+ */
+Four eduom_CollectListMembers(
+    VolNo volNo,          /* IN volume of the file */
+    ShortPageID *heads,   /* IN heads of the available space lists */
+    ListMember **members, /* OUT pages on the lists */
+    Four *nMembers)       /* OUT # of entries of 'members' */
+{
+  Four e;               /* error number */
+  Two list;             /* index of the list */
+  Four size;            /* # of entries allocated for 'members' */
+  PageID pid;           /* current page of the list */
+  SlottedPage *apage;   /* buffer holding the current page */
+  ShortPageID nextPage; /* next page of the current page on the list */
+  ListMember *newArray; /* reallocated array of 'members' */
+
+  size = 64;
+  *nMembers = 0;
+  *members = (ListMember *)malloc(sizeof(ListMember) * size);
+  if (*members == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+  for (list = 0; list < REPORT_NUM_LISTS; list++) {
+    MAKE_PAGEID(pid, volNo, heads[list]);
+    while (pid.pageNo != NIL) {
+      if (*nMembers == size) {
+        size *= 2;
+        newArray = (ListMember *)realloc(*members, sizeof(ListMember) * size);
+        if (newArray == NULL) {
+          free(*members);
+          ERR(eMEMORYALLOCERR_EDUOM);
+        }
+        *members = newArray;
+      }
+
+      (*members)[*nMembers].pageNo = pid.pageNo;
+      (*members)[*nMembers].list = list;
+      (*nMembers)++;
+
+      e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+      if (e < eNOERROR) {
+        free(*members);
+        ERR(e);
+      }
+      nextPage = apage->header.spaceListNext;
+      BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+
+      pid.pageNo = nextPage;
+    }
+  }
+
+  qsort(*members, *nMembers, sizeof(ListMember), eduom_CompareListMember);
+
+  return (eNOERROR);
+
+} /* eduom_CollectListMembers() */
+
+/*@================================
+ * eduom_FindListMember()
+ *================================*/
+/*
+ * Function: Two eduom_FindListMember(ListMember*, Four, ShortPageID)
+ *
+ * Description :
+ *  Find the available space list the page is on by a binary search of the
+ *  sorted 'members'.
+ *
+ * Returns:
+ *  index of the list, or REPORT_NUM_LISTS if the page is on no list
+ */
+Two eduom_FindListMember(ListMember *members, /* IN sorted pages on lists */
+                         Four nMembers,       /* IN # of entries */
+                         ShortPageID pageNo)  /* IN page to find */
+{
+  ListMember key;     /* entry to search for */
+  ListMember *member; /* entry found */
+
+  key.pageNo = pageNo;
+  member = (ListMember *)bsearch(&key, members, nMembers, sizeof(ListMember),
+                                 eduom_CompareListMember);
+
+  return (member != NULL ? member->list : REPORT_NUM_LISTS);
+
+} /* eduom_FindListMember() */
+
+/*@================================
+ * eduom_CompareListMember()
+ *================================*/
+/*
+ * Function: int eduom_CompareListMember(const void*, const void*)
+ *
+ * Description :
+ *  Compare two pages on the available space lists by the page number.
+ *
+ * Returns:
+ *  negative, zero or positive as the first page number is smaller, equal or
+ *  larger
+ */
+int eduom_CompareListMember(const void *a, /* IN first entry */
+                            const void *b) /* IN second entry */
+{
+  ShortPageID x = ((ListMember *)a)->pageNo; /* first page number */
+  ShortPageID y = ((ListMember *)b)->pageNo; /* second page number */
+
+  return (x < y) ? -1 : (x > y);
+
+} /* eduom_CompareListMember() */
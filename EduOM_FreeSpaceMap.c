@@ -0,0 +1,368 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_FreeSpaceMap.c
+ *
+ * Description :
+ *  In-memory free space map of a data file. The five available space lists
+ *  kept in the catalog only tell whether a page has more than 10%, 20%, ...,
+ *  50% of free space, so a page is selected by a coarse bucket. The free space
+ *  map classifies every page of the file by its free space in units of
+ *  FSM_UNIT bytes and keeps a bitmap of the nonempty categories, so the page
+ *  whose free space fits the new object best is found in constant time. The
+ *  smallest category a new object may fit holds pages with a little less and
+ *  a little more room than needed; a few of them are checked against their
+ *  exact free space before larger categories are tried.
+ *
+ *  The map is built when it is first used by scanning the pages of the file
+ *  and is updated whenever the free space of a page changes. A page selected
+ *  from the map is verified after it is fixed; if the map is stale the entry
+ *  is corrected and another page is selected.
+ *
+ * Exports:
+ *  Four eduom_FsmSetFreeSpace(FileID*, ShortPageID, Four)
+ *  Four eduom_FsmGetPage(sm_CatOverlayForData*, Four, PageID*, SlottedPage**)
+ *
+ * Internal Functions:
+ *  Four eduom_FsmBuild(sm_CatOverlayForData*, FreeSpaceMap*)
+ *  Four eduom_FsmExpand(FreeSpaceMap*, ShortPageID)
+ *  Four eduom_FsmUpdate(FreeSpaceMap*, ShortPageID, Four)
+ */
+
+#include <stdlib.h>
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+Four eduom_FsmBuild(sm_CatOverlayForData *, FreeSpaceMap *);
+Four eduom_FsmExpand(FreeSpaceMap *, ShortPageID);
+Four eduom_FsmUpdate(FreeSpaceMap *, ShortPageID, Four);
+
+/* free space category of a page which has 'freeSpace' bytes of free space */
+#define FSM_CATEGORY(freeSpace) (((freeSpace) <= 0) ? 0 : (freeSpace) / FSM_UNIT)
+
+/*@================================
+ * eduom_FsmSetFreeSpace()
+ *================================*/
+/*
+ * Function: Four eduom_FsmSetFreeSpace(FileID*, ShortPageID, Four)
+ *
+ * Description :
+ *  Record the free space of the given page of the data file in the free space
+ *  map. A page which no longer belongs to the file is recorded with the free
+ *  space 0. If the map of the file has not been built yet, nothing is done;
+ *  the current free space is read when the map is built.
+ *
+ * Returns:
+ *  error code
+ *    eBADFILEID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_FsmSetFreeSpace(FileID *fid,         /* IN ID of the file */
+                           ShortPageID pageNo,  /* IN page of the file */
+                           Four freeSpace)      /* IN free space of the page */
+{
+  Four e;               /* error number */
+  eduom_FileInfo *info; /* in-memory information of the file */
+
+  e = eduom_GetFileInfo(fid, &info);
+  if (e < eNOERROR) ERR(e);
+
+  if (!info->fsm.built) return (eNOERROR);
+
+  e = eduom_FsmUpdate(&info->fsm, pageNo, freeSpace);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_FsmSetFreeSpace() */
+
+/*@================================
+ * eduom_FsmGetPage()
+ *================================*/
+/*
+ * Function: Four eduom_FsmGetPage(sm_CatOverlayForData*, Four, PageID*,
+ * SlottedPage**)
+ *
+ * Description :
+ *  Select the page of the data file with the least free space among the pages
+ *  which have room for 'neededSpace' bytes. The selected page is returned
+ *  fixed in the buffer; the caller must free it. If no page of the file has
+ *  enough room, 'pid->pageNo' is set to NIL.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter pid, apage
+ *     'pid' and 'apage' are set to the selected page
+ */
+Four eduom_FsmGetPage(
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    Four neededSpace,               /* IN space needed in the page */
+    PageID *pid,                    /* OUT selected page */
+    SlottedPage **apage)            /* OUT pointer to the buffer of the page */
+{
+  Four e;               /* error number */
+  eduom_FileInfo *info; /* in-memory information of the file */
+  FreeSpaceMap *fsm;    /* free space map of the file */
+  Four floor;           /* category whose pages may have enough room */
+  Four category;        /* smallest category having enough room */
+  Four nProbes;         /* # of pages checked in the floor category */
+  Four i;               /* index of the bitmap word */
+  UFour word;           /* masked bitmap word */
+  ShortPageID pageNo;   /* candidate page */
+
+  e = eduom_GetFileInfo(&catEntry->fid, &info);
+  if (e < eNOERROR) ERR(e);
+  fsm = &info->fsm;
+
+  // 1. Free space map이 만들어지지 않은 경우 file의 page들을 읽어 만듦
+  if (!fsm->built) {
+    e = eduom_FsmBuild(catEntry, fsm);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  // 2. 필요한 공간 이상의 자유 공간을 가질 수 있는 category 중 가장 작은
+  // category의 page를 선정함, bitmap을 사용하여 비어있지 않은 category를 찾음
+  floor = FSM_CATEGORY(neededSpace);
+  category = floor;
+
+  while (category < FSM_NUM_CATEGORIES) {
+    i = category / 32;
+    word = fsm->nonEmpty[i] & (~0U << (category % 32));
+    while (word == 0 && ++i < FSM_BITMAP_SIZE) word = fsm->nonEmpty[i];
+    if (word == 0) break;
+
+    category = i * 32 + __builtin_ctz(word);
+    pageNo = fsm->head[category];
+
+    // Floor category의 page는 필요한 공간보다 자유 공간이 작을 수 있으므로,
+    // 기록된 자유 공간이 충분한 page를 최대 FSM_FLOOR_PROBES 개까지 찾음
+    if (category == floor) {
+      for (nProbes = 1;
+           pageNo != NIL && fsm->freeSpace[pageNo] < neededSpace; nProbes++)
+        pageNo = (nProbes < FSM_FLOOR_PROBES) ? fsm->next[pageNo] : NIL;
+
+      if (pageNo == NIL) {
+        category++;
+        continue;
+      }
+    }
+
+    MAKE_PAGEID(*pid, catEntry->fid.volNo, pageNo);
+    e = BfM_GetTrain((TrainID *)pid, (char **)apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    // 3. 선정된 page가 file에 속하고 실제로 공간이 있는지 확인함
+    if (EQUAL_FILEID((*apage)->header.fid, catEntry->fid) &&
+        eduom_HasRoomInPage(pid, *apage, neededSpace))
+      return (eNOERROR);
+
+    // Free space map의 정보가 실제와 다른 경우 정보를 수정하고 다시 선정함,
+    // Pin 된 object가 있어 compact 할 수 없는 page는 다음 category에서 찾음
+    if (!EQUAL_FILEID((*apage)->header.fid, catEntry->fid))
+      e = eduom_FsmUpdate(fsm, pageNo, 0);
+    else if (SP_FREE(*apage) < neededSpace)
+      e = eduom_FsmUpdate(fsm, pageNo, SP_FREE(*apage));
+    else
+      category++;
+
+    BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  pid->pageNo = NIL;
+
+  return (eNOERROR);
+
+} /* eduom_FsmGetPage() */
+
+/*@================================
+ * eduom_FsmBuild()
+ *================================*/
+/*
+ * Function: Four eduom_FsmBuild(sm_CatOverlayForData*, FreeSpaceMap*)
+ *
+ * Description :
+ *  Build the free space map by following the list of pages of the file.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FsmBuild(sm_CatOverlayForData *catEntry, /* IN catalog entry */
+                    FreeSpaceMap *fsm)              /* INOUT free space map */
+{
+  Four e;             /* error number */
+  Four i;             /* index */
+  PageID pid;         /* page of the file */
+  SlottedPage *apage; /* pointer to the buffer of the page */
+  ShortPageID next;   /* next page of the file */
+
+  for (i = 0; i < FSM_NUM_CATEGORIES; i++) fsm->head[i] = NIL;
+  for (i = 0; i < FSM_BITMAP_SIZE; i++) fsm->nonEmpty[i] = 0;
+  for (i = 0; i < fsm->nPages; i++) fsm->category[i] = fsm->freeSpace[i] = 0;
+
+  MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+  while (pid.pageNo != NIL) {
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    e = eduom_FsmUpdate(fsm, pid.pageNo, SP_FREE(apage));
+    next = apage->header.nextPage;
+
+    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    pid.pageNo = next;
+  }
+
+  fsm->built = TRUE;
+
+  return (eNOERROR);
+
+} /* eduom_FsmBuild() */
+
+/*@================================
+ * eduom_FsmExpand()
+ *================================*/
+/*
+ * Function: Four eduom_FsmExpand(FreeSpaceMap*, ShortPageID)
+ *
+ * Description :
+ *  Expand the per-page arrays of the free space map to cover 'pageNo'.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUOM
+ */
+Four eduom_FsmExpand(FreeSpaceMap *fsm,  /* INOUT free space map */
+                     ShortPageID pageNo) /* IN page to be covered */
+{
+  Four nPages;           /* new # of entries */
+  UOne *category;        /* expanded category array */
+  Two *freeSpace;        /* expanded free space array */
+  ShortPageID *next;     /* expanded next array */
+  ShortPageID *prev;     /* expanded prev array */
+  Four i;                /* index */
+
+  nPages = MAX(fsm->nPages * 2, 1024);
+  while (nPages <= pageNo) nPages *= 2;
+
+  category = (UOne *)realloc(fsm->category, nPages * sizeof(UOne));
+  if (category == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+  fsm->category = category;
+
+  freeSpace = (Two *)realloc(fsm->freeSpace, nPages * sizeof(Two));
+  if (freeSpace == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+  fsm->freeSpace = freeSpace;
+
+  next = (ShortPageID *)realloc(fsm->next, nPages * sizeof(ShortPageID));
+  if (next == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+  fsm->next = next;
+
+  prev = (ShortPageID *)realloc(fsm->prev, nPages * sizeof(ShortPageID));
+  if (prev == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+  fsm->prev = prev;
+
+  for (i = fsm->nPages; i < nPages; i++) {
+    fsm->category[i] = 0;
+    fsm->freeSpace[i] = 0;
+    fsm->next[i] = fsm->prev[i] = NIL;
+  }
+  fsm->nPages = nPages;
+
+  return (eNOERROR);
+
+} /* eduom_FsmExpand() */
+
+/*@================================
+ * eduom_FsmUpdate()
+ *================================*/
+/*
+ * Function: Four eduom_FsmUpdate(FreeSpaceMap*, ShortPageID, Four)
+ *
+ * Description :
+ *  Record the new free space of the page and move the page to the category
+ *  of the free space. Pages of the category 0 have too little room for any
+ *  object and are not linked.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FsmUpdate(FreeSpaceMap *fsm,  /* INOUT free space map */
+                     ShortPageID pageNo, /* IN page to be updated */
+                     Four freeSpace)     /* IN free space of the page */
+{
+  Four e;           /* error number */
+  Four oldCategory; /* current category of the page */
+  Four newCategory; /* new category of the page */
+
+  if (pageNo < 0) return (eNOERROR);
+
+  if (pageNo >= fsm->nPages) {
+    e = eduom_FsmExpand(fsm, pageNo);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  fsm->freeSpace[pageNo] = MAX(freeSpace, 0);
+
+  oldCategory = fsm->category[pageNo];
+  newCategory = FSM_CATEGORY(freeSpace);
+  if (oldCategory == newCategory) return (eNOERROR);
+
+  // 1. 현재 category의 list에서 page를 삭제함
+  if (oldCategory != 0) {
+    if (fsm->prev[pageNo] != NIL)
+      fsm->next[fsm->prev[pageNo]] = fsm->next[pageNo];
+    else
+      fsm->head[oldCategory] = fsm->next[pageNo];
+
+    if (fsm->next[pageNo] != NIL)
+      fsm->prev[fsm->next[pageNo]] = fsm->prev[pageNo];
+
+    if (fsm->head[oldCategory] == NIL)
+      fsm->nonEmpty[oldCategory / 32] &= ~(1U << (oldCategory % 32));
+  }
+
+  // 2. 새로운 category의 list의 첫 번째에 page를 삽입함
+  fsm->category[pageNo] = newCategory;
+  fsm->prev[pageNo] = fsm->next[pageNo] = NIL;
+
+  if (newCategory != 0) {
+    fsm->next[pageNo] = fsm->head[newCategory];
+    if (fsm->head[newCategory] != NIL)
+      fsm->prev[fsm->head[newCategory]] = pageNo;
+    fsm->head[newCategory] = pageNo;
+    fsm->nonEmpty[newCategory / 32] |= 1U << (newCategory % 32);
+  }
+
+  return (eNOERROR);
+
+} /* eduom_FsmUpdate() */
@@ -0,0 +1,958 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_Latch.c
+ *
+ * Description :
+ *  Latches making the EduOM operations callable from many threads.
+ *
+ *  (1) File latch : a reader/writer latch for each data file, keyed by the
+ *      catalog object of the file. The operations changing the page list or
+ *      moving and destroying objects hold it in exclusive mode. The object
+ *      creations which only insert into existing pages hold it in shared
+ *      mode, and the space latch serializes their changes of the file.
+ *  (2) Page latch : a reader/writer latch for each data page. A page is
+ *      latched in shared mode while its objects are read and in exclusive
+ *      mode while they are changed or moved.
+ *  (3) Space latch : an exclusive latch for each data file, held by the
+ *      threads holding the shared file latch while they select a page or
+ *      change the available space lists, the free space map or the
+ *      insertion pages of the file. It is held only for short steps which
+ *      never wait for a page latch.
+ *  (4) Storage latch : a recursive mutex serializing the calls into the
+ *      storage layer below EduOM, which is not reentrant. It is not held
+ *      for the buffer accesses of the pages already fixed by EduOM: the
+ *      fixed page table keeps one buffer fix for each page in use, and
+ *      the fixes of such a page by other threads are counted in its entry
+ *      under the lock of its bucket only. The buffer manager is called
+ *      when the first thread fixes the page, when the page is set dirty for
+ *      the first time and when the last thread frees it. The global tables
+ *      of the EduOM modules have mutexes of their own.
+ *
+ *  The latches are always acquired in the order file latch -> page latch ->
+ *  space latch -> storage latch; a thread holding the storage latch never
+ *  waits for a file or a page latch, nor for the bucket of a fixed page. A
+ *  thread waits for a page latch while holding another one of the same file
+ *  only under the exclusive file latch: when a page is linked into or
+ *  unlinked from the list of pages of the file, the pages around it are
+ *  latched in the order of their page numbers, after the page itself. The other threads hold one page latch at a time, so the page
+ *  latches do not deadlock. A latch already held by the thread is acquired
+ *  again without waiting in the same or a weaker mode; a shared latch is
+ *  never upgraded, so a thread which will change a page must latch it in
+ *  exclusive mode first.
+ *
+ * Exports:
+ *  Four eduom_LatchFile(ObjectID*, Four)
+ *  Four eduom_UnlatchFile(ObjectID*)
+ *  Four eduom_LatchPage(PageID*, Four)
+ *  Four eduom_UnlatchPage(PageID*)
+ *  Four eduom_LatchPagePair(PageID*, PageID*)
+ *  void eduom_UnlatchPagePair(PageID*, PageID*)
+ *  Four eduom_LatchFileSpace(ObjectID*)
+ *  Four eduom_UnlatchFileSpace(ObjectID*)
+ *  void eduom_LatchStorage(void)
+ *  void eduom_UnlatchStorage(void)
+ *
+ * Internal Functions:
+ *  Four eduom_AcquireLatch(ObjectID*, Four)
+ *  Four eduom_ReleaseLatch(ObjectID*)
+ *  Four eduom_FixPage(PageID*, char**, Boolean)
+ *  Four eduom_UnfixPage(PageID*)
+ *  Four eduom_SetPageDirty(PageID*)
+ *  void eduom_InitLatches(void)
+ */
+
+#define EDUOM_LATCH_INTERNAL /* call the storage layer routines directly */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "BfM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+#include "LOT.h"
+#include "RDsM.h"
+#include "Util.h"
+
+Four eduom_AcquireLatch(ObjectID *, Four);
+Four eduom_ReleaseLatch(ObjectID *);
+Four eduom_FixPage(PageID *, char **, Boolean);
+Four eduom_UnfixPage(PageID *);
+Four eduom_SetPageDirty(PageID *);
+void eduom_InitLatches(void);
+
+/* # of buckets of the latch table */
+#define LATCH_TABLE_SIZE 1024
+
+/* max # of latches held by a thread at the same time */
+#define MAX_HELD_LATCHES 16
+
+/* # of buckets of the fixed page table */
+#define FIX_TABLE_SIZE 1024
+
+/* latch on a file or a page */
+typedef struct _eduom_Latch {
+  ObjectID key;              /* catalog object of the file, or the page */
+  pthread_rwlock_t rwlock;   /* the reader/writer lock */
+  Four users;                /* # of threads holding or waiting for it */
+  struct _eduom_Latch *next; /* next latch in the bucket */
+} eduom_Latch;
+
+/* latch held by the current thread */
+typedef struct {
+  eduom_Latch *latch; /* the latch held */
+  Four mode;          /* mode in which the latch is held */
+  Four count;         /* # of times the latch is acquired */
+} HeldLatch;
+
+/* page fixed in the buffer by EduOM */
+typedef struct _eduom_FixedPage {
+  PageID pid;                    /* the page */
+  char *buf;                     /* buffer holding the page */
+  Four count;                    /* # of fixes by the EduOM modules */
+  Boolean loading;               /* is the page being fixed in the buffer? */
+  Four error;                    /* error of the buffer manager, if any */
+  Boolean dirty;                 /* is the page set dirty? */
+  struct _eduom_FixedPage *next; /* next page in the bucket */
+} eduom_FixedPage;
+
+/* bucket of the fixed page table */
+typedef struct {
+  pthread_mutex_t mutex;  /* protects the pages of the bucket */
+  pthread_cond_t loaded;  /* signaled when a page of the bucket is fixed */
+  eduom_FixedPage *pages; /* pages of the bucket */
+} FixBucket;
+
+static pthread_once_t latchOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t storageMutex;    /* the storage latch */
+static pthread_mutex_t latchTableMutex; /* protects the latch table */
+static eduom_Latch *latchTable[LATCH_TABLE_SIZE];
+static FixBucket fixTable[FIX_TABLE_SIZE];
+
+static __thread HeldLatch heldLatches[MAX_HELD_LATCHES];
+static __thread Four nHeldLatches = 0;
+
+/* key of the latch on a page */
+#define PAGE_LATCH_KEY(key, pid) MAKE_OBJECTID(key, (pid)->volNo, (pid)->pageNo, NIL, 0)
+
+/* key of the space latch of a file, differs from the keys of the pages */
+#define SPACE_LATCH_KEY(key, catObj)                         \
+  MAKE_OBJECTID(key, (catObj)->volNo, (catObj)->pageNo, NIL, \
+                (catObj)->slotNo + 1)
+
+/* bucket of the fixed page table for the page */
+#define FIX_BUCKET(pid) \
+  (((UFour)(pid)->pageNo * 31 + (UFour)(pid)->volNo) % FIX_TABLE_SIZE)
+
+/* bucket of the latch table for the key */
+#define LATCH_BUCKET(key)                                  \
+  (((UFour)(key)->pageNo * 31 + (UFour)(key)->slotNo * 7 + \
+    (UFour)(key)->volNo) % LATCH_TABLE_SIZE)
+
+/*@================================
+ * eduom_LatchFile()
+ *================================*/
+/*
+ * Function: Four eduom_LatchFile(ObjectID*, Four)
+ *
+ * Description :
+ *  Acquire the latch on the data file in the given mode(LATCH_SHARED or
+ *  LATCH_EXCLUSIVE).
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    some errors caused by function calls
+ */
+Four eduom_LatchFile(ObjectID *catObjForFile, /* IN catalog object of file */
+                     Four mode)               /* IN latch mode */
+{
+  Four e; /* error number */
+
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  e = eduom_AcquireLatch(catObjForFile, mode);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_LatchFile() */
+
+/*@================================
+ * eduom_UnlatchFile()
+ *================================*/
+/*
+ * Function: Four eduom_UnlatchFile(ObjectID*)
+ *
+ * Description :
+ *  Release the latch on the data file.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    some errors caused by function calls
+ */
+Four eduom_UnlatchFile(ObjectID *catObjForFile) /* IN catalog object of file */
+{
+  Four e; /* error number */
+
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  e = eduom_ReleaseLatch(catObjForFile);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_UnlatchFile() */
+
+/*@================================
+ * eduom_LatchPage()
+ *================================*/
+/*
+ * Function: Four eduom_LatchPage(PageID*, Four)
+ *
+ * Description :
+ *  Acquire the latch on the page in the given mode(LATCH_SHARED or
+ *  LATCH_EXCLUSIVE).
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_LatchPage(PageID *pid, /* IN page to latch */
+                     Four mode)   /* IN latch mode */
+{
+  Four e;       /* error number */
+  ObjectID key; /* key of the latch */
+
+  PAGE_LATCH_KEY(key, pid);
+
+  e = eduom_AcquireLatch(&key, mode);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_LatchPage() */
+
+/*@================================
+ * eduom_UnlatchPage()
+ *================================*/
+/*
+ * Function: Four eduom_UnlatchPage(PageID*)
+ *
+ * Description :
+ *  Release the latch on the page.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_UnlatchPage(PageID *pid) /* IN page to unlatch */
+{
+  Four e;       /* error number */
+  ObjectID key; /* key of the latch */
+
+  PAGE_LATCH_KEY(key, pid);
+
+  e = eduom_ReleaseLatch(&key);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_UnlatchPage() */
+
+/*@================================
+ * eduom_LatchPagePair()
+ *================================*/
+/*
+ * Function: Four eduom_LatchPagePair(PageID*, PageID*)
+ *
+ * Description :
+ *  Acquire the latches on the two pages in exclusive mode, in the order of
+ *  their page numbers. A page whose page number is NIL is skipped. Used to
+ *  latch the neighbours of a page whose links are changed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_LatchPagePair(PageID *pid1, /* IN page to latch */
+                         PageID *pid2) /* IN page to latch */
+{
+  Four e;        /* error number */
+  PageID *first;  /* page latched first */
+  PageID *second; /* page latched second */
+
+  if (pid1->pageNo != NIL && pid2->pageNo != NIL &&
+      pid2->pageNo < pid1->pageNo) {
+    first = pid2;
+    second = pid1;
+  } else {
+    first = pid1;
+    second = pid2;
+  }
+
+  if (first->pageNo != NIL) {
+    e = eduom_LatchPage(first, LATCH_EXCLUSIVE);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  if (second->pageNo != NIL) {
+    e = eduom_LatchPage(second, LATCH_EXCLUSIVE);
+    if (e < eNOERROR) {
+      if (first->pageNo != NIL) eduom_UnlatchPage(first);
+      ERR(e);
+    }
+  }
+
+  return (eNOERROR);
+
+} /* eduom_LatchPagePair() */
+
+/*@================================
+ * eduom_UnlatchPagePair()
+ *================================*/
+/*
+ * Function: void eduom_UnlatchPagePair(PageID*, PageID*)
+ *
+ * Description :
+ *  Release the latches acquired by eduom_LatchPagePair().
+ *
+ * Returns:
+ *  None
+ */
+void eduom_UnlatchPagePair(PageID *pid1, /* IN page to unlatch */
+                           PageID *pid2) /* IN page to unlatch */
+{
+  if (pid1->pageNo != NIL) eduom_UnlatchPage(pid1);
+  if (pid2->pageNo != NIL) eduom_UnlatchPage(pid2);
+
+} /* eduom_UnlatchPagePair() */
+
+/*@================================
+ * eduom_LatchFileSpace()
+ *================================*/
+/*
+ * Function: Four eduom_LatchFileSpace(ObjectID*)
+ *
+ * Description :
+ *  Acquire the space latch of the data file. The caller holds the latch on
+ *  the file in shared mode and must not wait for a page latch before the
+ *  space latch is released.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    some errors caused by function calls
+ */
+Four eduom_LatchFileSpace(ObjectID *catObjForFile) /* IN catalog object */
+{
+  Four e;       /* error number */
+  ObjectID key; /* key of the latch */
+
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  SPACE_LATCH_KEY(key, catObjForFile);
+
+  e = eduom_AcquireLatch(&key, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_LatchFileSpace() */
+
+/*@================================
+ * eduom_UnlatchFileSpace()
+ *================================*/
+/*
+ * Function: Four eduom_UnlatchFileSpace(ObjectID*)
+ *
+ * Description :
+ *  Release the space latch of the data file.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    some errors caused by function calls
+ */
+Four eduom_UnlatchFileSpace(ObjectID *catObjForFile) /* IN catalog object */
+{
+  Four e;       /* error number */
+  ObjectID key; /* key of the latch */
+
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  SPACE_LATCH_KEY(key, catObjForFile);
+
+  e = eduom_ReleaseLatch(&key);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_UnlatchFileSpace() */
+
+/*@================================
+ * eduom_LatchStorage()
+ *================================*/
+/*
+ * Function: void eduom_LatchStorage(void)
+ *
+ * Description :
+ *  Acquire the storage latch. The latch is recursive.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_LatchStorage(void)
+{
+  pthread_once(&latchOnce, eduom_InitLatches);
+  pthread_mutex_lock(&storageMutex);
+
+} /* eduom_LatchStorage() */
+
+/*@================================
+ * eduom_UnlatchStorage()
+ *================================*/
+/*
+ * Function: void eduom_UnlatchStorage(void)
+ *
+ * Description :
+ *  Release the storage latch.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_UnlatchStorage(void)
+{
+  pthread_mutex_unlock(&storageMutex);
+
+} /* eduom_UnlatchStorage() */
+
+/*@================================
+ * eduom_AcquireLatch()
+ *================================*/
+/*
+ * Function: Four eduom_AcquireLatch(ObjectID*, Four)
+ *
+ * Description :
+ *  Acquire the latch with the given key in the given mode. The latch is
+ *  created when no thread holds or waits for it, and is freed again by
+ *  eduom_ReleaseLatch() when the last such thread releases it, so that the
+ *  latch table keeps only the latches in use. If the current thread already
+ *  holds the latch, only its count is increased; a shared latch cannot be
+ *  acquired again in exclusive mode, since waiting for the other readers
+ *  while holding it deadlocks with any of them doing the same.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eMEMORYALLOCERR_EDUOM
+ *    eLATCHUPGRADE_EDUOM
+ */
+Four eduom_AcquireLatch(ObjectID *key, /* IN key of the latch */
+                        Four mode)     /* IN latch mode */
+{
+  Four i;             /* index */
+  Four bucket;        /* bucket of the latch table */
+  eduom_Latch *latch; /* the latch */
+
+  if (mode != LATCH_SHARED && mode != LATCH_EXCLUSIVE) ERR(eBADPARAMETER_OM);
+
+  pthread_once(&latchOnce, eduom_InitLatches);
+
+  // 1. 현재 thread가 이미 latch를 가지고 있는 경우, count만 증가시킴
+  // Shared mode로 가진 latch를 exclusive mode로 다시 획득할 수 없음
+  for (i = 0; i < nHeldLatches; i++) {
+    if (EQUAL_OBJECTID(heldLatches[i].latch->key, *key)) {
+      if (mode == LATCH_EXCLUSIVE && heldLatches[i].mode == LATCH_SHARED)
+        ERR(eLATCHUPGRADE_EDUOM);
+      heldLatches[i].count++;
+      return (eNOERROR);
+    }
+  }
+
+  if (nHeldLatches == MAX_HELD_LATCHES) ERR(eBADPARAMETER_OM);
+
+  // 2. Latch table에서 latch를 탐색하고, 없는 경우 새로운 latch를 만듦
+  // Latch를 기다리는 동안 latch가 해제되지 않도록 사용자 수를 증가시킴
+  bucket = LATCH_BUCKET(key);
+
+  pthread_mutex_lock(&latchTableMutex);
+  for (latch = latchTable[bucket]; latch != NULL; latch = latch->next) {
+    if (EQUAL_OBJECTID(latch->key, *key)) break;
+  }
+
+  if (latch == NULL) {
+    latch = (eduom_Latch *)malloc(sizeof(eduom_Latch));
+    if (latch == NULL) {
+      pthread_mutex_unlock(&latchTableMutex);
+      ERR(eMEMORYALLOCERR_EDUOM);
+    }
+
+    latch->key = *key;
+    pthread_rwlock_init(&(latch->rwlock), NULL);
+    latch->users = 0;
+    latch->next = latchTable[bucket];
+    latchTable[bucket] = latch;
+  }
+  latch->users++;
+  pthread_mutex_unlock(&latchTableMutex);
+
+  // 3. Latch를 주어진 mode로 획득함
+  if (mode == LATCH_SHARED)
+    pthread_rwlock_rdlock(&(latch->rwlock));
+  else
+    pthread_rwlock_wrlock(&(latch->rwlock));
+
+  heldLatches[nHeldLatches].latch = latch;
+  heldLatches[nHeldLatches].mode = mode;
+  heldLatches[nHeldLatches].count = 1;
+  nHeldLatches++;
+
+  return (eNOERROR);
+
+} /* eduom_AcquireLatch() */
+
+/*@================================
+ * eduom_ReleaseLatch()
+ *================================*/
+/*
+ * Function: Four eduom_ReleaseLatch(ObjectID*)
+ *
+ * Description :
+ *  Release the latch with the given key held by the current thread. The
+ *  latch is released when it is released as many times as it is acquired;
+ *  it is then removed from the latch table and freed if no other thread
+ *  holds or waits for it.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four eduom_ReleaseLatch(ObjectID *key) /* IN key of the latch */
+{
+  Four i;             /* index */
+  eduom_Latch *latch; /* the latch */
+  eduom_Latch **prev; /* link to the latch in the bucket */
+
+  for (i = 0; i < nHeldLatches; i++) {
+    if (EQUAL_OBJECTID(heldLatches[i].latch->key, *key)) break;
+  }
+
+  if (i == nHeldLatches) ERR(eBADPARAMETER_OM);
+
+  if (--heldLatches[i].count == 0) {
+    latch = heldLatches[i].latch;
+    heldLatches[i] = heldLatches[--nHeldLatches];
+    pthread_rwlock_unlock(&(latch->rwlock));
+
+    // 사용하는 thread가 없는 latch는 latch table에서 삭제하고 해제함
+    pthread_mutex_lock(&latchTableMutex);
+    if (--latch->users == 0) {
+      for (prev = &latchTable[LATCH_BUCKET(&latch->key)]; *prev != latch;
+           prev = &((*prev)->next))
+        ;
+      *prev = latch->next;
+      pthread_rwlock_destroy(&(latch->rwlock));
+      free(latch);
+    }
+    pthread_mutex_unlock(&latchTableMutex);
+  }
+
+  return (eNOERROR);
+
+} /* eduom_ReleaseLatch() */
+
+/*@================================
+ * eduom_FixPage()
+ *================================*/
+/*
+ * Function: Four eduom_FixPage(PageID*, char**, Boolean)
+ *
+ * Description :
+ *  Fix the page in the buffer through the fixed page table. If the page is
+ *  already fixed by EduOM, only the count of its entry is increased under
+ *  the lock of the bucket; a thread arriving while the first thread is
+ *  still reading the page waits for it. Otherwise a new entry is made and
+ *  the buffer manager is called under the storage latch, without holding
+ *  the lock of the bucket. If 'isNew' is TRUE, the page is fixed by
+ *  BfM_GetNewTrain() without being read from the disk.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter retBuf
+ *     'retBuf' points to the buffer holding the page
+ */
+Four eduom_FixPage(PageID *pid,   /* IN page to fix */
+                   char **retBuf, /* OUT buffer holding the page */
+                   Boolean isNew) /* IN is the page newly allocated? */
+{
+  Four e;                /* error number */
+  FixBucket *bucket;     /* bucket of the page */
+  eduom_FixedPage *page; /* entry of the page */
+  eduom_FixedPage **prev; /* link to the entry in the bucket */
+
+  pthread_once(&latchOnce, eduom_InitLatches);
+
+  bucket = &fixTable[FIX_BUCKET(pid)];
+
+  // 1. 이미 fix 된 page인 경우, fix 횟수만 증가시킴
+  // 다른 thread가 page를 읽고 있는 경우, 읽기가 끝날 때까지 기다림
+  pthread_mutex_lock(&(bucket->mutex));
+  for (page = bucket->pages; page != NULL; page = page->next) {
+    if (EQUAL_PAGEID(page->pid, *pid)) break;
+  }
+
+  if (page != NULL) {
+    page->count++;
+    while (page->loading) pthread_cond_wait(&(bucket->loaded), &(bucket->mutex));
+    *retBuf = page->buf;
+    e = page->error;
+  } else {
+    // 2. 처음 fix 되는 page인 경우, 새로운 entry를 만든 후 storage latch를
+    // 가지고 buffer manager를 호출함
+    page = (eduom_FixedPage *)malloc(sizeof(eduom_FixedPage));
+    if (page == NULL) {
+      pthread_mutex_unlock(&(bucket->mutex));
+      ERR(eMEMORYALLOCERR_EDUOM);
+    }
+
+    page->pid = *pid;
+    page->buf = NULL;
+    page->count = 1;
+    page->loading = TRUE;
+    page->error = eNOERROR;
+    page->dirty = FALSE;
+    page->next = bucket->pages;
+    bucket->pages = page;
+    pthread_mutex_unlock(&(bucket->mutex));
+
+    eduom_LatchStorage();
+    if (isNew)
+      e = BfM_GetNewTrain((TrainID *)pid, retBuf, PAGE_BUF);
+    else
+      e = BfM_GetTrain((TrainID *)pid, retBuf, PAGE_BUF);
+    eduom_UnlatchStorage();
+
+    pthread_mutex_lock(&(bucket->mutex));
+    page->loading = FALSE;
+    page->buf = *retBuf;
+    page->error = e;
+    pthread_cond_broadcast(&(bucket->loaded));
+  }
+
+  // 3. Page를 fix 하지 못한 경우, 기다린 thread가 모두 실패한 후 entry를
+  // 삭제함
+  if (e < eNOERROR && --page->count == 0) {
+    for (prev = &(bucket->pages); *prev != page; prev = &((*prev)->next))
+      ;
+    *prev = page->next;
+    free(page);
+  }
+  pthread_mutex_unlock(&(bucket->mutex));
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_FixPage() */
+
+/*@================================
+ * eduom_UnfixPage()
+ *================================*/
+/*
+ * Function: Four eduom_UnfixPage(PageID*)
+ *
+ * Description :
+ *  Free a fix of the page got by eduom_FixPage(). When the last fix is
+ *  freed, the entry is deleted and the buffer manager frees the page under
+ *  the storage latch, setting it dirty again if it has been set dirty, so
+ *  that the changes made after a flush of the page are written as well.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_UnfixPage(PageID *pid) /* IN page to free */
+{
+  Four e;                 /* error number */
+  FixBucket *bucket;      /* bucket of the page */
+  eduom_FixedPage *page;  /* entry of the page */
+  eduom_FixedPage **prev; /* link to the entry in the bucket */
+  Boolean dirty;          /* is the page set dirty? */
+
+  pthread_once(&latchOnce, eduom_InitLatches);
+
+  bucket = &fixTable[FIX_BUCKET(pid)];
+
+  pthread_mutex_lock(&(bucket->mutex));
+  for (prev = &(bucket->pages); *prev != NULL; prev = &((*prev)->next)) {
+    if (EQUAL_PAGEID((*prev)->pid, *pid)) break;
+  }
+  page = *prev;
+
+  // Fixed page table에 없는 page는 buffer manager가 직접 free 함
+  dirty = FALSE;
+  if (page != NULL) {
+    if (--page->count > 0) {
+      pthread_mutex_unlock(&(bucket->mutex));
+      return (eNOERROR);
+    }
+
+    *prev = page->next;
+    dirty = page->dirty;
+    free(page);
+  }
+  pthread_mutex_unlock(&(bucket->mutex));
+
+  eduom_LatchStorage();
+  e = (dirty) ? BfM_SetDirty((TrainID *)pid, PAGE_BUF) : eNOERROR;
+  if (e >= eNOERROR) e = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+  eduom_UnlatchStorage();
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_UnfixPage() */
+
+/*@================================
+ * eduom_SetPageDirty()
+ *================================*/
+/*
+ * Function: Four eduom_SetPageDirty(PageID*)
+ *
+ * Description :
+ *  Set the page fixed by eduom_FixPage() dirty. The buffer manager is
+ *  called only when the page is set dirty for the first time while it is
+ *  fixed; eduom_UnfixPage() sets it dirty again when it is freed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_SetPageDirty(PageID *pid) /* IN page to set dirty */
+{
+  Four e;                /* error number */
+  FixBucket *bucket;     /* bucket of the page */
+  eduom_FixedPage *page; /* entry of the page */
+
+  pthread_once(&latchOnce, eduom_InitLatches);
+
+  bucket = &fixTable[FIX_BUCKET(pid)];
+
+  pthread_mutex_lock(&(bucket->mutex));
+  for (page = bucket->pages; page != NULL; page = page->next) {
+    if (EQUAL_PAGEID(page->pid, *pid)) break;
+  }
+
+  if (page != NULL && page->dirty) {
+    pthread_mutex_unlock(&(bucket->mutex));
+    return (eNOERROR);
+  }
+
+  if (page != NULL) page->dirty = TRUE;
+  pthread_mutex_unlock(&(bucket->mutex));
+
+  eduom_LatchStorage();
+  e = BfM_SetDirty((TrainID *)pid, PAGE_BUF);
+  eduom_UnlatchStorage();
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_SetPageDirty() */
+
+/*@================================
+ * eduom_InitLatches()
+ *================================*/
+/*
+ * Function: void eduom_InitLatches(void)
+ *
+ * Description :
+ *  Initialize the storage latch, the latch table and the fixed page table.
+ *  Called once.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_InitLatches(void)
+{
+  pthread_mutexattr_t attr; /* attributes of the storage latch */
+  Four i;                   /* index */
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&storageMutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+
+  pthread_mutex_init(&latchTableMutex, NULL);
+
+  for (i = 0; i < FIX_TABLE_SIZE; i++) {
+    pthread_mutex_init(&(fixTable[i].mutex), NULL);
+    pthread_cond_init(&(fixTable[i].loaded), NULL);
+    fixTable[i].pages = NULL;
+  }
+
+} /* eduom_InitLatches() */
+
+/*@================================
+ * Storage layer calls
+ *================================*/
+/*
+ * The following functions call the routines of the storage layer with the
+ * same name holding the storage latch. EduOM_Internal.h redirects the calls
+ * of the EduOM modules to them. The page buffers go through the fixed page
+ * table instead, which calls the buffer manager only when needed. The
+ * buffer fixes and the page allocations are counted in the statistics of
+ * the current thread.
+ */
+#define CALL_WITH_STORAGE_LATCH(call) \
+  {                                   \
+    Four e;                           \
+    eduom_LatchStorage();             \
+    e = (call);                       \
+    eduom_UnlatchStorage();           \
+    return (e);                       \
+  }
+
+#define CALL_WITH_STORAGE_LATCH_COUNTED(call, counter, n)      \
+  {                                                            \
+    Four e;                                                    \
+    EduOM_Stats *stats;                                        \
+    eduom_LatchStorage();                                      \
+    e = (call);                                                \
+    eduom_UnlatchStorage();                                    \
+    stats = eduom_GetThreadStats(NULL);                        \
+    if (e >= eNOERROR && stats != NULL) stats->counter += (n); \
+    return (e);                                                \
+  }
+
+/* call on a page buffer through the fixed page table, counted */
+#define CALL_FIXED_PAGE_COUNTED(call, counter)               \
+  {                                                          \
+    Four e;                                                  \
+    EduOM_Stats *stats;                                      \
+    e = (call);                                              \
+    stats = eduom_GetThreadStats(NULL);                      \
+    if (e >= eNOERROR && stats != NULL) stats->counter += 1; \
+    return (e);                                              \
+  }
+
+Four eduom_BfM_GetTrain(TrainID *trainId, char **retBuf, Four type)
+{
+  if (type == PAGE_BUF)
+    CALL_FIXED_PAGE_COUNTED(eduom_FixPage((PageID *)trainId, retBuf, FALSE),
+                            bufferFixes)
+  else
+    CALL_WITH_STORAGE_LATCH_COUNTED(BfM_GetTrain(trainId, retBuf, type),
+                                    bufferFixes, 1)
+}
+
+Four eduom_BfM_GetNewTrain(TrainID *trainId, char **retBuf, Four type)
+{
+  if (type == PAGE_BUF)
+    CALL_FIXED_PAGE_COUNTED(eduom_FixPage((PageID *)trainId, retBuf, TRUE),
+                            bufferFixes)
+  else
+    CALL_WITH_STORAGE_LATCH_COUNTED(BfM_GetNewTrain(trainId, retBuf, type),
+                                    bufferFixes, 1)
+}
+
+Four eduom_BfM_FreeTrain(TrainID *trainId, Four type)
+{
+  if (type == PAGE_BUF)
+    CALL_FIXED_PAGE_COUNTED(eduom_UnfixPage((PageID *)trainId), bufferUnfixes)
+  else
+    CALL_WITH_STORAGE_LATCH_COUNTED(BfM_FreeTrain(trainId, type),
+                                    bufferUnfixes, 1)
+}
+
+Four eduom_BfM_SetDirty(TrainID *trainId, Four type)
+{
+  if (type == PAGE_BUF)
+    return (eduom_SetPageDirty((PageID *)trainId));
+  else
+    CALL_WITH_STORAGE_LATCH(BfM_SetDirty(trainId, type))
+}
+
+Four eduom_RDsM_AllocTrains(Four volNo, Four firstExtNo, PageID *nearPid,
+                            Two eff, Four numOfTrains, Two sizeOfTrain,
+                            PageID *pageIds)
+    CALL_WITH_STORAGE_LATCH_COUNTED(RDsM_AllocTrains(volNo, firstExtNo, nearPid,
+                                                     eff, numOfTrains,
+                                                     sizeOfTrain, pageIds),
+                                    pagesAllocated, numOfTrains)
+
+Four eduom_RDsM_GetUnique(PageID *pid, Unique *unique, Four *nums)
+    CALL_WITH_STORAGE_LATCH(RDsM_GetUnique(pid, unique, nums))
+
+Four eduom_RDsM_PageIdToExtNo(PageID *pid, Four *extNo)
+    CALL_WITH_STORAGE_LATCH(RDsM_PageIdToExtNo(pid, extNo))
+
+Four eduom_LOT_DestroyObject(PageID *pid, Two slotNo, Pool *dlPool,
+                             DeallocListElem *dlHead)
+    CALL_WITH_STORAGE_LATCH(LOT_DestroyObject(pid, slotNo, dlPool, dlHead))
+
+Four eduom_LOT_GetLengthWithHdr(Object *obj)
+    CALL_WITH_STORAGE_LATCH(LOT_GetLengthWithHdr(obj))
+
+Four eduom_LOT_ReadObject(PageID *pid, Two slotNo, Four start, Four length,
+                          char *buf)
+    CALL_WITH_STORAGE_LATCH(LOT_ReadObject(pid, slotNo, start, length, buf))
+
+Four eduom_LOT_WriteObject(PageID *pid, Two slotNo, Four start, Four length,
+                           char *buf)
+    CALL_WITH_STORAGE_LATCH(LOT_WriteObject(pid, slotNo, start, length, buf))
+
+Four eduom_OM_AppendToObject(ObjectID *catObjForFile, ObjectID *oid,
+                             Four length, char *data, Pool *dlPool,
+                             DeallocListElem *dlHead)
+    CALL_WITH_STORAGE_LATCH(OM_AppendToObject(catObjForFile, oid, length, data,
+                                              dlPool, dlHead))
+
+Four eduom_om_FileMapAddPage(ObjectID *catObjForFile, PageID *prevPid,
+                             PageID *newPid)
+    CALL_WITH_STORAGE_LATCH(om_FileMapAddPage(catObjForFile, prevPid, newPid))
+
+Four eduom_om_FileMapDeletePage(ObjectID *catObjForFile, PageID *pid)
+    CALL_WITH_STORAGE_LATCH(om_FileMapDeletePage(catObjForFile, pid))
+
+Four eduom_om_GetUnique(PageID *pid, Unique *unique)
+    CALL_WITH_STORAGE_LATCH(om_GetUnique(pid, unique))
+
+Four eduom_om_IsTemporary(FileID *fid, Boolean *isTmp)
+    CALL_WITH_STORAGE_LATCH(om_IsTemporary(fid, isTmp))
+
+Four eduom_om_PutInAvailSpaceList(ObjectID *catObjForFile, PageID *pid,
+                                  SlottedPage *apage)
+    CALL_WITH_STORAGE_LATCH(om_PutInAvailSpaceList(catObjForFile, pid, apage))
+
+Four eduom_om_RemoveFromAvailSpaceList(ObjectID *catObjForFile, PageID *pid,
+                                       SlottedPage *apage)
+    CALL_WITH_STORAGE_LATCH(om_RemoveFromAvailSpaceList(catObjForFile, pid,
+                                                        apage))
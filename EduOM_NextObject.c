@@ -30,6 +30,9 @@
  *
  * Export:
  *  Four EduOM_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*)
+ *
+ * Internal Functions:
+ *  Four eduom_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*)
  */
 
 #include "BfM.h"
@@ -69,16 +72,48 @@ Four EduOM_NextObject(
     ObjectID *nextOID,       /* OUT the next Object of a current Object */
     ObjectHdr *objHdr)       /* OUT the object header of next object */
 {
-  Four e;               /* error */
-  Two i;                /* index */
-  Four offset;          /* starting offset of object within a page */
-  PageID pid;           /* a page identifier */
-  PageNo pageNo;        /* a temporary var for next page's PageNo */
-  SlottedPage *apage;   /* a pointer to the data page */
-  Object *obj;          /* a pointer to the Object */
-  PhysicalFileID pFid;  /* file in which the objects are located */
-  SlottedPage *catPage; /* buffer page containing the catalog object */
-  sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
+  Four e;                  /* error number */
+  struct timespec opStart; /* time when the operation starts */
+
+  eduom_StatsStartOp(&opStart);
+  e = eduom_NextObject(catObjForFile, curOID, nextOID, objHdr);
+  eduom_StatsEndOp(catObjForFile, STATS_OP_NEXT, &opStart);
+
+  return (e);
+
+} /* EduOM_NextObject() */
+
+/*@================================
+ * eduom_NextObject()
+ *================================*/
+/*
+ * Function: Four eduom_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*)
+ *
+ * Description :
+ *  Find the next object of the current object for EduOM_NextObject().
+ *  Empty slots and the bodies of moved objects(forwarded objects) are
+ *  skipped, so that each object is returned once through its stub.
+ *
+ * Returns:
+ *  EOS if there is no next object
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_NextObject(
+    ObjectID *catObjForFile, /* IN informations about a data file */
+    ObjectID *curOID,        /* IN a ObjectID of the current Object */
+    ObjectID *nextOID,       /* OUT the next Object of a current Object */
+    ObjectHdr *objHdr)       /* OUT the object header of next object */
+{
+  Four e;                    /* error */
+  Two i;                     /* index */
+  PageID pid;                /* a page identifier */
+  PageNo pageNo;             /* a temporary var for next page's PageNo */
+  SlottedPage *apage;        /* a pointer to the data page */
+  Object *obj;               /* a pointer to the Object */
+  eduom_CatalogDesc catDesc; /* cached catalog information of the file */
 
   /*@
    * parameter checking
@@ -89,63 +124,69 @@ Four EduOM_NextObject(
 
   // 현재 object의 다음 object의 ID를 반환함
 
-  BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
-  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
-  MAKE_PAGEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+  // File의 첫 번째 및 마지막 page는 cache 된 catalog 정보에서 읽음
+  e = eduom_GetCatalogDesc(catObjForFile, &catDesc);
+  if (e < eNOERROR) ERR(e);
 
-  // 1. 파라미터로 주어진 curOID가 NULL 인 경우,
-  // File의 첫 번째 page의 slot array 상에서의 첫 번째 object의 ID를 반환함
+  // 1. 파라미터로 주어진 curOID가 NULL 인 경우, file의 첫 번째 page의 첫 번째
+  // slot부터 탐색함
+  // 파라미터로 주어진 curOID가 NULL 이 아닌 경우, curOID의 다음 slot부터
+  // 탐색함
   if (curOID == NULL) {
-    pageNo = catEntry->firstPage;
+    MAKE_PAGEID(pid, catDesc.fid.volNo, catDesc.firstPage);
+    i = 0;
+  } else {
+    MAKE_PAGEID(pid, curOID->volNo, curOID->pageNo);
+    i = curOID->slotNo + 1;
+  }
 
-    MAKE_PAGEID(pid, pFid.volNo, pageNo);
-    BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  for (;;) {
+    e = eduom_LatchPage(&pid, LATCH_SHARED);
+    if (e < eNOERROR) ERR(e);
 
-    nextOID->volNo = pid.volNo;
-    nextOID->pageNo = pageNo;
-    nextOID->slotNo = 0;
-    nextOID->unique = apage->slot[0].unique;
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) {
+      eduom_UnlatchPage(&pid);
+      ERR(e);
+    }
 
-    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-  } else {
-    // 2. 파라미터로 주어진 curOID가 NULL 이 아닌 경우,
-    // curOID에 대응하는 object를 탐색함
-    MAKE_PAGEID(pid, curOID->volNo, curOID->pageNo);
-    BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-
-    // Slot array 상에서, 탐색한 object의 다음 object의 ID를 반환함
-    // 탐색한 object가 page의 마지막 object인 경우, 다음 page의 첫 번째 object의
-    // ID를 반환함
-    // 탐색한 object가 file의 마지막 page의 마지막 object인 경우, EOS (End Of
-    // Scan) 를 반환함
-    if (curOID->slotNo + 1 != apage->header.nSlots) {
-      nextOID->volNo = curOID->volNo;
-      nextOID->pageNo = curOID->pageNo;
-      nextOID->slotNo = curOID->slotNo + 1;
-      nextOID->unique = apage->slot[(nextOID->slotNo) * -1].unique;
-
-      BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-    } else {
-      if (catEntry->lastPage == apage->header.pid.pageNo) {
-        BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-        BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
-        return (EOS);
+    // 2. Slot array 상에서 scan 대상인 다음 object를 탐색함
+    // 빈 slot과 이동된 object의 forwarded object는 건너뜀
+    for (; i < apage->header.nSlots; i++) {
+      if (IS_SCANNED_SLOT(apage, i)) break;
+    }
+
+    if (i < apage->header.nSlots) {
+      nextOID->volNo = pid.volNo;
+      nextOID->pageNo = pid.pageNo;
+      nextOID->slotNo = i;
+      nextOID->unique = apage->slot[-i].unique;
+
+      if (objHdr != NULL) {
+        obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+        *objHdr = obj->header;
       }
-      pageNo = apage->header.nextPage;
 
-      BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-      MAKE_PAGEID(pid, curOID->volNo, pageNo);
-      BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+      e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+      eduom_UnlatchPage(&pid);
+      if (e < eNOERROR) ERR(e);
 
-      nextOID->volNo = curOID->volNo;
-      nextOID->pageNo = pageNo;
-      nextOID->slotNo = 0;
-      nextOID->unique = apage->slot[0].unique;
-      BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+      return (eNOERROR);
     }
-  }
 
-  BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
-  return (EOS); /* end of scan */
+    // 3. 탐색한 page가 file의 마지막 page인 경우, EOS (End Of Scan) 를
+    // 반환함
+    // 그렇지 않은 경우, 다음 page의 첫 번째 slot부터 탐색함
+    pageNo = (pid.pageNo == catDesc.lastPage) ? NIL : apage->header.nextPage;
 
-} /* EduOM_NextObject() */
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    eduom_UnlatchPage(&pid);
+    if (e < eNOERROR) ERR(e);
+
+    if (pageNo == NIL) return (EOS); /* end of scan */
+
+    pid.pageNo = pageNo;
+    i = 0;
+  }
+
+} /* eduom_NextObject() */
@@ -0,0 +1,272 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_PageScan.c
+ *
+ * Description:
+ *  Page-at-a-time scan of a data file. Each data page is fixed once and all
+ *  of its objects are returned in a batch.
+ *
+ * Exports:
+ *  Four EduOM_OpenPageScan(ObjectID*, PageScanInfo*)
+ *  Four EduOM_NextPageObjects(PageScanInfo*, ObjectBatchEntry*, Four, Four*)
+ *  Four EduOM_ClosePageScan(PageScanInfo*)
+ */
+
+#include "BfM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+Four eduom_ReleaseScanPage(PageScanInfo *);
+
+/*@================================
+ * EduOM_OpenPageScan()
+ *================================*/
+/*
+ * Function: Four EduOM_OpenPageScan(ObjectID*, PageScanInfo*)
+ *
+ * Description:
+ *  Open a page-at-a-time scan on the given data file. The scan starts from
+ *  the first page of the file.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter scan
+ *     scan is initialized to hold the state of the scan
+ */
+Four EduOM_OpenPageScan(
+    ObjectID *catObjForFile, /* IN informations about a data file */
+    PageScanInfo *scan)      /* OUT state of the scan */
+{
+  Four e;                     /* error */
+  eduom_CatalogDesc catDesc;  /* cached catalog information of the file */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (scan == NULL) ERR(eBADPARAMETER_OM);
+
+  // File의 첫 번째 page에서 scan을 시작하도록 초기화함
+  e = eduom_GetCatalogDesc(catObjForFile, &catDesc);
+  if (e < eNOERROR) ERR(e);
+
+  scan->catObjForFile = *catObjForFile;
+  MAKE_PAGEID(scan->pid, catDesc.fid.volNo, catDesc.firstPage);
+  scan->apage = NULL;
+  scan->nextSlot = 0;
+  eduom_InitReadahead(&(scan->ra));
+
+  return (eNOERROR);
+
+} /* EduOM_OpenPageScan() */
+
+/*@================================
+ * EduOM_NextPageObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_NextPageObjects(PageScanInfo*, ObjectBatchEntry*, Four,
+ * Four*)
+ *
+ * Description:
+ *  Return the next objects of the scan in 'batch', at most 'batchSize' of
+ *  them, all from the same page. The page is fixed once and kept fixed
+ *  until all of its objects are returned; then the scan follows the
+ *  'nextPage' link of the page. The 'data' pointers in the batch point into
+ *  the buffer frame and stay valid only until the next call on the scan or
+ *  EduOM_ClosePageScan(); the objects of the page are not moved by the page
+ *  compaction in the meantime. The slot array is read holding the page
+ *  latch in shared mode. Empty slots are skipped. The pages following
+ *  the current page are read ahead into the buffer pool.
+ *
+ * Returns:
+ *  1) error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *  2) EOS (End Of Scan) if there are no more objects
+ *
+ * Side effect:
+ *  1) parameter batch
+ *     batch[0 .. *nEntries-1] are filled with the next objects
+ *  2) parameter nEntries
+ *     nEntries is set to the number of objects returned
+ */
+Four EduOM_NextPageObjects(
+    PageScanInfo *scan,      /* INOUT state of the scan */
+    ObjectBatchEntry *batch, /* OUT the next objects */
+    Four batchSize,          /* IN maximum number of objects to return */
+    Four *nEntries)          /* OUT number of objects returned */
+{
+  Four e;               /* error */
+  Two i;                /* index */
+  Object *obj;          /* a pointer to the Object */
+  SlottedPage *apage;   /* a pointer to the data page */
+  ShortPageID nextPage; /* next page of the current page */
+  Boolean newPage;      /* is the page fixed by this call? */
+
+  /*@ parameter checking */
+  if (scan == NULL || batch == NULL || nEntries == NULL || batchSize <= 0)
+    ERR(eBADPARAMETER_OM);
+
+  *nEntries = 0;
+
+  while (scan->pid.pageNo != NIL) {
+    // 1. 현재 page를 shared mode로 latch 함, page가 fix 되어 있지 않은 경우
+    // page를 fix 하고 pin 함
+    // Compaction은 page를 exclusive mode로 latch 하므로, pin 하기 전에
+    // 시작된 compaction이 끝난 후에 slot array를 읽음
+    e = eduom_LatchPage(&(scan->pid), LATCH_SHARED);
+    if (e < eNOERROR) ERR(e);
+
+    newPage = (scan->apage == NULL);
+    if (newPage) {
+      e = BfM_GetTrain((TrainID *)&(scan->pid), (char **)&(scan->apage),
+                       PAGE_BUF);
+      if (e < eNOERROR) {
+        eduom_UnlatchPage(&(scan->pid));
+        scan->apage = NULL;
+        ERR(e);
+      }
+
+      e = eduom_PinPage(&(scan->pid), NIL);
+      if (e < eNOERROR) {
+        BfM_FreeTrain((TrainID *)&(scan->pid), PAGE_BUF);
+        eduom_UnlatchPage(&(scan->pid));
+        scan->apage = NULL;
+        ERR(e);
+      }
+
+      scan->nextSlot = 0;
+    }
+    apage = scan->apage;
+
+    // 2. 현재 page의 slot array를 차례로 탐색하여 batch를 채움
+    for (i = scan->nextSlot;
+         i < apage->header.nSlots && *nEntries < batchSize; i++) {
+      if (!IS_SCANNED_SLOT(apage, i)) continue;
+
+      obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+
+      MAKE_OBJECTID(batch[*nEntries].oid, scan->pid.volNo, scan->pid.pageNo,
+                    i, apage->slot[-i].unique);
+      batch[*nEntries].objHdr = obj->header;
+      batch[*nEntries].length = obj->header.length;
+      batch[*nEntries].data =
+          (obj->header.properties & (P_LRGOBJ | P_MOVED)) ? NULL : obj->data;
+      (*nEntries)++;
+    }
+    scan->nextSlot = i;
+    nextPage = apage->header.nextPage;
+
+    eduom_UnlatchPage(&(scan->pid));
+
+    // 다음 page들을 buffer pool로 미리 읽어 들임
+    if (newPage) {
+      e = eduom_Readahead(&(scan->ra), &(scan->pid), apage, NIL);
+      if (e < eNOERROR) ERR(e);
+    }
+
+    if (*nEntries > 0) return (eNOERROR);
+
+    // 3. 현재 page의 모든 object를 반환한 경우, 현재 page를 unfix 하고 다음
+    // page로 이동함
+    e = eduom_ReleaseScanPage(scan);
+    if (e < eNOERROR) ERR(e);
+
+    scan->pid.pageNo = nextPage;
+  }
+
+  return (EOS); /* end of scan */
+
+} /* EduOM_NextPageObjects() */
+
+/*@================================
+ * EduOM_ClosePageScan()
+ *================================*/
+/*
+ * Function: Four EduOM_ClosePageScan(PageScanInfo*)
+ *
+ * Description:
+ *  Close the page-at-a-time scan, releasing the page fixed by the scan. The
+ *  pages requested to be read ahead of the scan are waited for.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_ClosePageScan(PageScanInfo *scan) /* INOUT state of the scan */
+{
+  Four e; /* error */
+
+  /*@ parameter checking */
+  if (scan == NULL) ERR(eBADPARAMETER_OM);
+
+  e = eduom_ReleaseScanPage(scan);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_FinalReadahead(&(scan->ra));
+  if (e < eNOERROR) ERR(e);
+
+  scan->pid.pageNo = NIL;
+
+  return (eNOERROR);
+
+} /* EduOM_ClosePageScan() */
+
+/*@================================
+ * eduom_ReleaseScanPage()
+ *================================*/
+/*
+ * Function: Four eduom_ReleaseScanPage(PageScanInfo*)
+ *
+ * Description:
+ *  Unpin and free the page fixed by the scan, if any.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_ReleaseScanPage(PageScanInfo *scan) /* INOUT state of the scan */
+{
+  Four e; /* error */
+
+  if (scan->apage == NULL) return (eNOERROR);
+
+  scan->apage = NULL;
+
+  e = eduom_UnpinPage(&(scan->pid), NIL);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)&(scan->pid), PAGE_BUF);
+
+  e = BfM_FreeTrain((TrainID *)&(scan->pid), PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_ReleaseScanPage() */
@@ -0,0 +1,496 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_Partition.c
+ *
+ * Description :
+ *  Partitioned placement of new objects. When the placement policy of a data
+ *  file is PLACEMENT_PARTITIONED, each thread inserts into its own insertion
+ *  page of the file instead of the first page of an available space list or
+ *  the last page, which every inserter would otherwise converge on.
+ *
+ *  A thread gets a free partition number the first time it inserts, and the
+ *  in-memory information of a file keeps the insertion page of each
+ *  partition. The number is freed when the thread exits and is given to the
+ *  next thread. While all the numbers are taken, a thread has no partition
+ *  and inserts into the best-fit page of the free space map without owning
+ *  it; it gets a number as soon as one is freed. The insertion pages left by
+ *  the exited threads whose numbers are still free are put back into the
+ *  available space lists by the next insertion which selects a page under
+ *  the exclusive latch on the file. The insertion pages are kept out of the available space lists
+ *  and recorded with no free space in the free space map while they are
+ *  owned. When the insertion page of a thread has no room, it is put back
+ *  into the available space lists and the free space map, and the thread
+ *  takes the best-fit page of the free space map, or a new page if there is
+ *  none, as its next insertion page. The insertion pages are accessed
+ *  holding the exclusive latch on the file, or the shared latch and the
+ *  space latch of the file.
+ *
+ * Exports:
+ *  Four eduom_GetPartitionPage(ObjectID*, sm_CatOverlayForData*, Four,
+ * PageID*, SlottedPage**)
+ *  Four eduom_SetPartitionPage(FileID*, ShortPageID)
+ *  Four eduom_DropPartitionPage(FileID*, ShortPageID)
+ *  Four eduom_GetPartitionOwner(FileID*, ShortPageID, Four*)
+ *  Four eduom_ReleasePartitionPages(ObjectID*, sm_CatOverlayForData*)
+ *  Four eduom_GetPartitionNo(void)
+ *
+ * Internal Functions:
+ *  Four eduom_ReleasePartitionPage(ObjectID*, sm_CatOverlayForData*, PageID*)
+ *  Four eduom_ReleaseOrphanPages(ObjectID*, sm_CatOverlayForData*,
+ * eduom_FileInfo*)
+ *  void eduom_InitPartition(void)
+ *  void eduom_FinalPartition(void*)
+ */
+
+#include <pthread.h>
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+Four eduom_ReleasePartitionPage(ObjectID *, sm_CatOverlayForData *, PageID *);
+Four eduom_ReleaseOrphanPages(ObjectID *, sm_CatOverlayForData *,
+                              eduom_FileInfo *);
+void eduom_InitPartition(void);
+void eduom_FinalPartition(void *);
+
+static pthread_once_t partitionOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t partitionKey; /* frees the number when a thread exits */
+
+static Boolean partitionUsed[PARTITION_SLOTS]; /* is the number given? */
+
+/* protects partitionUsed */
+static pthread_mutex_t partitionMutex = PTHREAD_MUTEX_INITIALIZER;
+static __thread Four partitionNo = NIL; /* partition of the current thread */
+
+/*@================================
+ * eduom_GetPartitionPage()
+ *================================*/
+/*
+ * Function: Four eduom_GetPartitionPage(ObjectID*, sm_CatOverlayForData*,
+ * Four, Boolean, PageID*, SlottedPage**)
+ *
+ * Description :
+ *  Select the page where the current thread inserts an object of
+ *  'neededSpace' bytes: its insertion page of the file if it has room,
+ *  otherwise the best-fit page among the pages not owned by a thread. The
+ *  selected page is returned fixed in the buffer; the caller must free it.
+ *  If no page has enough room, 'pid->pageNo' is set to NIL. If 'ownOnly' is
+ *  TRUE, only the insertion page of the current thread is selected and it
+ *  is kept even if it has no room, since giving it up latches the page.
+ *  Otherwise the caller holds the exclusive latch on the file, and the
+ *  insertion pages left by the exited threads are given up as well.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter pid, apage
+ *     'pid' and 'apage' are set to the selected page
+ */
+Four eduom_GetPartitionPage(
+    ObjectID *catObjForFile,        /* IN file in which object is to be placed */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    Four neededSpace,               /* IN space needed in the page */
+    Boolean ownOnly,                /* IN select only the own page? */
+    PageID *pid,                    /* OUT selected page */
+    SlottedPage **apage)            /* OUT pointer to the buffer of the page */
+{
+  Four e;               /* error number */
+  Four no;              /* partition number of the current thread */
+  eduom_FileInfo *info; /* in-memory information of the file */
+  ShortPageID *ownPage; /* insertion page of the current thread */
+  ShortPageID noPage;   /* insertion page of a thread with no partition */
+
+  e = eduom_GetFileInfo(&catEntry->fid, &info);
+  if (e < eNOERROR) ERR(e);
+
+  // Partition 번호가 없는 thread는 소유하는 삽입 page가 없음
+  no = eduom_GetPartitionNo();
+  noPage = NIL;
+  ownPage = (no == NIL) ? &noPage : &info->partition.pages[no];
+
+  // 1. 현재 thread의 삽입 page에 여유 공간이 있는 경우, 해당 page를 선정함
+  if (*ownPage != NIL) {
+    MAKE_PAGEID(*pid, catEntry->fid.volNo, *ownPage);
+    e = BfM_GetTrain((TrainID *)pid, (char **)apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (eduom_HasRoomInPage(pid, *apage, neededSpace)) {
+      eduom_StatsAddPlacement(catObjForFile, STATS_PLACE_PARTITION);
+      return (eNOERROR);
+    }
+
+    e = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  if (ownOnly) {
+    pid->pageNo = NIL;
+    return (eNOERROR);
+  }
+
+  if (*ownPage != NIL) {
+    MAKE_PAGEID(*pid, catEntry->fid.volNo, *ownPage);
+
+    // 여유 공간이 없는 경우, 다른 thread가 남은 공간을 사용할 수 있도록
+    // page를 available space list에 반환함
+    e = eduom_ReleasePartitionPage(catObjForFile, catEntry, pid);
+    if (e < eNOERROR) ERR(e);
+    *ownPage = NIL;
+  }
+
+  // 종료된 thread들이 남긴 삽입 page들을 available space list에 반환함
+  e = eduom_ReleaseOrphanPages(catObjForFile, catEntry, info);
+  if (e < eNOERROR) ERR(e);
+
+  // 2. Free space map에서 필요한 자유 공간을 가지는 page 중 자유 공간이 가장
+  // 작은 page를 선정함
+  e = eduom_FsmGetPage(catEntry, neededSpace, pid, apage);
+  if (e < eNOERROR) ERR(e);
+
+  if (pid->pageNo != NIL)
+    eduom_StatsAddPlacement(catObjForFile, STATS_PLACE_FSM);
+
+  return (eNOERROR);
+
+} /* eduom_GetPartitionPage() */
+
+/*@================================
+ * eduom_SetPartitionPage()
+ *================================*/
+/*
+ * Function: Four eduom_SetPartitionPage(FileID*, ShortPageID)
+ *
+ * Description :
+ *  Make the page the insertion page of the current thread in the data file.
+ *  The current thread must have a partition number.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_SetPartitionPage(FileID *fid,        /* IN ID of the file */
+                            ShortPageID pageNo) /* IN new insertion page */
+{
+  Four e;               /* error number */
+  eduom_FileInfo *info; /* in-memory information of the file */
+
+  e = eduom_GetFileInfo(fid, &info);
+  if (e < eNOERROR) ERR(e);
+
+  info->partition.pages[eduom_GetPartitionNo()] = pageNo;
+
+  return (eNOERROR);
+
+} /* eduom_SetPartitionPage() */
+
+/*@================================
+ * eduom_DropPartitionPage()
+ *================================*/
+/*
+ * Function: Four eduom_DropPartitionPage(FileID*, ShortPageID)
+ *
+ * Description :
+ *  Forget the page as an insertion page of the data file. Called when the
+ *  page is removed from the file.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_DropPartitionPage(FileID *fid,        /* IN ID of the file */
+                             ShortPageID pageNo) /* IN page removed */
+{
+  Four e;               /* error number */
+  Four i;               /* index */
+  eduom_FileInfo *info; /* in-memory information of the file */
+
+  e = eduom_GetFileInfo(fid, &info);
+  if (e < eNOERROR) ERR(e);
+
+  for (i = 0; i < PARTITION_SLOTS; i++)
+    if (info->partition.pages[i] == pageNo) info->partition.pages[i] = NIL;
+
+  return (eNOERROR);
+
+} /* eduom_DropPartitionPage() */
+
+/*@================================
+ * eduom_GetPartitionOwner()
+ *================================*/
+/*
+ * Function: Four eduom_GetPartitionOwner(FileID*, ShortPageID, Four*)
+ *
+ * Description :
+ *  Find the partition whose insertion page of the data file is the page.
+ *  The caller holds the exclusive latch on the file, or the shared latch
+ *  and the space latch of the file.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter owner
+ *     'owner' is set to the partition number, NIL if the page is not an
+ *     insertion page
+ */
+Four eduom_GetPartitionOwner(FileID *fid,        /* IN ID of the file */
+                             ShortPageID pageNo, /* IN page to check */
+                             Four *owner)        /* OUT owning partition */
+{
+  Four e;               /* error number */
+  Four i;               /* index */
+  eduom_FileInfo *info; /* in-memory information of the file */
+
+  e = eduom_GetFileInfo(fid, &info);
+  if (e < eNOERROR) ERR(e);
+
+  *owner = NIL;
+  for (i = 0; i < PARTITION_SLOTS; i++) {
+    if (info->partition.pages[i] == pageNo) {
+      *owner = i;
+      break;
+    }
+  }
+
+  return (eNOERROR);
+
+} /* eduom_GetPartitionOwner() */
+
+/*@================================
+ * eduom_ReleasePartitionPages()
+ *================================*/
+/*
+ * Function: Four eduom_ReleasePartitionPages(ObjectID*, sm_CatOverlayForData*)
+ *
+ * Description :
+ *  Put all the insertion pages of the data file back into the available
+ *  space lists. Called when the file stops using the partitioned placement.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_ReleasePartitionPages(
+    ObjectID *catObjForFile,        /* IN catalog object of the file */
+    sm_CatOverlayForData *catEntry) /* IN catalog entry of the file */
+{
+  Four e;               /* error number */
+  Four i;               /* index */
+  eduom_FileInfo *info; /* in-memory information of the file */
+  PageID pid;           /* insertion page to release */
+
+  e = eduom_GetFileInfo(&catEntry->fid, &info);
+  if (e < eNOERROR) ERR(e);
+
+  for (i = 0; i < PARTITION_SLOTS; i++) {
+    if (info->partition.pages[i] == NIL) continue;
+
+    MAKE_PAGEID(pid, catEntry->fid.volNo, info->partition.pages[i]);
+    e = eduom_ReleasePartitionPage(catObjForFile, catEntry, &pid);
+    if (e < eNOERROR) ERR(e);
+    info->partition.pages[i] = NIL;
+  }
+
+  return (eNOERROR);
+
+} /* eduom_ReleasePartitionPages() */
+
+/*@================================
+ * eduom_GetPartitionNo()
+ *================================*/
+/*
+ * Function: Four eduom_GetPartitionNo(void)
+ *
+ * Description :
+ *  Return the partition number of the current thread. If the thread has no
+ *  number, the lowest free number is given to it; the number is freed when
+ *  the thread exits.
+ *
+ * Returns:
+ *  partition number of the current thread, NIL if all numbers are taken
+ */
+Four eduom_GetPartitionNo(void)
+{
+  Four i; /* index */
+
+  if (partitionNo != NIL) return (partitionNo);
+
+  pthread_once(&partitionOnce, eduom_InitPartition);
+
+  pthread_mutex_lock(&partitionMutex);
+  for (i = 0; i < PARTITION_SLOTS; i++) {
+    if (!partitionUsed[i]) {
+      partitionUsed[i] = TRUE;
+      partitionNo = i;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&partitionMutex);
+
+  // Thread가 종료될 때 번호를 반환하도록 key에 번호 + 1을 저장함
+  if (partitionNo != NIL)
+    pthread_setspecific(partitionKey, (void *)(long)(partitionNo + 1));
+
+  return (partitionNo);
+
+} /* eduom_GetPartitionNo() */
+
+/*@================================
+ * eduom_ReleasePartitionPage()
+ *================================*/
+/*
+ * Function: Four eduom_ReleasePartitionPage(ObjectID*, sm_CatOverlayForData*,
+ * PageID*)
+ *
+ * Description :
+ *  Put the insertion page into the available space list matching its free
+ *  space and record its free space in the free space map. The page may
+ *  already be in a list if an object of the page has been destroyed
+ *  meanwhile, so it is removed from that list first.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_ReleasePartitionPage(
+    ObjectID *catObjForFile,        /* IN catalog object of the file */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    PageID *pid)                    /* IN insertion page to release */
+{
+  Four e;             /* error number */
+  SlottedPage *apage; /* pointer to the buffer of the page */
+
+  e = eduom_LatchPage(pid, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain((TrainID *)pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(pid);
+    ERR(e);
+  }
+
+  e = eduom_RemoveFromAvailSpaceList(catObjForFile, catEntry, pid, apage);
+  if (e >= eNOERROR) e = om_PutInAvailSpaceList(catObjForFile, pid, apage);
+  if (e >= eNOERROR)
+    e = eduom_FsmSetFreeSpace(&catEntry->fid, pid->pageNo, SP_FREE(apage));
+
+  BfM_SetDirty((TrainID *)pid, PAGE_BUF);
+  BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+  eduom_UnlatchPage(pid);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_ReleasePartitionPage() */
+
+/*@================================
+ * eduom_ReleaseOrphanPages()
+ *================================*/
+/*
+ * Function: Four eduom_ReleaseOrphanPages(ObjectID*, sm_CatOverlayForData*,
+ * eduom_FileInfo*)
+ *
+ * Description :
+ *  Put the insertion pages of the partitions whose numbers are not given to
+ *  any thread back into the available space lists. The caller holds the
+ *  exclusive latch on the file, so no thread uses the pages meanwhile.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_ReleaseOrphanPages(
+    ObjectID *catObjForFile,        /* IN catalog object of the file */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    eduom_FileInfo *info)           /* IN in-memory information of the file */
+{
+  Four e;         /* error number */
+  Four i;         /* index */
+  Boolean orphan; /* is the partition number free? */
+  PageID pid;     /* insertion page to release */
+
+  for (i = 0; i < PARTITION_SLOTS; i++) {
+    if (info->partition.pages[i] == NIL) continue;
+
+    pthread_mutex_lock(&partitionMutex);
+    orphan = !partitionUsed[i];
+    pthread_mutex_unlock(&partitionMutex);
+    if (!orphan) continue;
+
+    MAKE_PAGEID(pid, catEntry->fid.volNo, info->partition.pages[i]);
+    e = eduom_ReleasePartitionPage(catObjForFile, catEntry, &pid);
+    if (e < eNOERROR) ERR(e);
+    info->partition.pages[i] = NIL;
+  }
+
+  return (eNOERROR);
+
+} /* eduom_ReleaseOrphanPages() */
+
+/*@================================
+ * eduom_InitPartition()
+ *================================*/
+/*
+ * Function: void eduom_InitPartition(void)
+ *
+ * Description :
+ *  Create the key whose destructor frees the partition number of an exiting
+ *  thread. Called once.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_InitPartition(void)
+{
+  pthread_key_create(&partitionKey, eduom_FinalPartition);
+
+} /* eduom_InitPartition() */
+
+/*@================================
+ * eduom_FinalPartition()
+ *================================*/
+/*
+ * Function: void eduom_FinalPartition(void*)
+ *
+ * Description :
+ *  Free the partition number of an exiting thread. The insertion pages of
+ *  the partition stay with the number until the next thread takes it or
+ *  they are released by eduom_ReleaseOrphanPages().
+ *
+ * Returns:
+ *  None
+ */
+void eduom_FinalPartition(void *arg) /* IN partition number + 1 */
+{
+  pthread_mutex_lock(&partitionMutex);
+  partitionUsed[(long)arg - 1] = FALSE;
+  pthread_mutex_unlock(&partitionMutex);
+
+} /* eduom_FinalPartition() */
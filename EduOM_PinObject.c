@@ -0,0 +1,444 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_PinObject.c
+ *
+ * Description :
+ *  EduOM_PinObject() gives direct access to the bytes of an object in the
+ *  buffer frame; the page stays fixed until EduOM_UnpinObject() is called.
+ *
+ * Exports:
+ *  Four EduOM_PinObject(ObjectID*, Four, Four, char**)
+ *  Four EduOM_UnpinObject(ObjectID*)
+ *
+ * Internal Functions:
+ *  Four eduom_PinPage(PageID*, Two)
+ *  Four eduom_UnpinPage(PageID*, Two)
+ *  Boolean eduom_IsPinnedPage(PageID*)
+ *  Boolean eduom_IsPinnedObject(ObjectID*)
+ *  Boolean eduom_HasRoomInPage(PageID*, SlottedPage*, Four)
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+/*
+ * Table of the pinned objects
+ * An entry whose slotNo is NIL pins all objects of the page. Objects in the
+ * pages of the table must not be moved by the page compaction, and pinned
+ * objects must not be changed or destroyed.
+ */
+#define PINNEDPAGE_TABLE_INCREMENT 16
+
+typedef struct {
+  PageID pid;  /* page holding pinned objects */
+  Two slotNo;  /* pinned object, NIL for all objects of the page */
+  Four count;  /* # of pins on the object */
+} PinnedPageEntry;
+
+static PinnedPageEntry *pinnedPages = NULL; /* pinned object table */
+static Four nPinnedPages = 0;               /* # of entries in use */
+static Four maxPinnedPages = 0;             /* # of entries allocated */
+
+/* protects the pinned object table */
+static pthread_mutex_t pinnedPageMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*@================================
+ * EduOM_PinObject()
+ *================================*/
+/*
+ * Function: Four EduOM_PinObject(ObjectID*, Four, Four, char**)
+ *
+ * Description :
+ *  Pin the object identified by 'oid' and return in '*buf' a pointer to the
+ *  byte 'start' of the object inside the buffer frame, so that the object can
+ *  be read without copying. The page holding the object stays fixed and its
+ *  objects are not moved by EduOM_CompactPage() until the object is unpinned
+ *  by EduOM_UnpinObject(); meanwhile updating or destroying the object fails
+ *  with eOBJECTPINNED_EDUOM. The caller must not modify the returned bytes.
+ *  If 'length' is REMAINDER, the bytes from 'start' to the end of the object
+ *  are made accessible. A moved object is pinned in its body; its stub is
+ *  pinned as well, so that the object is not moved again while pinned.
+ *
+ * Returns:
+ *  1) number of bytes accessible from '*buf' (values greater than or equal
+ *     to 0)
+ *  2) Error Code (negative values)
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADSTART_OM
+ *    eBADUSERBUF_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter buf
+ *     '*buf' points to the object data in the buffer frame.
+ */
+Four EduOM_PinObject(ObjectID *oid, /* IN object to pin */
+                     Four start,    /* IN starting offset of access */
+                     Four length,   /* IN amount of data to access */
+                     char **buf)    /* OUT pointer to the object data */
+{
+  Four e;             /* error code */
+  PageID pid;         /* page containing object specified by 'oid' */
+  SlottedPage *apage; /* pointer to the buffer of the page */
+  Object *obj;        /* pointer to the object in the slotted page */
+  ObjectID fwdOid;    /* forwarded object of a moved object */
+
+  /*@ check parameters */
+
+  if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+  if (length < 0 && length != REMAINDER) ERR(eBADLENGTH_OM);
+
+  if (start < 0) ERR(eBADSTART_OM);
+
+  if (buf == NULL) ERR(eBADUSERBUF_OM);
+
+  // 1. 파라미터로 주어진 oid를 이용하여 object에 접근함, pin을 등록할 때까지
+  // page를 shared mode로 latch 함
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  e = eduom_LatchPage(&pid, LATCH_SHARED);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERR(e);
+  }
+
+  e = eNOERROR;
+  if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots ||
+      !IS_VALID_OBJECTID(oid, apage))
+    e = eBADOBJECTID_OM;
+
+  if (e == eNOERROR) {
+    obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+
+    /* Error check whether using not supported functionality by EduOM */
+    if (obj->header.properties & P_LRGOBJ) e = eNOTSUPPORTED_EDUOM;
+  }
+
+  // 이동된 object인 경우, stub을 pin 하여 object가 다시 이동되지 않도록 한
+  // 후 forwarded object를 pin 함, stub이 저장된 page도 unpin 될 때까지 fix 된
+  // 상태로 남음
+  if (e == eNOERROR && (obj->header.properties & P_MOVED)) {
+    fwdOid = *((ObjectID *)obj->data);
+
+    e = eduom_PinPage(&pid, oid->slotNo);
+    eduom_UnlatchPage(&pid);
+    if (e < eNOERROR) ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+
+    e = EduOM_PinObject(&fwdOid, start, length, buf);
+    if (e < eNOERROR) {
+      eduom_UnpinPage(&pid, oid->slotNo);
+      ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+    }
+
+    return (e);
+  }
+
+  // 2. 파라미터로 주어진 start 및 length를 확인함
+  if (e == eNOERROR && start > obj->header.length) e = eBADSTART_OM;
+
+  if (e == eNOERROR) {
+    if (length == REMAINDER) length = obj->header.length - start;
+
+    if (start + length > obj->header.length) e = eBADLENGTH_OM;
+  }
+
+  // 3. Object를 pinned object table에 등록함
+  if (e == eNOERROR) e = eduom_PinPage(&pid, oid->slotNo);
+
+  eduom_UnlatchPage(&pid);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+
+  // 4. Buffer frame 상의 데이터에 대한 포인터를 반환함, page는 unpin 될 때까지
+  // fix 된 상태로 남음
+  *buf = &(obj->data[start]);
+
+  return (length);
+
+} /* EduOM_PinObject() */
+
+/*@================================
+ * EduOM_UnpinObject()
+ *================================*/
+/*
+ * Function: Four EduOM_UnpinObject(ObjectID*)
+ *
+ * Description :
+ *  Release a pin acquired by EduOM_PinObject() on the object identified by
+ *  'oid'. The pointer returned by EduOM_PinObject() must not be used anymore.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_UnpinObject(ObjectID *oid) /* IN object to unpin */
+{
+  Four e;             /* error code */
+  PageID pid;         /* page containing object specified by 'oid' */
+  SlottedPage *apage; /* pointer to the buffer of the page */
+  Object *obj;        /* pointer to the object in the slotted page */
+  Boolean moved;      /* is the object moved? */
+  ObjectID fwdOid;    /* forwarded object of a moved object */
+
+  /*@ check parameters */
+
+  if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+  // 1. Page를 shared mode로 latch 한 채로, 이동된 object인지 확인하고
+  // pinned object table에서 object의 pin 수를 감소시킴
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  e = eduom_LatchPage(&pid, LATCH_SHARED);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERR(e);
+  }
+
+  moved = FALSE;
+  if (oid->slotNo >= 0 && oid->slotNo < apage->header.nSlots &&
+      IS_VALID_OBJECTID(oid, apage)) {
+    obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+    if (obj->header.properties & P_MOVED) {
+      moved = TRUE;
+      fwdOid = *((ObjectID *)obj->data);
+    }
+  }
+
+  e = eduom_UnpinPage(&pid, oid->slotNo);
+  eduom_UnlatchPage(&pid);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+
+  e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  // 2. Pin 할 때 fix 한 page를 unfix 함
+  // 이동된 object인 경우, forwarded object의 pin도 해제함
+  e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  if (moved) {
+    e = EduOM_UnpinObject(&fwdOid);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  return (eNOERROR);
+
+} /* EduOM_UnpinObject() */
+
+/*@================================
+ * eduom_PinPage()
+ *================================*/
+/*
+ * Function: Four eduom_PinPage(PageID*, Two)
+ *
+ * Description :
+ *  Register a pin on the object of 'slotNo' in the given page, or on all
+ *  objects of the page if 'slotNo' is NIL, in the pinned object table. The
+ *  objects of a page holding pins are not moved by the page compaction.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUOM
+ */
+Four eduom_PinPage(PageID *pid, /* IN page to pin */
+                   Two slotNo)  /* IN object to pin, NIL for the whole page */
+{
+  Four i;                    /* index variable */
+  PinnedPageEntry *newTable; /* enlarged pinned page table */
+
+  pthread_mutex_lock(&pinnedPageMutex);
+
+  for (i = 0; i < nPinnedPages; i++)
+    if (EQUAL_PAGEID(pinnedPages[i].pid, *pid) &&
+        pinnedPages[i].slotNo == slotNo)
+      break;
+
+  if (i == nPinnedPages) {
+    if (nPinnedPages == maxPinnedPages) {
+      newTable = (PinnedPageEntry *)realloc(
+          pinnedPages, sizeof(PinnedPageEntry) *
+                           (maxPinnedPages + PINNEDPAGE_TABLE_INCREMENT));
+      if (newTable == NULL) {
+        pthread_mutex_unlock(&pinnedPageMutex);
+        ERR(eMEMORYALLOCERR_EDUOM);
+      }
+
+      pinnedPages = newTable;
+      maxPinnedPages += PINNEDPAGE_TABLE_INCREMENT;
+    }
+
+    pinnedPages[i].pid = *pid;
+    pinnedPages[i].slotNo = slotNo;
+    pinnedPages[i].count = 0;
+    nPinnedPages++;
+  }
+  pinnedPages[i].count++;
+
+  pthread_mutex_unlock(&pinnedPageMutex);
+
+  return (eNOERROR);
+
+} /* eduom_PinPage() */
+
+/*@================================
+ * eduom_UnpinPage()
+ *================================*/
+/*
+ * Function: Four eduom_UnpinPage(PageID*, Two)
+ *
+ * Description :
+ *  Release a pin registered by eduom_PinPage() on the object of 'slotNo' in
+ *  the given page, or on the whole page if 'slotNo' is NIL.
+ *
+ * Returns:
+ *  error code
+ *    eBADPAGEID_OM
+ */
+Four eduom_UnpinPage(PageID *pid, /* IN page to unpin */
+                     Two slotNo)  /* IN object to unpin, NIL for the page */
+{
+  Four i; /* index variable */
+
+  pthread_mutex_lock(&pinnedPageMutex);
+
+  for (i = 0; i < nPinnedPages; i++)
+    if (EQUAL_PAGEID(pinnedPages[i].pid, *pid) &&
+        pinnedPages[i].slotNo == slotNo)
+      break;
+
+  if (i == nPinnedPages) {
+    pthread_mutex_unlock(&pinnedPageMutex);
+    ERR(eBADPAGEID_OM);
+  }
+
+  if (--pinnedPages[i].count == 0) pinnedPages[i] = pinnedPages[--nPinnedPages];
+
+  pthread_mutex_unlock(&pinnedPageMutex);
+
+  return (eNOERROR);
+
+} /* eduom_UnpinPage() */
+
+/*@================================
+ * eduom_IsPinnedPage()
+ *================================*/
+/*
+ * Function: Boolean eduom_IsPinnedPage(PageID*)
+ *
+ * Description :
+ *  Check whether the given page holds any pinned object.
+ *
+ * Returns:
+ *  TRUE if the page holds pinned objects, otherwise FALSE
+ */
+Boolean eduom_IsPinnedPage(PageID *pid) /* IN page to check */
+{
+  Four i;          /* index variable */
+  Boolean pinned; /* TRUE if the page is pinned */
+
+  pthread_mutex_lock(&pinnedPageMutex);
+
+  pinned = FALSE;
+  for (i = 0; i < nPinnedPages; i++)
+    if (EQUAL_PAGEID(pinnedPages[i].pid, *pid)) pinned = TRUE;
+
+  pthread_mutex_unlock(&pinnedPageMutex);
+
+  return (pinned);
+
+} /* eduom_IsPinnedPage() */
+
+/*@================================
+ * eduom_IsPinnedObject()
+ *================================*/
+/*
+ * Function: Boolean eduom_IsPinnedObject(ObjectID*)
+ *
+ * Description :
+ *  Check whether the given object is pinned, either by itself or as an
+ *  object of a pinned page. The caller holds the latch of the page of the
+ *  object, so that the result stays valid while the object is changed.
+ *
+ * Returns:
+ *  TRUE if the object is pinned, otherwise FALSE
+ */
+Boolean eduom_IsPinnedObject(ObjectID *oid) /* IN object to check */
+{
+  Four i;         /* index variable */
+  PageID pid;     /* page of the object */
+  Boolean pinned; /* TRUE if the object is pinned */
+
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+
+  pthread_mutex_lock(&pinnedPageMutex);
+
+  pinned = FALSE;
+  for (i = 0; i < nPinnedPages; i++)
+    if (EQUAL_PAGEID(pinnedPages[i].pid, pid) &&
+        (pinnedPages[i].slotNo == NIL || pinnedPages[i].slotNo == oid->slotNo))
+      pinned = TRUE;
+
+  pthread_mutex_unlock(&pinnedPageMutex);
+
+  return (pinned);
+
+} /* eduom_IsPinnedObject() */
+
+/*@================================
+ * eduom_HasRoomInPage()
+ *================================*/
+/*
+ * Function: Boolean eduom_HasRoomInPage(PageID*, SlottedPage*, Four)
+ *
+ * Description :
+ *  Check whether 'neededSpace' bytes can be allocated in the given page.
+ *  A page holding pinned objects cannot be compacted, so only its contiguous
+ *  free area is considered.
+ *
+ * Returns:
+ *  TRUE if the space can be allocated, otherwise FALSE
+ */
+Boolean eduom_HasRoomInPage(PageID *pid,        /* IN page to check */
+                            SlottedPage *apage, /* IN buffer of the page */
+                            Four neededSpace)   /* IN space to allocate */
+{
+  if (SP_FREE(apage) < neededSpace) return (FALSE);
+
+  if (SP_CFREE(apage) >= neededSpace) return (TRUE);
+
+  return (eduom_IsPinnedPage(pid) ? FALSE : TRUE);
+
+} /* eduom_HasRoomInPage() */
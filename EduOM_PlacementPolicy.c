@@ -0,0 +1,190 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_PlacementPolicy.c
+ *
+ * Description :
+ *  Set and get the placement policy of a data file, which decides the page
+ *  where a new object is placed when no near object is given.
+ *
+ * Exports:
+ *  Four EduOM_SetPlacementPolicy(ObjectID*, Two)
+ *  Four EduOM_GetPlacementPolicy(ObjectID*, Two*)
+ */
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+/*@================================
+ * EduOM_SetPlacementPolicy()
+ *================================*/
+/*
+ * Function: Four EduOM_SetPlacementPolicy(ObjectID*, Two)
+ *
+ * Description :
+ *  Set the placement policy of the data file.
+ *   PLACEMENT_BEST_FIT    : the page with the least free space among the pages
+ *                           having enough room (default)
+ *   PLACEMENT_FIRST_FIT   : the first page of the smallest available space
+ *                           list fitting the object, else the last page
+ *   PLACEMENT_APPEND_ONLY : the last page of the file; the pages filled by
+ *                           the insertion are not put into the available
+ *                           space lists
+ *   PLACEMENT_PARTITIONED : the insertion page of the current thread, else
+ *                           the best-fit page not used by another thread;
+ *                           the insertion pages are kept out of the
+ *                           available space lists while they are in use
+ *  The policy is stored in the flags of the first page of the file, which is
+ *  never deallocated while the file exists.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetPlacementPolicy(
+    ObjectID *catObjForFile, /* IN file whose policy is set */
+    Two policy)              /* IN new placement policy */
+{
+  Four e;                         /* error number */
+  SlottedPage *catPage;           /* buffer page containing the catalog */
+  sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+  eduom_FileInfo *info;           /* in-memory information of the file */
+  PageID pid;                     /* first page of the file */
+  SlottedPage *apage;             /* pointer to the buffer of the first page */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (policy != PLACEMENT_BEST_FIT && policy != PLACEMENT_FIRST_FIT &&
+      policy != PLACEMENT_APPEND_ONLY && policy != PLACEMENT_PARTITIONED)
+    ERR(eBADPARAMETER_OM);
+
+  // File 정보를 변경하므로 file을 exclusive mode로 latch 함
+  e = eduom_LatchFile(catObjForFile, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchFile(catObjForFile);
+    ERR(e);
+  }
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+  e = eduom_GetFileInfo(&catEntry->fid, &info);
+
+  // Partitioned placement를 사용하지 않게 되는 경우, thread들의 삽입 page를
+  // available space list에 반환함
+  if (e >= eNOERROR && policy != PLACEMENT_PARTITIONED)
+    e = eduom_ReleasePartitionPages(catObjForFile, catEntry);
+
+  // 1. File의 첫 번째 page의 flags에 placement policy를 기록함
+  if (e >= eNOERROR) {
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+  }
+
+  if (e >= eNOERROR) {
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e >= eNOERROR) {
+      apage->header.flags &= ~PLACEMENT_POLICY_MASK;
+      apage->header.flags |= policy << PLACEMENT_POLICY_SHIFT;
+
+      BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+      e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    }
+    eduom_UnlatchPage(&pid);
+  }
+
+  // 2. File 정보에 저장된 placement policy를 갱신함
+  if (e >= eNOERROR) info->placementPolicy = policy;
+
+  eduom_UnlatchFile(catObjForFile);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_SetPlacementPolicy() */
+
+/*@================================
+ * EduOM_GetPlacementPolicy()
+ *================================*/
+/*
+ * Function: Four EduOM_GetPlacementPolicy(ObjectID*, Two*)
+ *
+ * Description :
+ *  Get the placement policy of the data file.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter policy
+ *     'policy' is set to the placement policy of the file
+ */
+Four EduOM_GetPlacementPolicy(
+    ObjectID *catObjForFile, /* IN file whose policy is returned */
+    Two *policy)             /* OUT placement policy of the file */
+{
+  Four e;                         /* error number */
+  SlottedPage *catPage;           /* buffer page containing the catalog */
+  sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (policy == NULL) ERR(eBADPARAMETER_OM);
+
+  // 처음 읽을 때 file 정보에 placement policy를 저장하므로 file을 exclusive
+  // mode로 latch 함
+  e = eduom_LatchFile(catObjForFile, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchFile(catObjForFile);
+    ERR(e);
+  }
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+  e = eduom_GetPlacementPolicy(catEntry, policy);
+
+  eduom_UnlatchFile(catObjForFile);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_GetPlacementPolicy() */
@@ -0,0 +1,324 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_Prealloc.c
+ *
+ * Description :
+ *  Page preallocation of a data file. When preallocation is enabled for a
+ *  file, the pages for the file are allocated by runs of pages (up to the
+ *  extent size) instead of one page at a time, and the pages of a run are
+ *  handed out in the order of their page numbers. Interleaved growth of
+ *  several files then does not scatter their pages, and the list of pages
+ *  of a file follows the physical order of the pages.
+ *
+ *  The pages preallocated but not handed out yet belong to the file only in
+ *  memory. They are released when a destroyed object leaves its page with no
+ *  object, which the destruction of the last object of the file always
+ *  does; otherwise they must be released by EduOM_ReleasePreallocatedPages()
+ *  before the file is destroyed.
+ *
+ * Exports:
+ *  Four EduOM_SetPreallocation(ObjectID*, Four)
+ *  Four EduOM_ReleasePreallocatedPages(ObjectID*, Pool*, DeallocListElem*)
+ *  Four eduom_AllocPage(sm_CatOverlayForData*, Four, PageID*, PageID*)
+ *  Four eduom_ReleasePreallocPages(sm_CatOverlayForData*, Pool*,
+ * DeallocListElem*)
+ *
+ * Internal Functions:
+ *  Four eduom_ReleasePreallocInfo(PreallocInfo*, Pool*, DeallocListElem*)
+ *  int eduom_ComparePageNo(const void*, const void*)
+ */
+
+#include <stdlib.h>
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+#include "RDsM.h"
+#include "Util.h" /* to get Pool */
+
+Four eduom_ReleasePreallocInfo(PreallocInfo *, Pool *, DeallocListElem *);
+int eduom_ComparePageNo(const void *, const void *);
+
+/*@================================
+ * EduOM_SetPreallocation()
+ *================================*/
+/*
+ * Function: Four EduOM_SetPreallocation(ObjectID*, Four)
+ *
+ * Description :
+ *  Set the number of pages allocated at once for the data file. 0 disables
+ *  the preallocation, which is the default; the pages already preallocated
+ *  are still handed out before new pages are allocated.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetPreallocation(
+    ObjectID *catObjForFile, /* IN file whose preallocation is set */
+    Four nPages)             /* IN # of pages allocated at once */
+{
+  Four e;                         /* error number */
+  SlottedPage *catPage;           /* buffer page containing the catalog */
+  sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+  eduom_FileInfo *info;           /* in-memory information of the file */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (nPages < 0 || nPages > PREALLOC_MAX_PAGES) ERR(eBADPARAMETER_OM);
+
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+  e = eduom_GetFileInfo(&catEntry->fid, &info);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  info->prealloc.runSize = nPages;
+
+  e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_SetPreallocation() */
+
+/*@================================
+ * EduOM_ReleasePreallocatedPages()
+ *================================*/
+/*
+ * Function: Four EduOM_ReleasePreallocatedPages(ObjectID*, Pool*,
+ * DeallocListElem*)
+ *
+ * Description :
+ *  Insert the pages preallocated for the data file but not handed out yet
+ *  into the dealloc list, so that they are deallocated with the other
+ *  pages in the list.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_ReleasePreallocatedPages(
+    ObjectID *catObjForFile, /* IN file whose pages are released */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead) /* INOUT head of dealloc list */
+{
+  Four e;                         /* error number */
+  Four e2;                        /* error number of the cleanup */
+  SlottedPage *catPage;           /* buffer page containing the catalog */
+  sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+  eduom_FileInfo *info;           /* in-memory information of the file */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (dlPool == NULL || dlHead == NULL) ERR(eBADPARAMETER_OM);
+
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+  e = eduom_GetFileInfo(&catEntry->fid, &info);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  e = eduom_ReleasePreallocInfo(&(info->prealloc), dlPool, dlHead);
+
+  e2 = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+
+  // Cache 된 element들을 pool에 반환함
+  e2 = eduom_FlushElementPool(dlPool);
+  if (e >= eNOERROR) e = e2;
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_ReleasePreallocatedPages() */
+
+/*@================================
+ * eduom_AllocPage()
+ *================================*/
+/*
+ * Function: Four eduom_AllocPage(sm_CatOverlayForData*, Four, PageID*,
+ * PageID*)
+ *
+ * Description :
+ *  Allocate a page for the data file. If preallocation is enabled for the
+ *  file, the page is taken from the preallocated pages in the order of the
+ *  page numbers, and when no preallocated page is left, a new run of pages
+ *  is allocated near 'nearPid'. Otherwise, or if the volume has no room for
+ *  a run, one page is allocated near 'nearPid'.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter pid
+ *     'pid' is set to the PageID of the allocated page.
+ */
+Four eduom_AllocPage(
+    sm_CatOverlayForData *catEntry, /* IN catalog information of the file */
+    Four firstExt,                  /* IN first extent No of the file */
+    PageID *nearPid,                /* IN the page is allocated near it */
+    PageID *pid)                    /* OUT PageID of the page */
+{
+  Four e;               /* error number */
+  eduom_FileInfo *info; /* in-memory information of the file */
+  PreallocInfo *pa;     /* preallocated pages of the file */
+
+  e = eduom_GetFileInfo(&catEntry->fid, &info);
+  if (e < eNOERROR) ERR(e);
+  pa = &(info->prealloc);
+
+  // 1. 미리 할당 받은 page가 없는 경우, runSize 개의 page를 한 번에 할당 받고
+  // page 번호 순으로 정렬함
+  if (pa->nextPage == pa->nPages && pa->runSize > 1) {
+    e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, nearPid, catEntry->eff,
+                         pa->runSize, PAGESIZE2, pa->pages);
+    if (e >= eNOERROR) {
+      qsort(pa->pages, pa->runSize, sizeof(PageID), eduom_ComparePageNo);
+      pa->nPages = pa->runSize;
+      pa->nextPage = 0;
+    }
+  }
+
+  // 2. Preallocation을 사용하지 않거나 volume에 runSize 개의 page를 할당할
+  // 공간이 없어 미리 할당 받은 page가 없는 경우, page를 하나 할당 받음
+  if (pa->nextPage == pa->nPages) {
+    e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, nearPid, catEntry->eff,
+                         1, PAGESIZE2, pid);
+    if (e < eNOERROR) ERR(e);
+
+    return (eNOERROR);
+  }
+
+  // 3. 미리 할당 받은 page들 중 page 번호가 가장 작은 page를 반환함
+  *pid = pa->pages[pa->nextPage++];
+
+  return (eNOERROR);
+
+} /* eduom_AllocPage() */
+
+/*@================================
+ * eduom_ReleasePreallocPages()
+ *================================*/
+/*
+ * Function: Four eduom_ReleasePreallocPages(sm_CatOverlayForData*, Pool*,
+ * DeallocListElem*)
+ *
+ * Description :
+ *  Insert the pages preallocated for the data file but not handed out yet
+ *  into the dealloc list. Called when an object is destroyed and leaves its
+ *  page with no object: the file is shrinking, and the destruction of the
+ *  last object of the file always does so, so the pages are not lost if the
+ *  file is emptied and destroyed without EduOM_ReleasePreallocatedPages().
+ *  The caller holds the exclusive latch on the file.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_ReleasePreallocPages(
+    sm_CatOverlayForData *catEntry, /* IN catalog information of the file */
+    Pool *dlPool,                   /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)        /* INOUT head of dealloc list */
+{
+  Four e;               /* error number */
+  eduom_FileInfo *info; /* in-memory information of the file */
+
+  e = eduom_GetFileInfo(&catEntry->fid, &info);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_ReleasePreallocInfo(&(info->prealloc), dlPool, dlHead);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_ReleasePreallocPages() */
+
+/*@================================
+ * eduom_ReleasePreallocInfo()
+ *================================*/
+/*
+ * Function: Four eduom_ReleasePreallocInfo(PreallocInfo*, Pool*,
+ * DeallocListElem*)
+ *
+ * Description :
+ *  Insert the preallocated pages not handed out yet into the dealloc list.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_ReleasePreallocInfo(
+    PreallocInfo *pa,        /* INOUT preallocated pages of the file */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead) /* INOUT head of dealloc list */
+{
+  Four e;                  /* error number */
+  DeallocListElem *dlElem; /* pointer to element of dealloc list */
+
+  // 미리 할당 받았지만 사용하지 않은 page들을 dealloc list에 삽입함
+  while (pa->nextPage < pa->nPages) {
+    e = eduom_GetElementFromPool(dlPool, &dlElem);
+    if (e < eNOERROR) ERR(e);
+
+    dlElem->type = DL_PAGE;
+    dlElem->elem.pid = pa->pages[pa->nextPage++];
+    dlElem->next = dlHead->next;
+    dlHead->next = dlElem;
+  }
+
+  return (eNOERROR);
+
+} /* eduom_ReleasePreallocInfo() */
+
+/*@================================
+ * eduom_ComparePageNo()
+ *================================*/
+/*
+ * Function: int eduom_ComparePageNo(const void*, const void*)
+ *
+ * Description :
+ *  qsort() comparison function ordering PageIDs by their page numbers.
+ *
+ * Returns:
+ *  negative, zero or positive value as the first page number is smaller
+ *  than, equal to or greater than the second one
+ */
+int eduom_ComparePageNo(const void *a, /* IN first PageID */
+                        const void *b) /* IN second PageID */
+{
+  return (((PageID *)a)->pageNo - ((PageID *)b)->pageNo);
+
+} /* eduom_ComparePageNo() */
@@ -30,6 +30,9 @@
  *
  * Exports:
  *  Four EduOM_PrevObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*)
+ *
+ * Internal Functions:
+ *  Four eduom_PrevObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*)
  */
 
 #include "BfM.h"
@@ -69,16 +72,50 @@ Four EduOM_PrevObject(
     ObjectID *prevOID,       /* OUT the previous object of a current object */
     ObjectHdr *objHdr)       /* OUT the object header of previous object */
 {
-  Four e;               /* error */
-  Two i;                /* index */
-  Four offset;          /* starting offset of object within a page */
-  PageID pid;           /* a page identifier */
-  PageNo pageNo;        /* a temporary var for previous page's PageNo */
-  SlottedPage *apage;   /* a pointer to the data page */
-  Object *obj;          /* a pointer to the Object */
-  SlottedPage *catPage; /* buffer page containing the catalog object */
-  sm_CatOverlayForData
-      *catEntry; /* overlay structure for catalog object access */
+  Four e;                  /* error number */
+  struct timespec opStart; /* time when the operation starts */
+
+  eduom_StatsStartOp(&opStart);
+  e = eduom_PrevObject(catObjForFile, curOID, prevOID, objHdr);
+  eduom_StatsEndOp(catObjForFile, STATS_OP_PREV, &opStart);
+
+  return (e);
+
+} /* EduOM_PrevObject() */
+
+/*@================================
+ * eduom_PrevObject()
+ *================================*/
+/*
+ * Function: Four eduom_PrevObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*)
+ *
+ * Description :
+ *  Find the previous object of the current object for
+ *  EduOM_PrevObject(). Empty slots and the bodies of moved objects(forwarded
+ *  objects) are skipped, so that each object is returned once through its
+ *  stub.
+ *
+ * Returns:
+ *  EOS if there is no previous object
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_PrevObject(
+    ObjectID *catObjForFile, /* IN informations about a data file */
+    ObjectID *curOID,        /* IN a ObjectID of the current object */
+    ObjectID *prevOID,       /* OUT the previous object of a current object */
+    ObjectHdr *objHdr)       /* OUT the object header of previous object */
+{
+  Four e;                    /* error */
+  Two i;                     /* index */
+  Boolean fromLastSlot;      /* start from the last slot of the page? */
+  PageID pid;                /* a page identifier */
+  PageNo pageNo;             /* a temporary var for previous page's PageNo */
+  SlottedPage *apage;        /* a pointer to the data page */
+  Object *obj;               /* a pointer to the Object */
+  eduom_CatalogDesc catDesc; /* cached catalog information of the file */
 
   /*@ parameter checking */
   if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
@@ -87,63 +124,71 @@ Four EduOM_PrevObject(
 
   // 현재 object의 이전 object의 ID를 반환함
 
-  BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
-  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+  // File의 첫 번째 및 마지막 page는 cache 된 catalog 정보에서 읽음
+  e = eduom_GetCatalogDesc(catObjForFile, &catDesc);
+  if (e < eNOERROR) ERR(e);
 
-  // 1. 파라미터로 주어진 curOID가 NULL 인 경우, File의 마지막 page의 slot array
-  // 상에서의 마지막 object의 ID를 반환함
+  // 1. 파라미터로 주어진 curOID가 NULL 인 경우, file의 마지막 page의 마지막
+  // slot부터 탐색함
+  // 파라미터로 주어진 curOID가 NULL 이 아닌 경우, curOID의 이전 slot부터
+  // 탐색함
   if (curOID == NULL) {
-    pageNo = catEntry->lastPage;
+    MAKE_PAGEID(pid, catDesc.fid.volNo, catDesc.lastPage);
+    fromLastSlot = TRUE;
+  } else {
+    MAKE_PAGEID(pid, curOID->volNo, curOID->pageNo);
+    i = curOID->slotNo - 1;
+    fromLastSlot = FALSE;
+  }
 
-    MAKE_PAGEID(pid, catEntry->fid.volNo, pageNo);
-    BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  for (;;) {
+    e = eduom_LatchPage(&pid, LATCH_SHARED);
+    if (e < eNOERROR) ERR(e);
 
-    prevOID->volNo = pid.volNo;
-    prevOID->pageNo = pageNo;
-    prevOID->slotNo = apage->header.nSlots - 1;
-    prevOID->unique = apage->slot[(prevOID->slotNo) * -1].unique;
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) {
+      eduom_UnlatchPage(&pid);
+      ERR(e);
+    }
 
-    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-  } else {
-    // 2. 파라미터로 주어진 curOID가 NULL 이 아닌 경우, curOID에 대응하는
-    // object를 탐색함
-    MAKE_PAGEID(pid, curOID->volNo, curOID->pageNo);
-    BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-
-    // Slot array 상에서, 탐색한 object의 이전 object의 ID를
-    // 반환함, 탐색한 object가 page의 첫 번째 object인 경우, 이전 page의 마지막
-    // object의 ID를 반환함, 탐색한 object가 file의 첫 번째 page의 첫 번째
-    // object인 경우, EOS (End Of Scan) 를 반환함
-    if (curOID->slotNo != 0) {
-      prevOID->volNo = curOID->volNo;
-      prevOID->pageNo = curOID->pageNo;
-      prevOID->slotNo = curOID->slotNo - 1;
-      prevOID->unique = apage->slot[(prevOID->slotNo) * -1].unique;
-
-      BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-    } else {
-      if (apage->header.pid.pageNo == catEntry->firstPage) {
-        BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-        BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
-        return (EOS);
-      } else {
-        pageNo = apage->header.prevPage;
-
-        BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-        MAKE_PAGEID(pid, curOID->volNo, pageNo);
-        BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-
-        prevOID->volNo = curOID->volNo;
-        prevOID->pageNo = pageNo;
-        prevOID->slotNo = apage->header.nSlots - 1;
-        prevOID->unique = apage->slot[(prevOID->slotNo) * -1].unique;
-
-        BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    // 2. Slot array 상에서 scan 대상인 이전 object를 탐색함
+    // 빈 slot과 이동된 object의 forwarded object는 건너뜀
+    if (fromLastSlot) i = apage->header.nSlots - 1;
+    for (; i >= 0; i--) {
+      if (IS_SCANNED_SLOT(apage, i)) break;
+    }
+
+    if (i >= 0) {
+      prevOID->volNo = pid.volNo;
+      prevOID->pageNo = pid.pageNo;
+      prevOID->slotNo = i;
+      prevOID->unique = apage->slot[-i].unique;
+
+      if (objHdr != NULL) {
+        obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+        *objHdr = obj->header;
       }
+
+      e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+      eduom_UnlatchPage(&pid);
+      if (e < eNOERROR) ERR(e);
+
+      return (eNOERROR);
     }
-  }
 
-  BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
-  return (EOS);
+    // 3. 탐색한 page가 file의 첫 번째 page인 경우, EOS (End Of Scan) 를
+    // 반환함
+    // 그렇지 않은 경우, 이전 page의 마지막 slot부터 탐색함
+    pageNo = (pid.pageNo == catDesc.firstPage) ? NIL : apage->header.prevPage;
 
-} /* EduOM_PrevObject() */
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    eduom_UnlatchPage(&pid);
+    if (e < eNOERROR) ERR(e);
+
+    if (pageNo == NIL) return (EOS); /* end of scan */
+
+    pid.pageNo = pageNo;
+    fromLastSlot = TRUE;
+  }
+
+} /* eduom_PrevObject() */
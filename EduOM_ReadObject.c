@@ -31,6 +31,10 @@
  *
  * Exports:
  *  Four EduOM_ReadObject(ObjectID*, Four, Four, char*)
+ *
+ * Internal Functions:
+ *  Four eduom_ReadObject(ObjectID*, Four, Four, char*)
+ *  Boolean eduom_IsForwardedTo(ObjectID*, ObjectID*)
  */
 
 #include <string.h>
@@ -40,6 +44,8 @@
 #include "EduOM_common.h"
 #include "LOT.h" /* for the large object manager call */
 
+Boolean eduom_IsForwardedTo(ObjectID *, ObjectID *);
+
 /*@================================
  * EduOM_ReadObject()
  *================================*/
@@ -88,12 +94,48 @@ Four EduOM_ReadObject(ObjectID *oid, /* IN object to read */
                       Four start,    /* IN starting offset of read */
                       Four length,   /* IN amount of data to read */
                       char *buf) /* OUT user buffer to return the read data */
+{
+  Four e;                  /* error code */
+  struct timespec opStart; /* time when the operation starts */
+
+  eduom_StatsStartOp(&opStart);
+  e = eduom_ReadObject(oid, start, length, buf);
+  eduom_StatsEndOp(NULL, STATS_OP_READ, &opStart);
+
+  return (e);
+
+} /* EduOM_ReadObject() */
+
+/*@================================
+ * eduom_ReadObject()
+ *================================*/
+/*
+ * Function: Four eduom_ReadObject(ObjectID*, Four, Four, char*)
+ *
+ * Description :
+ *  Read the data of the object for EduOM_ReadObject(). A moved object is
+ *  read by calling this routine again with the forwarded object.
+ *
+ * Returns:
+ *  1) number of bytes actually read (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eBADSTART_OM
+ *    some errors caused by function calls
+ */
+Four eduom_ReadObject(ObjectID *oid, /* IN object to read */
+                      Four start,    /* IN starting offset of read */
+                      Four length,   /* IN amount of data to read */
+                      char *buf) /* OUT user buffer to return the read data */
 {
   Four e;             /* error code */
   PageID pid;         /* page containing object specified by 'oid' */
   SlottedPage *apage; /* pointer to the buffer of the page  */
   Object *obj;        /* pointer to the object in the slotted page */
   Four offset;        /* offset of the object in the page */
+  ObjectID fwdOid;    /* forwarded object of a moved object */
 
   /*@ check parameters */
 
@@ -103,21 +145,124 @@ Four EduOM_ReadObject(ObjectID *oid, /* IN object to read */
 
   if (buf == NULL) ERR(eBADUSERBUF_OM);
 
+  if (start < 0) ERR(eBADSTART_OM);
+
   // Object의 데이터 전체 또는 일부를 읽고, 읽은 데이터에 대한 포인터를
   // 반환함
-  // 1. 파라미터로 주어진 oid를 이용하여 object에 접근함
+  // 1. 파라미터로 주어진 oid를 이용하여 object에 접근함, 읽는 동안 page를
+  // shared mode로 latch 함
   MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
-  BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-  obj = (Object *)&(apage->data[apage->slot[(oid->slotNo) * -1].offset]);
+  e = eduom_LatchPage(&pid, LATCH_SHARED);
+  if (e < eNOERROR) ERR(e);
 
-  // 2. 파라미터로 주어진 start 및 length를 고려하여 접근한 object의 데이터를
-  // 읽음
-  // 3. 해당 데이터에 대한 포인터를 반환함
-  if (length == REMAINDER) length = obj->header.length;
-  memcpy(buf, &(obj->data[start]), length);
+  e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERR(e);
+  }
 
-  BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots ||
+      !IS_VALID_OBJECTID(oid, apage)) {
+    eduom_UnlatchPage(&pid);
+    ERRB1(eBADOBJECTID_OM, (TrainID *)&pid, PAGE_BUF);
+  }
+
+  offset = apage->slot[-(oid->slotNo)].offset;
+  obj = (Object *)&(apage->data[offset]);
+
+  // 이동된 object인 경우, forwarded object에서 데이터를 읽음
+  // Page latch를 하나만 가진 채로 다른 page latch를 기다리도록, forwarded
+  // object를 읽기 전에 latch를 해제함
+  if (obj->header.properties & P_MOVED) {
+    fwdOid = *((ObjectID *)obj->data);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    eduom_UnlatchPage(&pid);
+    if (e < eNOERROR) ERR(e);
+
+    e = eduom_ReadObject(&fwdOid, start, length, buf);
+
+    // 그 사이에 object가 다시 이동되어 forwarded object가 삭제된 경우,
+    // 이동된 object를 다시 찾아 읽음
+    if (e == eBADOBJECTID_OM && eduom_IsForwardedTo(oid, &fwdOid) == FALSE)
+      e = eduom_ReadObject(oid, start, length, buf);
+
+    return (e);
+  }
+
+  // 2. 파라미터로 주어진 start 및 length를 고려하여 읽을 범위를 정함
+  // Object의 끝을 넘는 범위는 읽지 않음
+  e = eNOERROR;
+  if (start > obj->header.length) e = eBADSTART_OM;
+
+  if (e == eNOERROR) {
+    if (length == REMAINDER || start + length > obj->header.length)
+      length = obj->header.length - start;
+
+    // 3. 해당 범위의 데이터를 읽음
+    // Large object인 경우, large object tree에서 해당 범위만 읽음
+    if (obj->header.properties & P_LRGOBJ) {
+      e = LOT_ReadObject(&pid, oid->slotNo, start, length, buf);
+    } else {
+      memcpy(buf, &(obj->data[start]), length);
+    }
+  }
+
+  eduom_UnlatchPage(&pid);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+
+  e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
 
   return (length);
 
-} /* EduOM_ReadObject() */
+} /* eduom_ReadObject() */
+
+/*@================================
+ * eduom_IsForwardedTo()
+ *================================*/
+/*
+ * Function: Boolean eduom_IsForwardedTo(ObjectID*, ObjectID*)
+ *
+ * Description :
+ *  Check whether the object identified by 'oid' is still a moved object
+ *  whose forwarded object is 'fwdOid'.
+ *
+ * Returns:
+ *  TRUE if 'oid' is still forwarded to 'fwdOid' or cannot be read,
+ *  otherwise FALSE
+ */
+Boolean eduom_IsForwardedTo(ObjectID *oid,    /* IN moved object */
+                            ObjectID *fwdOid) /* IN its forwarded object */
+{
+  Four e;             /* error code */
+  PageID pid;         /* page containing object specified by 'oid' */
+  SlottedPage *apage; /* pointer to the buffer of the page  */
+  Object *obj;        /* pointer to the object in the slotted page */
+  Boolean forwarded;  /* TRUE if 'oid' is forwarded to 'fwdOid' */
+
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  e = eduom_LatchPage(&pid, LATCH_SHARED);
+  if (e < eNOERROR) return (TRUE);
+
+  e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    return (TRUE);
+  }
+
+  forwarded = TRUE;
+  if (oid->slotNo >= 0 && oid->slotNo < apage->header.nSlots &&
+      IS_VALID_OBJECTID(oid, apage)) {
+    obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+    if (!(obj->header.properties & P_MOVED) ||
+        !EQUAL_OBJECTID(*((ObjectID *)obj->data), *fwdOid))
+      forwarded = FALSE;
+  }
+
+  BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  eduom_UnlatchPage(&pid);
+
+  return (forwarded);
+
+} /* eduom_IsForwardedTo() */
@@ -0,0 +1,507 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_Readahead.c
+ *
+ * Description :
+ *  Readahead for the sequential scans of a data file. While a scan consumes a
+ *  page, the next pages of the page list of the file are read into the
+ *  buffer pool, so that the scan finds them there. The buffer manager has no
+ *  asynchronous read, so a scan hands a request to read the next pages to a
+ *  readahead worker thread and goes on with its page; the worker fixes the
+ *  pages of the requests in order. A scan makes a new request when the pages
+ *  requested ahead of it drop to half the readahead window.
+ *
+ *  The worker keeps the pages it has read fixed for the scan until the scan
+ *  has passed them. A page fixed by another thread is found in the fixed
+ *  page table, so the scan fixes and frees the pages read ahead without the
+ *  storage latch, which the worker holds while it reads a page from disk;
+ *  the worker frees the pages the scan has passed. The worker reads the next
+ *  page of a page holding its latch shared, and stops following the page
+ *  list at a page which cannot be read or belongs to another file.
+ *
+ *  The requests are hints: a request is dropped when the queue is full. A
+ *  scan waits for its last request to be done and frees the pages kept for
+ *  it when it is closed or moved to another page.
+ *
+ * Exports:
+ *  Four EduOM_SetReadahead(Four)
+ *  Four eduom_InitReadahead(ReadaheadInfo*)
+ *  Four eduom_RestartReadahead(ReadaheadInfo*)
+ *  Four eduom_Readahead(ReadaheadInfo*, PageID*, SlottedPage*, ShortPageID)
+ *  Four eduom_FinalReadahead(ReadaheadInfo*)
+ *
+ * Internal Functions:
+ *  void eduom_StartReadaheadWorker(void)
+ *  void *eduom_ReadaheadWorker(void*)
+ *  void eduom_ReadPages(ReadaheadRequest*)
+ *  Four eduom_FreePassedPages(ReadaheadInfo*)
+ *  void eduom_WaitReadahead(ReadaheadInfo*)
+ */
+
+#include <pthread.h>
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+/* max # of requests waiting for the worker */
+#define READAHEAD_QUEUE_SIZE 32
+
+/* request to read pages of a page list ahead of a scan */
+typedef struct {
+  ReadaheadInfo *ra;    /* readahead state of the scan */
+  FileID fid;           /* file of the page list */
+  PageID firstPid;      /* first page to read */
+  ShortPageID lastPage; /* last page to read, NIL if up to the end */
+  Four nPages;          /* # of pages to read */
+  Four ticket;          /* sequence number of the request */
+} ReadaheadRequest;
+
+void eduom_StartReadaheadWorker(void);
+void *eduom_ReadaheadWorker(void *);
+void eduom_ReadPages(ReadaheadRequest *);
+Four eduom_FreePassedPages(ReadaheadInfo *);
+void eduom_WaitReadahead(ReadaheadInfo *);
+
+/* # of pages read ahead of a scan, 0 if disabled */
+static Four readaheadPages = READAHEAD_DEFAULT_PAGES;
+
+static pthread_once_t raWorkerOnce = PTHREAD_ONCE_INIT;
+static Boolean raWorkerRunning = FALSE; /* is the worker started? */
+
+static pthread_mutex_t raMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t raQueuedCond = PTHREAD_COND_INITIALIZER; /* new request */
+static pthread_cond_t raDoneCond = PTHREAD_COND_INITIALIZER;   /* request done */
+
+static ReadaheadRequest raQueue[READAHEAD_QUEUE_SIZE]; /* waiting requests */
+static Four raHead = 0;       /* index of the first waiting request */
+static Four raCount = 0;      /* # of waiting requests */
+static Four raLastTicket = 0; /* ticket of the last queued request */
+static Four raDoneTicket = 0; /* ticket of the last done request */
+
+/*@================================
+ * EduOM_SetReadahead()
+ *================================*/
+/*
+ * Function: Four EduOM_SetReadahead(Four)
+ *
+ * Description :
+ *  Set the number of pages read ahead of the sequential scans. 0 disables
+ *  the readahead. Up to one and a half windows of pages are kept fixed for
+ *  each scan, so the window should be small compared to the buffer pool.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_SetReadahead(Four nPages) /* IN # of pages to read ahead */
+{
+  if (nPages < 0 || nPages > READAHEAD_MAX_PAGES) ERR(eBADPARAMETER_OM);
+
+  readaheadPages = nPages;
+
+  return (eNOERROR);
+
+} /* EduOM_SetReadahead() */
+
+/*@================================
+ * eduom_InitReadahead()
+ *================================*/
+/*
+ * Function: Four eduom_InitReadahead(ReadaheadInfo*)
+ *
+ * Description :
+ *  Initialize the readahead state of a newly opened scan.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four eduom_InitReadahead(ReadaheadInfo *ra) /* OUT readahead state */
+{
+  ra->nAhead = 0;
+  ra->ticket = 0;
+  ra->nHeld = 0;
+  ra->nPassed = 0;
+
+  return (eNOERROR);
+
+} /* eduom_InitReadahead() */
+
+/*@================================
+ * eduom_RestartReadahead()
+ *================================*/
+/*
+ * Function: Four eduom_RestartReadahead(ReadaheadInfo*)
+ *
+ * Description :
+ *  Forget the pages requested ahead of a scan which is moved to another
+ *  page; the next call of eduom_Readahead() makes a new request. The last
+ *  request of the scan is waited for and the pages kept for it are freed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_RestartReadahead(ReadaheadInfo *ra) /* INOUT readahead state */
+{
+  Four e; /* error number */
+
+  eduom_WaitReadahead(ra);
+
+  ra->nPassed = ra->nHeld;
+  e = eduom_FreePassedPages(ra);
+  if (e < eNOERROR) ERR(e);
+
+  ra->nAhead = 0;
+
+  return (eNOERROR);
+
+} /* eduom_RestartReadahead() */
+
+/*@================================
+ * eduom_Readahead()
+ *================================*/
+/*
+ * Function: Four eduom_Readahead(ReadaheadInfo*, PageID*, SlottedPage*,
+ * ShortPageID)
+ *
+ * Description :
+ *  Called when a forward scan moves onto the page 'pid', which it has fixed.
+ *  Mark the pages kept for the scan before the page as passed. Then request
+ *  the worker to read the pages following the page in the page list of the
+ *  file into the buffer pool, up to the readahead window, stopping after
+ *  the page 'lastPage'. The pages are not waited for.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_Readahead(ReadaheadInfo *ra,    /* INOUT readahead state */
+                     PageID *pid,          /* IN page the scan is on */
+                     SlottedPage *apage,   /* IN buffer of the page */
+                     ShortPageID lastPage) /* IN last page to read */
+{
+  Four e;                /* error number */
+  Four i;                /* index */
+  ShortPageID nextPage;  /* next page of the page */
+  FileID fid;            /* file of the page */
+  ReadaheadRequest *req; /* request to be queued */
+
+  // 1. 현재 page가 요청해 둔 page인 경우, 요청해 둔 page의 수를 줄이고
+  // worker가 현재 page 앞에 고정해 둔 page들을 지나간 page로 표시함
+  if (ra->nAhead > 0) ra->nAhead--;
+
+  pthread_mutex_lock(&raMutex);
+
+  for (i = ra->nPassed; i < ra->nHeld; i++) {
+    if (EQUAL_PAGEID(ra->held[i], *pid)) {
+      ra->nPassed = i;
+      break;
+    }
+  }
+
+  pthread_mutex_unlock(&raMutex);
+
+  // 2. 요청해 둔 page의 수가 window의 절반보다 많거나 다음 page가 없는
+  // 경우, 요청하지 않음
+  if (readaheadPages == 0 || ra->nAhead > readaheadPages / 2)
+    return (eNOERROR);
+
+  if (pid->pageNo == lastPage) return (eNOERROR);
+
+  e = eduom_LatchPage(pid, LATCH_SHARED);
+  if (e < eNOERROR) ERR(e);
+
+  nextPage = apage->header.nextPage;
+  fid = apage->header.fid;
+
+  e = eduom_UnlatchPage(pid);
+  if (e < eNOERROR) ERR(e);
+
+  if (nextPage == NIL) return (eNOERROR);
+
+  pthread_once(&raWorkerOnce, eduom_StartReadaheadWorker);
+  if (!raWorkerRunning) return (eNOERROR);
+
+  // 3. 현재 page의 다음 page부터 window 만큼의 page를 읽도록 worker에게
+  // 요청함
+  // Queue가 가득 찬 경우, 요청을 버림
+  pthread_mutex_lock(&raMutex);
+
+  if (raCount < READAHEAD_QUEUE_SIZE) {
+    req = &raQueue[(raHead + raCount) % READAHEAD_QUEUE_SIZE];
+    req->ra = ra;
+    req->fid = fid;
+    MAKE_PAGEID(req->firstPid, pid->volNo, nextPage);
+    req->lastPage = lastPage;
+    req->nPages = readaheadPages;
+    req->ticket = ++raLastTicket;
+    raCount++;
+
+    ra->nAhead = readaheadPages;
+    ra->ticket = req->ticket;
+
+    pthread_cond_signal(&raQueuedCond);
+  }
+
+  pthread_mutex_unlock(&raMutex);
+
+  return (eNOERROR);
+
+} /* eduom_Readahead() */
+
+/*@================================
+ * eduom_FinalReadahead()
+ *================================*/
+/*
+ * Function: Four eduom_FinalReadahead(ReadaheadInfo*)
+ *
+ * Description :
+ *  Wait until the worker has done the last request of a scan being closed,
+ *  and free the pages kept for the scan.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FinalReadahead(ReadaheadInfo *ra) /* INOUT readahead state */
+{
+  Four e; /* error number */
+
+  eduom_WaitReadahead(ra);
+
+  ra->nPassed = ra->nHeld;
+  e = eduom_FreePassedPages(ra);
+  if (e < eNOERROR) ERR(e);
+
+  ra->nAhead = 0;
+  ra->ticket = 0;
+
+  return (eNOERROR);
+
+} /* eduom_FinalReadahead() */
+
+/*@================================
+ * eduom_WaitReadahead()
+ *================================*/
+/*
+ * Function: void eduom_WaitReadahead(ReadaheadInfo*)
+ *
+ * Description :
+ *  Wait until the worker has done the last request of a scan. After that
+ *  the worker no longer uses the readahead state of the scan.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_WaitReadahead(ReadaheadInfo *ra) /* IN readahead state */
+{
+  if (ra->ticket == 0) return;
+
+  pthread_mutex_lock(&raMutex);
+
+  while (raDoneTicket < ra->ticket) pthread_cond_wait(&raDoneCond, &raMutex);
+
+  pthread_mutex_unlock(&raMutex);
+
+} /* eduom_WaitReadahead() */
+
+/*@================================
+ * eduom_FreePassedPages()
+ *================================*/
+/*
+ * Function: Four eduom_FreePassedPages(ReadaheadInfo*)
+ *
+ * Description :
+ *  Free the pages kept for a scan which the scan has passed, and remove
+ *  them from the kept pages. Called by the worker, or by the scan when no
+ *  request of it is waiting.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FreePassedPages(ReadaheadInfo *ra) /* INOUT readahead state */
+{
+  Four e;                             /* error number */
+  Four e2;                            /* error number of the cleanup */
+  Four i;                             /* index */
+  Four nPassed;                       /* # of the passed pages */
+  PageID passed[READAHEAD_HELD_PAGES]; /* the passed pages */
+
+  // 1. 지나간 page들을 유지하는 page들에서 제거함
+  pthread_mutex_lock(&raMutex);
+
+  nPassed = ra->nPassed;
+  for (i = 0; i < nPassed; i++) passed[i] = ra->held[i];
+  for (i = nPassed; i < ra->nHeld; i++) ra->held[i - nPassed] = ra->held[i];
+  ra->nHeld -= nPassed;
+  ra->nPassed = 0;
+
+  pthread_mutex_unlock(&raMutex);
+
+  // 2. 지나간 page들을 free함
+  e = eNOERROR;
+  for (i = 0; i < nPassed; i++) {
+    e2 = BfM_FreeTrain((TrainID *)&passed[i], PAGE_BUF);
+    if (e >= eNOERROR) e = e2;
+  }
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_FreePassedPages() */
+
+/*@================================
+ * eduom_StartReadaheadWorker()
+ *================================*/
+/*
+ * Function: void eduom_StartReadaheadWorker(void)
+ *
+ * Description :
+ *  Start the readahead worker thread. Called once. If the thread cannot be
+ *  created, the scans read no pages ahead.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_StartReadaheadWorker(void)
+{
+  pthread_t worker; /* the readahead worker */
+
+  if (pthread_create(&worker, NULL, eduom_ReadaheadWorker, NULL) != 0) return;
+
+  pthread_detach(worker);
+  raWorkerRunning = TRUE;
+
+} /* eduom_StartReadaheadWorker() */
+
+/*@================================
+ * eduom_ReadaheadWorker()
+ *================================*/
+/*
+ * Function: void *eduom_ReadaheadWorker(void*)
+ *
+ * Description :
+ *  Body of the readahead worker thread. Do the requests in the order they
+ *  are queued, waiting when there is none.
+ *
+ * Returns:
+ *  None
+ */
+void *eduom_ReadaheadWorker(void *arg) /* IN not used */
+{
+  ReadaheadRequest req; /* request being done */
+
+  (void)arg;
+
+  pthread_mutex_lock(&raMutex);
+
+  for (;;) {
+    while (raCount == 0) pthread_cond_wait(&raQueuedCond, &raMutex);
+
+    req = raQueue[raHead];
+    raHead = (raHead + 1) % READAHEAD_QUEUE_SIZE;
+    raCount--;
+
+    // Page를 읽는 동안 scan이 요청을 추가할 수 있도록 mutex를 놓음
+    pthread_mutex_unlock(&raMutex);
+    eduom_ReadPages(&req);
+    pthread_mutex_lock(&raMutex);
+
+    raDoneTicket = req.ticket;
+    pthread_cond_broadcast(&raDoneCond);
+  }
+
+} /* eduom_ReadaheadWorker() */
+
+/*@================================
+ * eduom_ReadPages()
+ *================================*/
+/*
+ * Function: void eduom_ReadPages(ReadaheadRequest*)
+ *
+ * Description :
+ *  Read the pages of a request into the buffer pool, following the page
+ *  list from its first page, and keep them fixed for the scan. The pages
+ *  the scan has passed are freed first. The worker holds no latch on the
+ *  file, so the list may change meanwhile; the next page is read under the
+ *  page latch, and the read stops at the first page which cannot be read,
+ *  belongs to another file, or cannot be kept.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_ReadPages(ReadaheadRequest *req) /* IN request to do */
+{
+  Four e;                /* error number */
+  Four i;                /* # of pages read */
+  ReadaheadInfo *ra;     /* readahead state of the scan */
+  PageID raPid;          /* page to read ahead */
+  SlottedPage *raPage;   /* pointer to the buffer of the page */
+  ShortPageID next;      /* next page of the page */
+  Boolean inFile;        /* does the page belong to the file? */
+
+  ra = req->ra;
+  raPid = req->firstPid;
+
+  for (i = 0; i < req->nPages && raPid.pageNo != NIL; i++) {
+    // 1. Scan이 지나간 page들을 free함
+    e = eduom_FreePassedPages(ra);
+    if (e < eNOERROR) return;
+
+    if (ra->nHeld == READAHEAD_HELD_PAGES) return;
+
+    // 2. Page를 읽고, page latch를 잡은 채 다음 page를 읽음
+    e = BfM_GetTrain((TrainID *)&raPid, (char **)&raPage, PAGE_BUF);
+    if (e < eNOERROR) return;
+
+    e = eduom_LatchPage(&raPid, LATCH_SHARED);
+    if (e < eNOERROR) {
+      BfM_FreeTrain((TrainID *)&raPid, PAGE_BUF);
+      return;
+    }
+
+    inFile = EQUAL_FILEID(raPage->header.fid, req->fid);
+    next = (raPid.pageNo == req->lastPage) ? NIL : raPage->header.nextPage;
+
+    eduom_UnlatchPage(&raPid);
+
+    if (!inFile) {
+      BfM_FreeTrain((TrainID *)&raPid, PAGE_BUF);
+      return;
+    }
+
+    // 3. 읽은 page를 scan을 위해 고정된 채로 유지함
+    pthread_mutex_lock(&raMutex);
+    ra->held[ra->nHeld++] = raPid;
+    pthread_mutex_unlock(&raMutex);
+
+    raPid.pageNo = next;
+  }
+
+} /* eduom_ReadPages() */
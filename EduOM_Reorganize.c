@@ -0,0 +1,767 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_Reorganize.c
+ *
+ * Description :
+ *  Online reorganization of a data file. The pages of the file are visited
+ *  along the page list and
+ *   - a page without objects is released to the dealloc list, even if its
+ *     slot array is not empty,
+ *   - a sparse page (fill factor below the threshold) whose objects are all
+ *     bodies of moved objects(P_FORWARDED) is emptied and released: each
+ *     body is brought back into the page of its stub(P_MOVED) if that page
+ *     has room, or merged into the previous page of the file, and the stub
+ *     is set to the new body,
+ *   - any other page is compacted and the empty slots at the end of its slot
+ *     array are cut off.
+ *  The ObjectID of an object is the slot of the object or of its stub, so
+ *  the objects other than the bodies are never moved out of their pages;
+ *  all the ObjectIDs stay valid.
+ *
+ * Exports:
+ *  Four EduOM_ReorganizeFile(ObjectID*, Four, Pool*, DeallocListElem*, Four*)
+ *
+ * Internal Functions:
+ *  Four eduom_ReorganizeFile(ObjectID*, Four, Pool*, DeallocListElem*, Four*)
+ *  Four eduom_CollectStubs(sm_CatOverlayForData*, ShortPageID**, Four*,
+ *                          StubEntry**, Four*)
+ *  Four eduom_EmptyPage(ObjectID*, sm_CatOverlayForData*, PageID*, PageID*,
+ *                       StubEntry*, Four, Four, Pool*, DeallocListElem*)
+ *  Four eduom_MoveBody(ObjectID*, sm_CatOverlayForData*, StubEntry*, PageID*,
+ *                      Pool*, DeallocListElem*, Boolean*)
+ *  Four eduom_ReleasePage(ObjectID*, sm_CatOverlayForData*, PageID*, Pool*,
+ *                         DeallocListElem*, Boolean*)
+ *  Four eduom_RepackPage(ObjectID*, sm_CatOverlayForData*, PageID*)
+ *  int eduom_CompareStubEntry(const void*, const void*)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+/* size of the data area of a page which can hold objects */
+#define REORG_DATA_AREA ((Four)(PAGESIZE - SP_FIXED))
+
+/* maximum # of slots in a page */
+#define REORG_MAX_SLOTS (PAGESIZE / sizeof(SlottedPageSlot))
+
+/*
+ * Typedef for a stub of a moved object
+ */
+typedef struct {
+  ObjectID body;    /* body of the moved object (P_FORWARDED) */
+  ObjectID stub;    /* stub of the moved object (P_MOVED) */
+  ObjectHdr header; /* header of the stub */
+} StubEntry;
+
+Four eduom_ReorganizeFile(ObjectID *, Four, Pool *, DeallocListElem *, Four *);
+Four eduom_CollectStubs(sm_CatOverlayForData *, ShortPageID **, Four *,
+                        StubEntry **, Four *);
+Four eduom_EmptyPage(ObjectID *, sm_CatOverlayForData *, PageID *, PageID *,
+                     StubEntry *, Four, Four, Pool *, DeallocListElem *);
+Four eduom_MoveBody(ObjectID *, sm_CatOverlayForData *, StubEntry *, PageID *,
+                    Pool *, DeallocListElem *, Boolean *);
+Four eduom_ReleasePage(ObjectID *, sm_CatOverlayForData *, PageID *, Pool *,
+                       DeallocListElem *, Boolean *);
+Four eduom_RepackPage(ObjectID *, sm_CatOverlayForData *, PageID *);
+int eduom_CompareStubEntry(const void *, const void *);
+
+/*@================================
+ * EduOM_ReorganizeFile()
+ *================================*/
+/*
+ * Function: Four EduOM_ReorganizeFile(ObjectID*, Four, Pool*,
+ * DeallocListElem*, Four*)
+ *
+ * Description :
+ *  Reorganize the given data file online. The pages whose fill factor, the
+ *  percentage of the data area not available for new objects, is below
+ *  'fillThreshold' are merged into other pages if only bodies of moved
+ *  objects are left in them. The released pages are inserted into the
+ *  dealloc list. The file is latched in exclusive mode during the
+ *  reorganization; the readers of objects are not blocked except for the
+ *  page being changed.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter nReleased
+ *     'nReleased' is set to the number of the released pages if not NULL
+ */
+Four EduOM_ReorganizeFile(
+    ObjectID *catObjForFile, /* IN file to reorganize */
+    Four fillThreshold,      /* IN fill factor(%) below which pages merge */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead, /* INOUT head of dealloc list */
+    Four *nReleased)         /* OUT # of released pages */
+{
+  Four e;  /* error number */
+  Four e2; /* error number of the cleanup */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (fillThreshold < 0 || fillThreshold > 100) ERR(eBADPARAMETER_OM);
+
+  if (dlPool == NULL || dlHead == NULL) ERR(eBADPARAMETER_OM);
+
+  e = eduom_LatchFile(catObjForFile, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_ReorganizeFile(catObjForFile, fillThreshold, dlPool, dlHead,
+                           nReleased);
+
+  eduom_UnlatchFile(catObjForFile);
+
+  // Cache 된 element들을 pool에 반환함
+  e2 = eduom_FlushElementPool(dlPool);
+  if (e >= eNOERROR) e = e2;
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_ReorganizeFile() */
+
+/*@================================
+ * eduom_ReorganizeFile()
+ *================================*/
+/*
+ * Function: Four eduom_ReorganizeFile(ObjectID*, Four, Pool*,
+ * DeallocListElem*, Four*)
+ *
+ * Description :
+ *  Reorganize the file for EduOM_ReorganizeFile(). The caller holds the
+ *  exclusive latch on the file.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_ReorganizeFile(
+    ObjectID *catObjForFile, /* IN file to reorganize */
+    Four fillThreshold,      /* IN fill factor(%) below which pages merge */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead, /* INOUT head of dealloc list */
+    Four *nReleased)         /* OUT # of released pages */
+{
+  Four e;                         /* error number */
+  Four i;                         /* index variable */
+  Four n;                         /* # of released pages */
+  SlottedPage *catPage;           /* buffer page containing the catalog */
+  sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+  ShortPageID *pages;             /* pages of the file in the page list order */
+  Four nPages;                    /* # of entries of 'pages' */
+  StubEntry *stubs;               /* stubs of the file sorted by the body */
+  Four nStubs;                    /* # of entries of 'stubs' */
+  PageID pid;                     /* current page */
+  PageID sinkPid;                 /* page into which bodies are merged */
+  Boolean released;               /* is the current page released? */
+
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+  // 1. File의 page 목록과 이동된 object들의 stub 목록을 만듦
+  // Page를 해제하면 page list가 바뀌므로 미리 만든 목록을 따라 page를 방문함
+  e = eduom_CollectStubs(catEntry, &pages, &nPages, &stubs, &nStubs);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  // 2. 각 page를 page list의 순서대로 재구성함
+  n = 0;
+  MAKE_PAGEID(sinkPid, catEntry->fid.volNo, NIL);
+  for (i = 0; i < nPages; i++) {
+    MAKE_PAGEID(pid, catEntry->fid.volNo, pages[i]);
+
+    // 2-1. Fill factor가 threshold 보다 작고 이동된 object의 body만 있는
+    // page의 body들을 다른 page로 옮김
+    e = eduom_EmptyPage(catObjForFile, catEntry, &pid, &sinkPid, stubs, nStubs,
+                        fillThreshold, dlPool, dlHead);
+    if (e < eNOERROR) break;
+
+    // 2-2. Object가 없는 page를 해제하고, 그렇지 않은 page는 compact 함
+    e = eduom_ReleasePage(catObjForFile, catEntry, &pid, dlPool, dlHead,
+                          &released);
+    if (e < eNOERROR) break;
+
+    if (released) {
+      n++;
+    } else {
+      e = eduom_RepackPage(catObjForFile, catEntry, &pid);
+      if (e < eNOERROR) break;
+      sinkPid = pid;
+    }
+  }
+
+  free(pages);
+  free(stubs);
+  BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  if (nReleased != NULL) *nReleased = n;
+
+  return (eNOERROR);
+
+} /* eduom_ReorganizeFile() */
+
+/*@================================
+ * eduom_CollectStubs()
+ *================================*/
+/*
+ * Function: Four eduom_CollectStubs(sm_CatOverlayForData*, ShortPageID**,
+ * Four*, StubEntry**, Four*)
+ *
+ * Description :
+ *  Collect the pages of the file in the order of the page list and the
+ *  stubs of the moved objects of the file, sorted by the ObjectID of the
+ *  body. The caller must free 'pages' and 'stubs'.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUOM
+ *    some errors caused by function calls
+ */
+Four eduom_CollectStubs(
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    ShortPageID **pages,            /* OUT pages of the file */
+    Four *nPages,                   /* OUT # of entries of 'pages' */
+    StubEntry **stubs,              /* OUT stubs of the file */
+    Four *nStubs)                   /* OUT # of entries of 'stubs' */
+{
+  Four e;                /* error number */
+  Two i;                 /* index variable */
+  Four maxPages;         /* # of entries allocated for 'pages' */
+  Four maxStubs;         /* # of entries allocated for 'stubs' */
+  void *newArray;        /* reallocated array */
+  PageID pid;            /* current page */
+  SlottedPage *apage;    /* buffer holding the current page */
+  ShortPageID nextPage;  /* next page of the current page */
+  Object *obj;           /* object in the page */
+
+  maxPages = maxStubs = 64;
+  *nPages = *nStubs = 0;
+  *pages = (ShortPageID *)malloc(sizeof(ShortPageID) * maxPages);
+  *stubs = (StubEntry *)malloc(sizeof(StubEntry) * maxStubs);
+
+  e = (*pages == NULL || *stubs == NULL) ? eMEMORYALLOCERR_EDUOM : eNOERROR;
+  MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+  while (e >= eNOERROR && pid.pageNo != NIL) {
+    // 1. Page를 page 목록에 추가함
+    if (*nPages == maxPages) {
+      maxPages *= 2;
+      newArray = realloc(*pages, sizeof(ShortPageID) * maxPages);
+      if (newArray == NULL) {
+        e = eMEMORYALLOCERR_EDUOM;
+        break;
+      }
+      *pages = (ShortPageID *)newArray;
+    }
+    (*pages)[(*nPages)++] = pid.pageNo;
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) break;
+
+    // 2. Page의 stub들을 stub 목록에 추가함
+    for (i = 0; i < apage->header.nSlots; i++) {
+      if (apage->slot[-i].offset == EMPTYSLOT) continue;
+
+      obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+      if (!(obj->header.properties & P_MOVED)) continue;
+
+      if (*nStubs == maxStubs) {
+        maxStubs *= 2;
+        newArray = realloc(*stubs, sizeof(StubEntry) * maxStubs);
+        if (newArray == NULL) {
+          e = eMEMORYALLOCERR_EDUOM;
+          break;
+        }
+        *stubs = (StubEntry *)newArray;
+      }
+
+      (*stubs)[*nStubs].body = *((ObjectID *)obj->data);
+      MAKE_OBJECTID((*stubs)[*nStubs].stub, pid.volNo, pid.pageNo, i,
+                    apage->slot[-i].unique);
+      (*stubs)[*nStubs].header = obj->header;
+      (*nStubs)++;
+    }
+
+    nextPage =
+        (pid.pageNo == catEntry->lastPage) ? NIL : apage->header.nextPage;
+
+    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+
+    pid.pageNo = nextPage;
+  }
+
+  if (e < eNOERROR) {
+    free(*pages);
+    free(*stubs);
+    ERR(e);
+  }
+
+  qsort(*stubs, *nStubs, sizeof(StubEntry), eduom_CompareStubEntry);
+
+  return (eNOERROR);
+
+} /* eduom_CollectStubs() */
+
+/*@================================
+ * eduom_EmptyPage()
+ *================================*/
+/*
+ * Function: Four eduom_EmptyPage(ObjectID*, sm_CatOverlayForData*, PageID*,
+ * PageID*, StubEntry*, Four, Four, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  If the fill factor of the page is below 'fillThreshold' and all objects
+ *  of the page are bodies of moved objects, move the bodies out of the page.
+ *  The first page of the file is never emptied since it is not released,
+ *  nor is a page holding pinned objects. The moving stops at the first body
+ *  which does not fit elsewhere.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_EmptyPage(
+    ObjectID *catObjForFile,        /* IN file containing the page */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    PageID *pid,                    /* IN page to empty */
+    PageID *sinkPid,                /* IN page into which bodies merge */
+    StubEntry *stubs,               /* IN stubs sorted by the body */
+    Four nStubs,                    /* IN # of entries of 'stubs' */
+    Four fillThreshold,             /* IN fill factor(%) below which to empty */
+    Pool *dlPool,                   /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)        /* INOUT head of dealloc list */
+{
+  Four e;                      /* error number */
+  Two i;                       /* index variable */
+  SlottedPage *apage;          /* buffer holding the page */
+  Object *obj;                 /* object in the page */
+  StubEntry key;               /* entry to search for */
+  StubEntry *found;            /* stub of a body */
+  StubEntry *bodies;           /* stubs of the bodies of the page */
+  Four nBodies;                /* # of entries of 'bodies' */
+  Boolean movable;             /* can all objects be moved? */
+  Boolean moved;               /* is the body moved? */
+
+  if (pid->pageNo == catEntry->firstPage) return (eNOERROR);
+
+  bodies = (StubEntry *)malloc(sizeof(StubEntry) * REORG_MAX_SLOTS);
+  if (bodies == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+  // 1. Page의 모든 object가 stub을 가진 body인지 확인함
+  e = eduom_LatchPage(pid, LATCH_SHARED);
+  if (e < eNOERROR) {
+    free(bodies);
+    ERR(e);
+  }
+
+  e = BfM_GetTrain((TrainID *)pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(pid);
+    free(bodies);
+    ERR(e);
+  }
+
+  // Pin 된 object가 있는 page의 object는 이동할 수 없으므로 제외함
+  movable = !eduom_IsPinnedPage(pid) &&
+            (REORG_DATA_AREA - (Four)SP_FREE(apage)) * 100 <
+                fillThreshold * REORG_DATA_AREA;
+  nBodies = 0;
+  for (i = 0; movable && i < apage->header.nSlots; i++) {
+    if (apage->slot[-i].offset == EMPTYSLOT) continue;
+
+    obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+    if (!(obj->header.properties & P_FORWARDED) ||
+        (obj->header.properties & P_LRGOBJ)) {
+      movable = FALSE;
+      break;
+    }
+
+    key.body.volNo = pid->volNo;
+    key.body.pageNo = pid->pageNo;
+    key.body.slotNo = i;
+    found = (StubEntry *)bsearch(&key, stubs, nStubs, sizeof(StubEntry),
+                                 eduom_CompareStubEntry);
+    if (found == NULL || found->body.unique != apage->slot[-i].unique) {
+      movable = FALSE;
+      break;
+    }
+
+    bodies[nBodies++] = *found;
+  }
+
+  BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+  eduom_UnlatchPage(pid);
+
+  // 2. Body들을 다른 page로 옮김
+  e = eNOERROR;
+  for (i = 0; movable && i < nBodies; i++) {
+    e = eduom_MoveBody(catObjForFile, catEntry, &bodies[i], sinkPid, dlPool,
+                       dlHead, &moved);
+    if (e < eNOERROR || !moved) break;
+  }
+
+  free(bodies);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_EmptyPage() */
+
+/*@================================
+ * eduom_MoveBody()
+ *================================*/
+/*
+ * Function: Four eduom_MoveBody(ObjectID*, sm_CatOverlayForData*, StubEntry*,
+ * PageID*, Pool*, DeallocListElem*, Boolean*)
+ *
+ * Description :
+ *  Move the body of a moved object out of its page. The body is brought
+ *  back into the slot of its stub if the page of the stub has room, so that
+ *  the object is not moved any more; otherwise the body is created in the
+ *  page 'sinkPid' if it has room and the stub is set to the new body. The
+ *  old body is destroyed. If neither page has room or the object is pinned,
+ *  nothing is changed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter moved
+ *     'moved' is set to TRUE if the body is moved
+ */
+Four eduom_MoveBody(
+    ObjectID *catObjForFile,        /* IN file containing the object */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    StubEntry *entry,               /* IN stub of the body to move */
+    PageID *sinkPid,                /* IN page into which the body merges */
+    Pool *dlPool,                   /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead,        /* INOUT head of dealloc list */
+    Boolean *moved)                 /* OUT is the body moved? */
+{
+  Four e;             /* error number */
+  PageID pid;         /* page of the body */
+  SlottedPage *apage; /* buffer holding a page */
+  Object *obj;        /* body in the page */
+  ObjectHdr bodyHdr;  /* header of the body */
+  ObjectHdr newHdr;   /* header of the object after the move */
+  ObjectID nearObj;   /* object in the sink page */
+  ObjectID newBody;   /* new body of the object */
+  Four length;        /* length of the object */
+  Boolean hasRoom;    /* does the sink page have room? */
+  char data[PAGESIZE]; /* data of the object */
+
+  *moved = FALSE;
+
+  // Pin 된 object는 옮길 수 없으므로 그대로 둠
+  if (eduom_IsPinnedObject(&entry->stub) || eduom_IsPinnedObject(&entry->body))
+    return (eNOERROR);
+
+  // 1. Body의 header와 데이터를 읽음
+  MAKE_PAGEID(pid, entry->body.volNo, entry->body.pageNo);
+  e = eduom_LatchPage(&pid, LATCH_SHARED);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERR(e);
+  }
+
+  obj = (Object *)&(apage->data[apage->slot[-(entry->body.slotNo)].offset]);
+  bodyHdr = obj->header;
+  length = entry->header.length;
+  memcpy(data, obj->data, length);
+
+  BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  eduom_UnlatchPage(&pid);
+
+  // 2. Stub이 저장된 page에 여유 공간이 있는 경우, object를 stub의 slot으로
+  // 다시 옮김
+  newHdr = entry->header;
+  newHdr.properties &= ~P_MOVED;
+  e = eduom_RewriteInPage(catObjForFile, catEntry, &entry->stub, &newHdr, 0,
+                          length, data, moved);
+  if (e < eNOERROR) ERR(e);
+
+  // 3. 그렇지 않은 경우, sink page에 여유 공간이 있으면 sink page에 새로운
+  // body를 만들고 stub이 새로운 body를 가리키도록 함
+  if (!*moved && sinkPid->pageNo != NIL) {
+    e = BfM_GetTrain((TrainID *)sinkPid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    hasRoom = eduom_HasRoomInPage(sinkPid, apage,
+                                  sizeof(ObjectHdr) + ALIGNED_LENGTH(length) +
+                                      sizeof(SlottedPageSlot));
+
+    e = BfM_FreeTrain((TrainID *)sinkPid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (hasRoom) {
+      MAKE_OBJECTID(nearObj, sinkPid->volNo, sinkPid->pageNo, NIL, 0);
+      newHdr = bodyHdr;
+      newHdr.length = 0;
+      e = eduom_CreateObject(catObjForFile, &nearObj, &newHdr, length, data,
+                             &newBody);
+      if (e < eNOERROR) ERR(e);
+
+      e = eduom_RewriteInPage(catObjForFile, catEntry, &entry->stub,
+                              &entry->header, 0, sizeof(ObjectID),
+                              (char *)&newBody, moved);
+      if (e >= eNOERROR && !*moved) e = eNOTSUPPORTED_EDUOM;
+      if (e < eNOERROR) {
+        eduom_DestroyObject(catObjForFile, &newBody, dlPool, dlHead);
+        ERR(e);
+      }
+    }
+  }
+
+  // 4. 이전의 body를 삭제함
+  if (*moved) {
+    e = eduom_DestroyObject(catObjForFile, &entry->body, dlPool, dlHead);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  return (eNOERROR);
+
+} /* eduom_MoveBody() */
+
+/*@================================
+ * eduom_ReleasePage()
+ *================================*/
+/*
+ * Function: Four eduom_ReleasePage(ObjectID*, sm_CatOverlayForData*, PageID*,
+ * Pool*, DeallocListElem*, Boolean*)
+ *
+ * Description :
+ *  Release the page if it has no object, as EduOM_DestroyObject() does when
+ *  the last slot of a page is removed. A page with no slot has already been
+ *  released by EduOM_DestroyObject(). The first page of the file is not
+ *  released.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter released
+ *     'released' is set to TRUE if the page is (or has been) released
+ */
+Four eduom_ReleasePage(
+    ObjectID *catObjForFile,        /* IN file containing the page */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    PageID *pid,                    /* IN page to release */
+    Pool *dlPool,                   /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead,        /* INOUT head of dealloc list */
+    Boolean *released)              /* OUT is the page released? */
+{
+  Four e;                  /* error number */
+  Four e2;                 /* error number of the cleanup */
+  Two i;                   /* index variable */
+  SlottedPage *apage;      /* buffer holding the page */
+  DeallocListElem *dlElem; /* pointer to element of dealloc list */
+
+  *released = FALSE;
+  if (pid->pageNo == catEntry->firstPage) return (eNOERROR);
+
+  e = eduom_LatchPage(pid, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain((TrainID *)pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(pid);
+    ERR(e);
+  }
+
+  if (apage->header.nSlots == 0) {
+    *released = TRUE;
+    BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    eduom_UnlatchPage(pid);
+    return (eNOERROR);
+  }
+
+  for (i = 0; i < apage->header.nSlots; i++)
+    if (apage->slot[-i].offset != EMPTYSLOT) break;
+
+  if (i < apage->header.nSlots) {
+    BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    eduom_UnlatchPage(pid);
+    return (eNOERROR);
+  }
+
+  // Dealloc list element를 먼저 할당 받은 후, page를 available space list 및
+  // file 구성 page들로 이루어진 list에서 삭제하고, dealloc list의 첫 번째
+  // element로 삽입함
+  // Page를 삭제하지 못한 경우, page가 유실되지 않도록 page를 file에 남겨 두고
+  // available space list에 다시 삽입함
+  e = eduom_GetElementFromPool(dlPool, &dlElem);
+  if (e < eNOERROR) {
+    BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    eduom_UnlatchPage(pid);
+    ERR(e);
+  }
+
+  e = eduom_RemoveFromAvailSpaceList(catObjForFile, catEntry, pid, apage);
+  if (e >= eNOERROR) {
+    e = eduom_UnlinkPage(catObjForFile, pid, apage);
+    if (e < eNOERROR) om_PutInAvailSpaceList(catObjForFile, pid, apage);
+  }
+
+  if (e < eNOERROR) {
+    eduom_FreeElementToPool(dlPool, dlElem);
+  } else {
+    eduom_InvalidateCatalogDesc(catObjForFile);
+
+    dlElem->type = DL_PAGE;
+    dlElem->elem.pid = *pid;
+    dlElem->next = dlHead->next;
+    dlHead->next = dlElem;
+    *released = TRUE;
+
+    // 해제할 page를 free space map 및 삽입 page 목록에서 삭제함
+    e = eduom_FsmSetFreeSpace(&catEntry->fid, pid->pageNo, 0);
+    if (e >= eNOERROR) e = eduom_DropPartitionPage(&catEntry->fid, pid->pageNo);
+  }
+
+  e2 = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  eduom_UnlatchPage(pid);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_ReleasePage() */
+
+/*@================================
+ * eduom_RepackPage()
+ *================================*/
+/*
+ * Function: Four eduom_RepackPage(ObjectID*, sm_CatOverlayForData*, PageID*)
+ *
+ * Description :
+ *  Cut off the empty slots at the end of the slot array of the page and
+ *  compact the page unless it holds pinned objects. The page is put into the
+ *  proper available space list and the free space map is updated if its
+ *  free space changes.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_RepackPage(
+    ObjectID *catObjForFile,        /* IN file containing the page */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    PageID *pid)                    /* IN page to repack */
+{
+  Four e;             /* error number */
+  Four e2;            /* error number of the cleanup */
+  Two nSlots;         /* # of slots after the cut */
+  SlottedPage *apage; /* buffer holding the page */
+
+  e = eduom_LatchPage(pid, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain((TrainID *)pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(pid);
+    ERR(e);
+  }
+
+  nSlots = apage->header.nSlots;
+  while (nSlots > 0 && apage->slot[-(nSlots - 1)].offset == EMPTYSLOT)
+    nSlots--;
+
+  if (nSlots == apage->header.nSlots && apage->header.unused == 0) {
+    BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    eduom_UnlatchPage(pid);
+    return (eNOERROR);
+  }
+
+  // 1. Slot array 끝의 빈 slot들을 잘라냄
+  // 잘라낸 slot들이 빈 slot chain에 남지 않도록 chain을 다시 만들게 함
+  e = eNOERROR;
+  if (nSlots != apage->header.nSlots) {
+    e = eduom_RemoveFromAvailSpaceList(catObjForFile, catEntry, pid, apage);
+    if (e >= eNOERROR) {
+      apage->header.nSlots = nSlots;
+      apage->header.flags &= ~SLOT_FREELIST_VALID;
+      e = om_PutInAvailSpaceList(catObjForFile, pid, apage);
+    }
+    if (e >= eNOERROR)
+      e = eduom_FsmSetFreeSpace(&catEntry->fid, pid->pageNo, SP_FREE(apage));
+  }
+
+  // 2. Unused 영역이 있는 경우 page를 compact 함
+  // Pin 된 object가 있는 page는 compact 되지 않으므로 그대로 둠
+  if (e >= eNOERROR && apage->header.unused > 0) {
+    e = EduOM_CompactPage(apage, NIL);
+    if (e == eOBJECTPINNED_EDUOM) e = eNOERROR;
+  }
+
+  e2 = BfM_SetDirty((TrainID *)pid, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  e2 = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+  if (e >= eNOERROR) e = e2;
+  eduom_UnlatchPage(pid);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_RepackPage() */
+
+/*@================================
+ * eduom_CompareStubEntry()
+ *================================*/
+/*
+ * Function: int eduom_CompareStubEntry(const void*, const void*)
+ *
+ * Description :
+ *  Compare two stubs by the page and the slot of their bodies.
+ *
+ * Returns:
+ *  negative, zero or positive as the first body is before, at or after the
+ *  second one
+ */
+int eduom_CompareStubEntry(const void *a, /* IN first entry */
+                           const void *b) /* IN second entry */
+{
+  ObjectID *x = &((StubEntry *)a)->body; /* first body */
+  ObjectID *y = &((StubEntry *)b)->body; /* second body */
+
+  if (x->pageNo != y->pageNo) return (x->pageNo < y->pageNo) ? -1 : 1;
+
+  return (x->slotNo < y->slotNo) ? -1 : (x->slotNo > y->slotNo);
+
+} /* eduom_CompareStubEntry() */
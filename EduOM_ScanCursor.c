@@ -0,0 +1,440 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_ScanCursor.c
+ *
+ * Description :
+ *  Stateful scan cursor on a data file. The cursor keeps the current page
+ *  fixed and pinned across calls, so that a page is fixed only once while
+ *  the cursor moves within it and its objects are not moved by the page
+ *  compaction in the meantime.
+ *
+ * Exports:
+ *  Four EduOM_OpenScanCursor(ObjectID*, ScanCursor*)
+ *  Four EduOM_NextScanCursor(ScanCursor*, ObjectID*, ObjectHdr*)
+ *  Four EduOM_PrevScanCursor(ScanCursor*, ObjectID*, ObjectHdr*)
+ *  Four EduOM_CloseScanCursor(ScanCursor*)
+ *
+ * Internal Functions:
+ *  Four eduom_RefreshScanCursor(ScanCursor*)
+ *  Four eduom_MoveScanCursor(ScanCursor*, ShortPageID)
+ *  Four eduom_GetCursorObject(ScanCursor*, ObjectID*, ObjectHdr*)
+ */
+
+#include "BfM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+/* slot number positioning the cursor after the last slot of its page */
+#define CURSOR_END_OF_PAGE (PAGESIZE / sizeof(SlottedPageSlot))
+
+Four eduom_RefreshScanCursor(ScanCursor *);
+Four eduom_MoveScanCursor(ScanCursor *, ShortPageID);
+Four eduom_GetCursorObject(ScanCursor *, ObjectID *, ObjectHdr *);
+
+/*@================================
+ * EduOM_OpenScanCursor()
+ *================================*/
+/*
+ * Function: Four EduOM_OpenScanCursor(ObjectID*, ScanCursor*)
+ *
+ * Description:
+ *  Open a scan cursor on the given data file. The cursor is not positioned;
+ *  the first call of EduOM_NextScanCursor() returns the first object of the
+ *  file and the first call of EduOM_PrevScanCursor() returns the last one.
+ *  After a scan call returns EOS, the cursor is not positioned again. The
+ *  first and the last page of the file are read again from the catalog
+ *  cache whenever the cursor reaches a page boundary, so that the pages
+ *  linked to the file after the cursor is opened are scanned as well.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter cursor
+ *     cursor is initialized to hold the state of the scan
+ */
+Four EduOM_OpenScanCursor(
+    ObjectID *catObjForFile, /* IN informations about a data file */
+    ScanCursor *cursor)      /* OUT the scan cursor */
+{
+  Four e;                     /* error */
+  eduom_CatalogDesc catDesc;  /* cached catalog information of the file */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+  // Cache 된 catalog 정보에서 file의 volume 번호를 얻음
+  e = eduom_GetCatalogDesc(catObjForFile, &catDesc);
+  if (e < eNOERROR) ERR(e);
+
+  cursor->catObjForFile = *catObjForFile;
+  cursor->firstPage = catDesc.firstPage;
+  cursor->lastPage = catDesc.lastPage;
+  MAKE_PAGEID(cursor->pid, catDesc.fid.volNo, NIL);
+  cursor->apage = NULL;
+  cursor->slotNo = NIL;
+  eduom_InitReadahead(&(cursor->ra));
+
+  return (eNOERROR);
+
+} /* EduOM_OpenScanCursor() */
+
+/*@================================
+ * EduOM_NextScanCursor()
+ *================================*/
+/*
+ * Function: Four EduOM_NextScanCursor(ScanCursor*, ObjectID*, ObjectHdr*)
+ *
+ * Description:
+ *  Move the cursor to the next object and return its identifier. Find the
+ *  next object in the current page, and if there is no next object in the
+ *  page, find it from the next page. Empty slots are skipped. The slot
+ *  array is read holding the page latch in shared mode, so that it is not
+ *  read while the page is compacted. The pages following the current page
+ *  are read ahead into the buffer pool.
+ *
+ * Returns:
+ *  1) error code
+ *    eBADPARAMETER_OM
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ *  2) EOS (End Of Scan) if there is no next object
+ *
+ * Side effect:
+ *  1) parameter nextOID
+ *     nextOID is filled with the next object's identifier
+ *  2) parameter objHdr
+ *     objHdr is filled with the next object's header (if not NULL)
+ */
+Four EduOM_NextScanCursor(ScanCursor *cursor, /* INOUT the scan cursor */
+                          ObjectID *nextOID,  /* OUT the next object */
+                          ObjectHdr *objHdr)  /* OUT header of next object */
+{
+  Four e;               /* error */
+  Two i;                /* index */
+  ShortPageID nextPage; /* next page of the current page */
+
+  /*@ parameter checking */
+  if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+  if (nextOID == NULL) ERR(eBADOBJECTID_OM);
+
+  // 1. Cursor가 위치하지 않은 경우, file의 첫 번째 page로 이동함
+  // 다음 page들을 buffer pool로 미리 읽어 들임
+  if (cursor->apage == NULL) {
+    e = eduom_RefreshScanCursor(cursor);
+    if (e < eNOERROR) ERR(e);
+
+    e = eduom_MoveScanCursor(cursor, cursor->firstPage);
+    if (e < eNOERROR) ERR(e);
+    cursor->slotNo = NIL;
+
+    eduom_RestartReadahead(&(cursor->ra));
+    e = eduom_Readahead(&(cursor->ra), &(cursor->pid), cursor->apage,
+                        cursor->lastPage);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  for (;;) {
+    // 2. 현재 page를 shared mode로 latch 하고, slot array 상에서 다음
+    // object를 탐색함
+    e = eduom_LatchPage(&(cursor->pid), LATCH_SHARED);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = cursor->slotNo + 1; i < cursor->apage->header.nSlots; i++) {
+      if (IS_SCANNED_SLOT(cursor->apage, i)) {
+        cursor->slotNo = i;
+        e = eduom_GetCursorObject(cursor, nextOID, objHdr);
+        eduom_UnlatchPage(&(cursor->pid));
+        return (e);
+      }
+    }
+
+    nextPage = cursor->apage->header.nextPage;
+
+    eduom_UnlatchPage(&(cursor->pid));
+
+    // 3. 현재 page에 다음 object가 없는 경우 다음 page로 이동함
+    // 현재 page가 file의 마지막 page인 경우, EOS (End Of Scan) 를 반환함
+    e = eduom_RefreshScanCursor(cursor);
+    if (e < eNOERROR) ERR(e);
+
+    if (cursor->pid.pageNo == cursor->lastPage) nextPage = NIL;
+
+    e = eduom_MoveScanCursor(cursor, nextPage);
+    if (e < eNOERROR) ERR(e);
+
+    if (cursor->apage == NULL) return (EOS);
+    cursor->slotNo = NIL;
+
+    e = eduom_Readahead(&(cursor->ra), &(cursor->pid), cursor->apage,
+                        cursor->lastPage);
+    if (e < eNOERROR) ERR(e);
+  }
+
+} /* EduOM_NextScanCursor() */
+
+/*@================================
+ * EduOM_PrevScanCursor()
+ *================================*/
+/*
+ * Function: Four EduOM_PrevScanCursor(ScanCursor*, ObjectID*, ObjectHdr*)
+ *
+ * Description:
+ *  Move the cursor to the previous object and return its identifier. Find
+ *  the previous object in the current page, and if there is no previous
+ *  object in the page, find it from the previous page. Empty slots are
+ *  skipped. The slot array is read holding the page latch in shared mode.
+ *
+ * Returns:
+ *  1) error code
+ *    eBADPARAMETER_OM
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ *  2) EOS (End Of Scan) if there is no previous object
+ *
+ * Side effect:
+ *  1) parameter prevOID
+ *     prevOID is filled with the previous object's identifier
+ *  2) parameter objHdr
+ *     objHdr is filled with the previous object's header (if not NULL)
+ */
+Four EduOM_PrevScanCursor(ScanCursor *cursor, /* INOUT the scan cursor */
+                          ObjectID *prevOID,  /* OUT the previous object */
+                          ObjectHdr *objHdr)  /* OUT header of prev object */
+{
+  Four e;               /* error */
+  Two i;                /* index */
+  ShortPageID prevPage; /* previous page of the current page */
+
+  /*@ parameter checking */
+  if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+  if (prevOID == NULL) ERR(eBADOBJECTID_OM);
+
+  // 1. Cursor가 위치하지 않은 경우, file의 마지막 page로 이동함
+  if (cursor->apage == NULL) {
+    e = eduom_RefreshScanCursor(cursor);
+    if (e < eNOERROR) ERR(e);
+
+    e = eduom_MoveScanCursor(cursor, cursor->lastPage);
+    if (e < eNOERROR) ERR(e);
+    cursor->slotNo = CURSOR_END_OF_PAGE;
+    eduom_RestartReadahead(&(cursor->ra));
+  }
+
+  for (;;) {
+    // 2. 현재 page를 shared mode로 latch 하고, slot array 상에서 이전
+    // object를 탐색함
+    // Page compaction으로 slot 수가 줄어든 경우, 마지막 slot부터 탐색함
+    e = eduom_LatchPage(&(cursor->pid), LATCH_SHARED);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = MIN(cursor->slotNo, cursor->apage->header.nSlots) - 1; i >= 0;
+         i--) {
+      if (IS_SCANNED_SLOT(cursor->apage, i)) {
+        cursor->slotNo = i;
+        e = eduom_GetCursorObject(cursor, prevOID, objHdr);
+        eduom_UnlatchPage(&(cursor->pid));
+        return (e);
+      }
+    }
+
+    prevPage = cursor->apage->header.prevPage;
+
+    eduom_UnlatchPage(&(cursor->pid));
+
+    // 3. 현재 page에 이전 object가 없는 경우 이전 page로 이동함
+    // 현재 page가 file의 첫 번째 page인 경우, EOS (End Of Scan) 를 반환함
+    e = eduom_RefreshScanCursor(cursor);
+    if (e < eNOERROR) ERR(e);
+
+    if (cursor->pid.pageNo == cursor->firstPage) prevPage = NIL;
+
+    e = eduom_MoveScanCursor(cursor, prevPage);
+    if (e < eNOERROR) ERR(e);
+
+    if (cursor->apage == NULL) return (EOS);
+    cursor->slotNo = CURSOR_END_OF_PAGE;
+
+    // 요청해 둔 page들은 forward scan의 다음 page들이므로 readahead를 다시
+    // 시작함
+    eduom_RestartReadahead(&(cursor->ra));
+  }
+
+} /* EduOM_PrevScanCursor() */
+
+/*@================================
+ * EduOM_CloseScanCursor()
+ *================================*/
+/*
+ * Function: Four EduOM_CloseScanCursor(ScanCursor*)
+ *
+ * Description:
+ *  Close the scan cursor, releasing the page fixed and pinned by the cursor. The pages
+ *  requested to be read ahead of the cursor are waited for.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_CloseScanCursor(ScanCursor *cursor) /* INOUT the scan cursor */
+{
+  Four e; /* error */
+
+  /*@ parameter checking */
+  if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+  e = eduom_MoveScanCursor(cursor, NIL);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_FinalReadahead(&(cursor->ra));
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_CloseScanCursor() */
+
+/*@================================
+ * eduom_RefreshScanCursor()
+ *================================*/
+/*
+ * Function: Four eduom_RefreshScanCursor(ScanCursor*)
+ *
+ * Description:
+ *  Read the first and the last page of the file again from the catalog
+ *  cache. The pages are linked to or unlinked from the file while the
+ *  cursor is open.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_RefreshScanCursor(ScanCursor *cursor) /* INOUT the scan cursor */
+{
+  Four e;                     /* error */
+  eduom_CatalogDesc catDesc;  /* cached catalog information of the file */
+
+  e = eduom_GetCatalogDesc(&(cursor->catObjForFile), &catDesc);
+  if (e < eNOERROR) ERR(e);
+
+  cursor->firstPage = catDesc.firstPage;
+  cursor->lastPage = catDesc.lastPage;
+
+  return (eNOERROR);
+
+} /* eduom_RefreshScanCursor() */
+
+/*@================================
+ * eduom_MoveScanCursor()
+ *================================*/
+/*
+ * Function: Four eduom_MoveScanCursor(ScanCursor*, ShortPageID)
+ *
+ * Description:
+ *  Unpin and free the page fixed by the cursor, and fix and pin the page
+ *  'pageNo' instead. The whole page is pinned, so that the page compaction
+ *  does not move the objects under the cursor. If 'pageNo' is NIL, the
+ *  cursor is left on no page.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_MoveScanCursor(ScanCursor *cursor, /* INOUT the scan cursor */
+                          ShortPageID pageNo) /* IN page to move to */
+{
+  Four e; /* error */
+
+  if (cursor->apage != NULL) {
+    cursor->apage = NULL;
+
+    e = eduom_UnpinPage(&(cursor->pid), NIL);
+    if (e < eNOERROR) ERRB1(e, (TrainID *)&(cursor->pid), PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)&(cursor->pid), PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  cursor->pid.pageNo = pageNo;
+
+  if (pageNo != NIL) {
+    e = BfM_GetTrain((TrainID *)&(cursor->pid), (char **)&(cursor->apage),
+                     PAGE_BUF);
+    if (e < eNOERROR) {
+      cursor->apage = NULL;
+      ERR(e);
+    }
+
+    e = eduom_PinPage(&(cursor->pid), NIL);
+    if (e < eNOERROR) {
+      cursor->apage = NULL;
+      ERRB1(e, (TrainID *)&(cursor->pid), PAGE_BUF);
+    }
+  }
+
+  return (eNOERROR);
+
+} /* eduom_MoveScanCursor() */
+
+/*@================================
+ * eduom_GetCursorObject()
+ *================================*/
+/*
+ * Function: Four eduom_GetCursorObject(ScanCursor*, ObjectID*, ObjectHdr*)
+ *
+ * Description:
+ *  Return the identifier and the header of the object on which the cursor
+ *  is positioned. The caller holds the latch of the current page.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four eduom_GetCursorObject(ScanCursor *cursor, /* IN the scan cursor */
+                           ObjectID *oid,      /* OUT the current object */
+                           ObjectHdr *objHdr)  /* OUT header of the object */
+{
+  Object *obj; /* a pointer to the Object */
+
+  MAKE_OBJECTID(*oid, cursor->pid.volNo, cursor->pid.pageNo, cursor->slotNo,
+                cursor->apage->slot[-(cursor->slotNo)].unique);
+
+  if (objHdr != NULL) {
+    obj = (Object *)&(
+        cursor->apage->data[cursor->apage->slot[-(cursor->slotNo)].offset]);
+    *objHdr = obj->header;
+  }
+
+  return (eNOERROR);
+
+} /* eduom_GetCursorObject() */
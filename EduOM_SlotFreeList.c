@@ -0,0 +1,175 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_SlotFreeList.c
+ *
+ * Description :
+ *  Chain of the empty slots of a slotted page. The slot number of the first
+ *  empty slot is kept in the 'reserved' field of the page header and each
+ *  empty slot keeps the slot number of the next one in its 'unique' field,
+ *  which is meaningless while the slot is empty. The chain is used only when
+ *  SLOT_FREELIST_VALID is set in the page flags; pages written without the
+ *  chain, or whose chain turns out to be inconsistent, get the chain rebuilt
+ *  by scanning the slot array once. The chain is kept in ascending order,
+ *  so the lowest empty slot is reused first as with the scan of the slot
+ *  array.
+ *
+ * Exports:
+ *  Two eduom_AllocSlot(SlottedPage*)
+ *  void eduom_FreeSlot(SlottedPage*, Two)
+ *
+ * Internal Functions:
+ *  void eduom_RebuildSlotFreeList(SlottedPage*)
+ */
+
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+void eduom_RebuildSlotFreeList(SlottedPage *);
+
+/*@================================
+ * eduom_AllocSlot()
+ *================================*/
+/*
+ * Function: Two eduom_AllocSlot(SlottedPage*)
+ *
+ * Description :
+ *  Take an empty slot of the page from the chain of the empty slots. If there
+ *  is no empty slot, 'nSlots' of the page is returned, i.e. a new slot at the
+ *  end of the slot array is to be used; the caller must update 'nSlots'.
+ *
+ * Returns:
+ *  slot number to be used
+ */
+Two eduom_AllocSlot(SlottedPage *apage) /* INOUT page to allocate a slot in */
+{
+  Two slotNo;    /* first empty slot */
+  Four nScanned; /* # of slots visited */
+
+  // 1. Chain이 유효하지 않은 경우 slot array를 읽어 chain을 다시 만듦
+  nScanned = 1;
+  if (!(apage->header.flags & SLOT_FREELIST_VALID)) {
+    eduom_RebuildSlotFreeList(apage);
+    nScanned += apage->header.nSlots;
+  }
+
+  // 2. Chain의 첫 번째 slot이 실제로 빈 slot이 아닌 경우 chain을 다시 만듦
+  slotNo = apage->header.reserved;
+  if (slotNo != NIL &&
+      (slotNo < 0 || slotNo >= apage->header.nSlots ||
+       apage->slot[-slotNo].offset != EMPTYSLOT)) {
+    eduom_RebuildSlotFreeList(apage);
+    nScanned += apage->header.nSlots;
+    slotNo = apage->header.reserved;
+  }
+
+  eduom_StatsAddSlotScan(nScanned);
+
+  if (slotNo == NIL) return (apage->header.nSlots);
+
+  // 3. Chain에서 첫 번째 slot을 삭제함
+  apage->header.reserved = (Two)apage->slot[-slotNo].unique;
+
+  return (slotNo);
+
+} /* eduom_AllocSlot() */
+
+/*@================================
+ * eduom_FreeSlot()
+ *================================*/
+/*
+ * Function: void eduom_FreeSlot(SlottedPage*, Two)
+ *
+ * Description :
+ *  Insert the emptied slot into the chain of the empty slots. The slot must
+ *  already be set to EMPTYSLOT and be within 'nSlots'. The chain is kept in
+ *  ascending order so that the lowest empty slot is still used first; only
+ *  the empty slots lower than the emptied one are visited. If the chain is
+ *  not valid, nothing is done; it is rebuilt when it is next used.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_FreeSlot(SlottedPage *apage, /* INOUT page containing the slot */
+                    Two slotNo)         /* IN emptied slot */
+{
+  Two prev;      /* empty slot after which the slot is inserted */
+  Two next;      /* empty slot before which the slot is inserted */
+  Four nScanned; /* # of slots visited */
+
+  if (!(apage->header.flags & SLOT_FREELIST_VALID)) return;
+
+  // Chain에서 slotNo보다 작은 마지막 빈 slot을 찾아 그 뒤에 삽입함
+  prev = NIL;
+  next = apage->header.reserved;
+  for (nScanned = 0; next != NIL && next < slotNo; nScanned++) {
+    if (next >= apage->header.nSlots ||
+        apage->slot[-next].offset != EMPTYSLOT) {
+      // Chain이 일관되지 않은 경우 다음 사용 시 다시 만들도록 함
+      apage->header.flags &= ~SLOT_FREELIST_VALID;
+      return;
+    }
+    prev = next;
+    next = (Two)apage->slot[-next].unique;
+  }
+  eduom_StatsAddSlotScan(nScanned);
+
+  apage->slot[-slotNo].unique = next;
+  if (prev == NIL) {
+    apage->header.reserved = slotNo;
+  } else {
+    apage->slot[-prev].unique = slotNo;
+  }
+
+} /* eduom_FreeSlot() */
+
+/*@================================
+ * eduom_RebuildSlotFreeList()
+ *================================*/
+/*
+ * Function: void eduom_RebuildSlotFreeList(SlottedPage*)
+ *
+ * Description :
+ *  Rebuild the chain of the empty slots from the slot array. The slots are
+ *  chained in ascending order so that the lowest empty slot is used first.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_RebuildSlotFreeList(SlottedPage *apage) /* INOUT page */
+{
+  Two i; /* index variable */
+
+  apage->header.reserved = NIL;
+  for (i = apage->header.nSlots - 1; i >= 0; --i) {
+    if (apage->slot[-i].offset == EMPTYSLOT) {
+      apage->slot[-i].unique = apage->header.reserved;
+      apage->header.reserved = i;
+    }
+  }
+
+  apage->header.flags |= SLOT_FREELIST_VALID;
+
+} /* eduom_RebuildSlotFreeList() */
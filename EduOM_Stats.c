@@ -0,0 +1,462 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_Stats.c
+ *
+ * Description :
+ *  Statistics of the object manager: buffer fixes and unfixes, compactions
+ *  and the bytes moved by them, pages allocated, the source of the pages
+ *  selected for new objects, the lengths of the slot scans and the latency
+ *  histograms of the operations.
+ *
+ *  Every thread counts into its own block of counters without any latch;
+ *  the blocks are summed only when the statistics are read. A block holds
+ *  the counters of the whole object manager and of up to STATS_MAX_FILES
+ *  data files; the operations of the files beyond are counted only in the
+ *  whole. Only the operation, latency and placement counters are kept per
+ *  file, since the other events do not know the file they belong to. The
+ *  block of an exiting thread is kept and reused by a new thread, so its
+ *  counts are not lost.
+ *
+ * Exports:
+ *  Four EduOM_GetStats(ObjectID*, EduOM_Stats*)
+ *  Four EduOM_ResetStats(void)
+ *  EduOM_Stats *eduom_GetThreadStats(ObjectID*)
+ *  void eduom_StatsStartOp(struct timespec*)
+ *  void eduom_StatsEndOp(ObjectID*, Four, struct timespec*)
+ *  void eduom_StatsAddPlacement(ObjectID*, Four)
+ *  void eduom_StatsAddSlotScan(Four)
+ *
+ * Internal Functions:
+ *  StatsBlock *eduom_GetStatsBlock(void)
+ *  Four eduom_StatsBucket(unsigned long long, Four)
+ *  void eduom_AddStats(EduOM_Stats*, EduOM_Stats*)
+ *  void eduom_InitStats(void)
+ *  void eduom_FinalStats(void*)
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+
+/* counters of a thread */
+typedef struct _StatsBlock {
+  EduOM_Stats global;                        /* counters of the whole */
+  Four nFiles;                               /* # of files in 'files' */
+  ObjectID files[STATS_MAX_FILES];           /* catalog objects of the files */
+  EduOM_Stats fileStats[STATS_MAX_FILES];    /* counters of each file */
+  Boolean inUse;                             /* TRUE if a thread owns it */
+  struct _StatsBlock *next;                  /* next block in the list */
+} StatsBlock;
+
+StatsBlock *eduom_GetStatsBlock(void);
+Four eduom_StatsBucket(unsigned long long, Four);
+void eduom_AddStats(EduOM_Stats *, EduOM_Stats *);
+void eduom_InitStats(void);
+void eduom_FinalStats(void *);
+
+static pthread_once_t statsOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t statsKey; /* releases the block when a thread exits */
+static StatsBlock *statsBlocks = NULL; /* blocks of all the threads */
+
+/* protects the blocks */
+static pthread_mutex_t statsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread StatsBlock *myStatsBlock = NULL; /* block of this thread */
+
+/*@================================
+ * EduOM_GetStats()
+ *================================*/
+/*
+ * Function: Four EduOM_GetStats(ObjectID*, EduOM_Stats*)
+ *
+ * Description :
+ *  Sum the counters of all the threads for the data file, or for the whole
+ *  object manager if 'catObjForFile' is NULL. The counters being updated
+ *  by other threads may be read a little behind.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *
+ * Side Effects :
+ *  1) parameter stats
+ *     'stats' is set to the sum of the counters
+ */
+Four EduOM_GetStats(ObjectID *catObjForFile, /* IN file, NULL for the whole */
+                    EduOM_Stats *stats)      /* OUT statistics */
+{
+  StatsBlock *block; /* block of a thread */
+  Four i;            /* index */
+
+  if (stats == NULL) ERR(eBADPARAMETER_OM);
+
+  memset(stats, 0, sizeof(EduOM_Stats));
+
+  pthread_mutex_lock(&statsMutex);
+
+  for (block = statsBlocks; block != NULL; block = block->next) {
+    if (catObjForFile == NULL) {
+      eduom_AddStats(stats, &block->global);
+      continue;
+    }
+
+    for (i = 0; i < block->nFiles; i++) {
+      if (EQUAL_OBJECTID(block->files[i], *catObjForFile))
+        eduom_AddStats(stats, &block->fileStats[i]);
+    }
+  }
+
+  pthread_mutex_unlock(&statsMutex);
+
+  return (eNOERROR);
+
+} /* EduOM_GetStats() */
+
+/*@================================
+ * EduOM_ResetStats()
+ *================================*/
+/*
+ * Function: Four EduOM_ResetStats(void)
+ *
+ * Description :
+ *  Clear the counters of all the threads and forget the files counted.
+ *  The events counted by other threads during the reset may be lost.
+ *
+ * Returns:
+ *  error code
+ */
+Four EduOM_ResetStats(void)
+{
+  StatsBlock *block; /* block of a thread */
+
+  pthread_mutex_lock(&statsMutex);
+
+  for (block = statsBlocks; block != NULL; block = block->next) {
+    memset(&block->global, 0, sizeof(EduOM_Stats));
+    memset(block->fileStats, 0, sizeof(block->fileStats));
+    block->nFiles = 0;
+  }
+
+  pthread_mutex_unlock(&statsMutex);
+
+  return (eNOERROR);
+
+} /* EduOM_ResetStats() */
+
+/*@================================
+ * eduom_GetThreadStats()
+ *================================*/
+/*
+ * Function: EduOM_Stats *eduom_GetThreadStats(ObjectID*)
+ *
+ * Description :
+ *  Return the counters of the current thread for the data file, or for the
+ *  whole object manager if 'catObjForFile' is NULL.
+ *
+ * Returns:
+ *  pointer to the counters, NULL if the counters cannot be kept
+ */
+EduOM_Stats *eduom_GetThreadStats(
+    ObjectID *catObjForFile) /* IN file, NULL for the whole */
+{
+  StatsBlock *block; /* block of the current thread */
+  Four i;            /* index */
+
+  block = eduom_GetStatsBlock();
+  if (block == NULL) return (NULL);
+
+  if (catObjForFile == NULL) return (&block->global);
+
+  for (i = 0; i < block->nFiles; i++) {
+    if (EQUAL_OBJECTID(block->files[i], *catObjForFile))
+      return (&block->fileStats[i]);
+  }
+
+  if (block->nFiles == STATS_MAX_FILES) return (NULL);
+
+  // 처음 사용되는 file인 경우 새로운 counter를 할당함
+  pthread_mutex_lock(&statsMutex);
+  block->files[block->nFiles] = *catObjForFile;
+  memset(&block->fileStats[block->nFiles], 0, sizeof(EduOM_Stats));
+  block->nFiles++;
+  pthread_mutex_unlock(&statsMutex);
+
+  return (&block->fileStats[block->nFiles - 1]);
+
+} /* eduom_GetThreadStats() */
+
+/*@================================
+ * eduom_StatsStartOp()
+ *================================*/
+/*
+ * Function: void eduom_StatsStartOp(struct timespec*)
+ *
+ * Description :
+ *  Record the time when an operation starts.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_StatsStartOp(struct timespec *start) /* OUT start time */
+{
+  clock_gettime(CLOCK_MONOTONIC, start);
+
+} /* eduom_StatsStartOp() */
+
+/*@================================
+ * eduom_StatsEndOp()
+ *================================*/
+/*
+ * Function: void eduom_StatsEndOp(ObjectID*, Four, struct timespec*)
+ *
+ * Description :
+ *  Count the operation and its latency in the counters of the whole and,
+ *  if 'catObjForFile' is not NULL, of the data file.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_StatsEndOp(ObjectID *catObjForFile, /* IN file or NULL */
+                      Four op,                 /* IN STATS_OP_XXX */
+                      struct timespec *start)  /* IN start time */
+{
+  struct timespec end;     /* end time */
+  unsigned long long nsec; /* latency in nanoseconds */
+  Four bucket;             /* bucket of the latency histogram */
+  EduOM_Stats *stats;      /* counters to update */
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  nsec = (unsigned long long)(end.tv_sec - start->tv_sec) * 1000000000ULL +
+         end.tv_nsec - start->tv_nsec;
+  bucket = eduom_StatsBucket(nsec, STATS_NUM_LATENCY_BUCKETS);
+
+  stats = eduom_GetThreadStats(NULL);
+  if (stats == NULL) return;
+  stats->ops[op]++;
+  stats->latency[op][bucket]++;
+
+  if (catObjForFile != NULL) {
+    stats = eduom_GetThreadStats(catObjForFile);
+    if (stats == NULL) return;
+    stats->ops[op]++;
+    stats->latency[op][bucket]++;
+  }
+
+} /* eduom_StatsEndOp() */
+
+/*@================================
+ * eduom_StatsAddPlacement()
+ *================================*/
+/*
+ * Function: void eduom_StatsAddPlacement(ObjectID*, Four)
+ *
+ * Description :
+ *  Count a page selected for a new object by where it is found.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_StatsAddPlacement(ObjectID *catObjForFile, /* IN file */
+                             Four source) /* IN STATS_PLACE_XXX */
+{
+  EduOM_Stats *stats; /* counters to update */
+
+  stats = eduom_GetThreadStats(NULL);
+  if (stats == NULL) return;
+  stats->placements[source]++;
+
+  stats = eduom_GetThreadStats(catObjForFile);
+  if (stats == NULL) return;
+  stats->placements[source]++;
+
+} /* eduom_StatsAddPlacement() */
+
+/*@================================
+ * eduom_StatsAddSlotScan()
+ *================================*/
+/*
+ * Function: void eduom_StatsAddSlotScan(Four)
+ *
+ * Description :
+ *  Count a scan of the slot array which visits 'nSlots' slots.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_StatsAddSlotScan(Four nSlots) /* IN # of slots visited */
+{
+  EduOM_Stats *stats; /* counters to update */
+
+  stats = eduom_GetThreadStats(NULL);
+  if (stats == NULL) return;
+  stats->slotScans[eduom_StatsBucket(nSlots, STATS_NUM_SCAN_BUCKETS)]++;
+
+} /* eduom_StatsAddSlotScan() */
+
+/*@================================
+ * eduom_GetStatsBlock()
+ *================================*/
+/*
+ * Function: StatsBlock *eduom_GetStatsBlock(void)
+ *
+ * Description :
+ *  Return the block of the current thread. A block released by an exited
+ *  thread is reused, otherwise a new block is allocated.
+ *
+ * Returns:
+ *  pointer to the block, NULL if it cannot be allocated
+ */
+StatsBlock *eduom_GetStatsBlock(void)
+{
+  StatsBlock *block; /* block of the current thread */
+
+  if (myStatsBlock != NULL) return (myStatsBlock);
+
+  pthread_once(&statsOnce, eduom_InitStats);
+
+  pthread_mutex_lock(&statsMutex);
+
+  for (block = statsBlocks; block != NULL; block = block->next)
+    if (!block->inUse) break;
+
+  if (block == NULL) {
+    block = (StatsBlock *)malloc(sizeof(StatsBlock));
+    if (block == NULL) {
+      pthread_mutex_unlock(&statsMutex);
+      return (NULL);
+    }
+
+    memset(block, 0, sizeof(StatsBlock));
+    block->next = statsBlocks;
+    statsBlocks = block;
+  }
+  block->inUse = TRUE;
+
+  pthread_mutex_unlock(&statsMutex);
+
+  // Thread 종료 시 block을 다른 thread가 사용할 수 있도록 등록함
+  pthread_setspecific(statsKey, block);
+  myStatsBlock = block;
+
+  return (block);
+
+} /* eduom_GetStatsBlock() */
+
+/*@================================
+ * eduom_StatsBucket()
+ *================================*/
+/*
+ * Function: Four eduom_StatsBucket(unsigned long long, Four)
+ *
+ * Description :
+ *  Return the bucket of a logarithmic histogram for the value; bucket i
+ *  holds the values in [2^i, 2^(i+1)), bucket 0 also holds 0, and the last
+ *  bucket holds all the larger values.
+ *
+ * Returns:
+ *  bucket of the value
+ */
+Four eduom_StatsBucket(unsigned long long value, /* IN value to count */
+                       Four nBuckets)            /* IN # of buckets */
+{
+  Four bucket; /* bucket of the value */
+
+  if (value == 0) return (0);
+
+  bucket = 63 - __builtin_clzll(value);
+
+  return ((bucket < nBuckets) ? bucket : nBuckets - 1);
+
+} /* eduom_StatsBucket() */
+
+/*@================================
+ * eduom_AddStats()
+ *================================*/
+/*
+ * Function: void eduom_AddStats(EduOM_Stats*, EduOM_Stats*)
+ *
+ * Description :
+ *  Add the counters of 'from' to 'to'.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_AddStats(EduOM_Stats *to,   /* INOUT sum of the counters */
+                    EduOM_Stats *from) /* IN counters to add */
+{
+  StatsCounter *t; /* counter of 'to' */
+  StatsCounter *f; /* counter of 'from' */
+  Four i;          /* index */
+
+  // EduOM_Stats는 counter들로만 구성되므로 배열처럼 더함
+  t = (StatsCounter *)to;
+  f = (StatsCounter *)from;
+  for (i = 0; i < sizeof(EduOM_Stats) / sizeof(StatsCounter); i++) t[i] += f[i];
+
+} /* eduom_AddStats() */
+
+/*@================================
+ * eduom_InitStats()
+ *================================*/
+/*
+ * Function: void eduom_InitStats(void)
+ *
+ * Description :
+ *  Create the key whose destructor releases the block of an exiting thread.
+ *  Called once.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_InitStats(void)
+{
+  pthread_key_create(&statsKey, eduom_FinalStats);
+
+} /* eduom_InitStats() */
+
+/*@================================
+ * eduom_FinalStats()
+ *================================*/
+/*
+ * Function: void eduom_FinalStats(void*)
+ *
+ * Description :
+ *  Release the block of an exiting thread. The counts are kept.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_FinalStats(void *block) /* IN block of the exiting thread */
+{
+  pthread_mutex_lock(&statsMutex);
+  ((StatsBlock *)block)->inUse = FALSE;
+  pthread_mutex_unlock(&statsMutex);
+
+} /* eduom_FinalStats() */
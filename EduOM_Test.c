@@ -33,6 +33,7 @@
  */
 #include "EduOM.h"
 
+#include <ctype.h>
 #include <string.h>
 
 #include "EduOM_Internal.h"
@@ -31,6 +31,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "EduOM_common.h"
 #include "EduOM_Internal.h"
 #include "EduOM_TestModule.h"
@@ -51,6 +52,8 @@ Four main(int argc, char *argv[])
 	Four 	segmentSize;						/* size of a segment */
 	XactID 	xactId;								/* transaction identifier */
 	Boolean getcharFlag;						/* flag for getchar */
+	Boolean apiFlag;							/* flag for checking the interface functions */
+	Four	nFailed = 0;						/* # of failed API checks */
 
 	/*
 	 *   Initialize the storage system 
@@ -73,12 +76,13 @@ Four main(int argc, char *argv[])
 	
 
 	/* Initialize the variable for LRDS_FormatDataVolume */
+	apiFlag = argc > 1 && strcmp(argv[1], "api") == 0;
 	numDevices = 1;
 	devNames[0] = "test.vol";
 	title = "test";
 	volId = 1000;
 	extSize = 16;
-	numPagesInDevices[0] = 500;
+	numPagesInDevices[0] = apiFlag ? 4000 : 500;	/* the API checks keep destroyed files until commit */
 	segmentSize = 16;
 
 	/*
@@ -110,9 +114,15 @@ Four main(int argc, char *argv[])
 		LRDS_Final();
 	}
 	
-	/* Test EduOM */
-	getcharFlag = argc > 1 ? FALSE : TRUE;
-	e = EduOM_Test(volId, handle, getcharFlag);
+	/* Test EduOM, or check the interface functions with "api" */
+	if (apiFlag) {
+		e = EduOM_APITest(volId, handle);
+		if (e > 0) nFailed = e;
+	}
+	else {
+		getcharFlag = argc > 1 ? FALSE : TRUE;
+		e = EduOM_Test(volId, handle, getcharFlag);
+	}
 
 	if (e < eNOERROR){
 		printf("EduOM_Test failed!!!\n");
@@ -155,5 +165,5 @@ Four main(int argc, char *argv[])
 		exit(1);
 	}
 
-	return 0;
+	return (nFailed > 0) ? 1 : 0;
 }
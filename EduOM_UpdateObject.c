@@ -0,0 +1,764 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_UpdateObject.c
+ *
+ * Description :
+ *  EduOM_WriteObject(), EduOM_AppendToObject() and EduOM_TruncateObject()
+ *  change the data of an object. The object keeps its ObjectID even if it
+ *  does not fit into its page any more: its body is moved to another page as
+ *  a forwarded object(P_FORWARDED) and the original slot keeps a stub
+ *  (P_MOVED) holding the ObjectID of the body. The header of a stub keeps
+ *  the length of the object.
+ *
+ * Exports:
+ *  Four EduOM_WriteObject(ObjectID*, ObjectID*, Four, Four, char*, Pool*,
+ * DeallocListElem*)
+ *  Four EduOM_AppendToObject(ObjectID*, ObjectID*, Four, char*, Pool*,
+ * DeallocListElem*)
+ *  Four EduOM_TruncateObject(ObjectID*, ObjectID*, Four, Pool*,
+ * DeallocListElem*)
+ *  Four eduom_UpdateObject(ObjectID*, ObjectID*, Four, Four, char*, Four,
+ * Pool*, DeallocListElem*)
+ *  Four eduom_RewriteInPage(ObjectID*, sm_CatOverlayForData*, ObjectID*,
+ * ObjectHdr*, Four, Four, char*, Boolean*)
+ *  Boolean eduom_ResizeInPage(SlottedPage*, Two, Four)
+ *
+ * Internal Functions:
+ *  Four eduom_UpdateLargeObject(ObjectID*, ObjectID*, Four, Four, Four, Four,
+ * char*, Pool*, DeallocListElem*)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "BfM.h" /* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM_common.h"
+#include "LOT.h" /* for the large object manager call */
+
+Four eduom_UpdateLargeObject(ObjectID *, ObjectID *, Four, Four, Four, Four,
+                             char *, Pool *, DeallocListElem *);
+
+/* number of bytes an object with the given header occupies in its page */
+#define SPACE_FOR_HDR(hdr)                                  \
+  (((hdr)->properties & P_MOVED)                            \
+       ? (Four)(sizeof(ObjectHdr) + sizeof(ObjectID))       \
+       : (Four)(sizeof(ObjectHdr) + ALIGNED_LENGTH((hdr)->length)))
+
+/*@================================
+ * EduOM_WriteObject()
+ *================================*/
+/*
+ * Function: Four EduOM_WriteObject(ObjectID*, ObjectID*, Four, Four, char*,
+ * Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  Overwrite 'length' bytes of the object from 'start' with 'data'. If the
+ *  data goes beyond the end of the object, the object is extended. 'start'
+ *  must not be beyond the end of the object. The ObjectID of the object does
+ *  not change.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADSTART_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eOBJECTPINNED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_WriteObject(
+    ObjectID *catObjForFile, /* IN file containing the object */
+    ObjectID *oid,           /* IN object to update */
+    Four start,              /* IN starting offset of write */
+    Four length,             /* IN amount of data to write */
+    char *data,              /* IN data to write */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead) /* INOUT head of dealloc list */
+{
+  Four e;                  /* error number */
+  Four e2;                 /* error number of the cleanup */
+  struct timespec opStart; /* time when the operation starts */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+  if (start < 0) ERR(eBADSTART_OM);
+
+  if (length < 0) ERR(eBADLENGTH_OM);
+
+  if (length > 0 && data == NULL) ERR(eBADUSERBUF_OM);
+
+  eduom_StatsStartOp(&opStart);
+  e = eduom_LatchFile(catObjForFile, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) {
+    eduom_StatsEndOp(catObjForFile, STATS_OP_UPDATE, &opStart);
+    ERR(e);
+  }
+
+  e = eduom_UpdateObject(catObjForFile, oid, start, length, data, NIL, dlPool,
+                         dlHead);
+
+  eduom_UnlatchFile(catObjForFile);
+
+  // Cache 된 element들을 pool에 반환함
+  e2 = eduom_FlushElementPool(dlPool);
+  if (e >= eNOERROR) e = e2;
+  eduom_StatsEndOp(catObjForFile, STATS_OP_UPDATE, &opStart);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_WriteObject() */
+
+/*@================================
+ * EduOM_AppendToObject()
+ *================================*/
+/*
+ * Function: Four EduOM_AppendToObject(ObjectID*, ObjectID*, Four, char*,
+ * Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  Append 'length' bytes of 'data' to the end of the object. The ObjectID of
+ *  the object does not change.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eOBJECTPINNED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_AppendToObject(
+    ObjectID *catObjForFile, /* IN file containing the object */
+    ObjectID *oid,           /* IN object to update */
+    Four length,             /* IN amount of data to append */
+    char *data,              /* IN data to append */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead) /* INOUT head of dealloc list */
+{
+  Four e;                  /* error number */
+  Four e2;                 /* error number of the cleanup */
+  struct timespec opStart; /* time when the operation starts */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+  if (length < 0) ERR(eBADLENGTH_OM);
+
+  if (length > 0 && data == NULL) ERR(eBADUSERBUF_OM);
+
+  eduom_StatsStartOp(&opStart);
+  e = eduom_LatchFile(catObjForFile, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) {
+    eduom_StatsEndOp(catObjForFile, STATS_OP_UPDATE, &opStart);
+    ERR(e);
+  }
+
+  e = eduom_UpdateObject(catObjForFile, oid, REMAINDER, length, data, NIL,
+                         dlPool, dlHead);
+
+  eduom_UnlatchFile(catObjForFile);
+
+  // Cache 된 element들을 pool에 반환함
+  e2 = eduom_FlushElementPool(dlPool);
+  if (e >= eNOERROR) e = e2;
+  eduom_StatsEndOp(catObjForFile, STATS_OP_UPDATE, &opStart);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_AppendToObject() */
+
+/*@================================
+ * EduOM_TruncateObject()
+ *================================*/
+/*
+ * Function: Four EduOM_TruncateObject(ObjectID*, ObjectID*, Four, Pool*,
+ * DeallocListElem*)
+ *
+ * Description :
+ *  Cut the object to 'newLength' bytes. 'newLength' must not be greater than
+ *  the length of the object. A moved object is brought back into the page
+ *  of its stub if the page has room. Truncating a large object is not
+ *  supported.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    eOBJECTPINNED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_TruncateObject(
+    ObjectID *catObjForFile, /* IN file containing the object */
+    ObjectID *oid,           /* IN object to truncate */
+    Four newLength,          /* IN new length of the object */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead) /* INOUT head of dealloc list */
+{
+  Four e;                  /* error number */
+  Four e2;                 /* error number of the cleanup */
+  struct timespec opStart; /* time when the operation starts */
+
+  /*@ parameter checking */
+  if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+  if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+  if (newLength < 0) ERR(eBADLENGTH_OM);
+
+  eduom_StatsStartOp(&opStart);
+  e = eduom_LatchFile(catObjForFile, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) {
+    eduom_StatsEndOp(catObjForFile, STATS_OP_UPDATE, &opStart);
+    ERR(e);
+  }
+
+  e = eduom_UpdateObject(catObjForFile, oid, 0, 0, NULL, newLength, dlPool,
+                         dlHead);
+
+  eduom_UnlatchFile(catObjForFile);
+
+  // Cache 된 element들을 pool에 반환함
+  e2 = eduom_FlushElementPool(dlPool);
+  if (e >= eNOERROR) e = e2;
+  eduom_StatsEndOp(catObjForFile, STATS_OP_UPDATE, &opStart);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* EduOM_TruncateObject() */
+
+/*@================================
+ * eduom_UpdateObject()
+ *================================*/
+/*
+ * Function: Four eduom_UpdateObject(ObjectID*, ObjectID*, Four, Four, char*,
+ * Four, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  Replace 'length' bytes of the object from 'start' with 'data' and set the
+ *  length of the object to 'newLength'. If 'start' is REMAINDER, the data is
+ *  appended to the object. If 'newLength' is NIL, the object is extended to
+ *  hold the written data if needed; otherwise 'newLength' must not exceed
+ *  the end of the object or of the written data.
+ *
+ *  The object is updated in its page if the page has room. Otherwise the
+ *  object is moved to another page leaving a stub in its slot; the body of
+ *  an object already moved is brought back into the page of its stub if
+ *  that page has room, or is moved again.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    eBADSTART_OM
+ *    eBADLENGTH_OM
+ *    eMEMORYALLOCERR_EDUOM
+ *    eNOTSUPPORTED_EDUOM
+ *    eOBJECTPINNED_EDUOM
+ *    some errors caused by function calls
+ */
+Four eduom_UpdateObject(
+    ObjectID *catObjForFile, /* IN file containing the object */
+    ObjectID *oid,           /* IN object to update */
+    Four start,              /* IN starting offset, REMAINDER to append */
+    Four length,             /* IN amount of data to write */
+    char *data,              /* IN data to write */
+    Four newLength,          /* IN new length, NIL to extend as needed */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead) /* INOUT head of dealloc list */
+{
+  Four e;                         /* error number */
+  SlottedPage *catPage;           /* buffer page containing the catalog */
+  sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+  PageID pid;                     /* page of the object */
+  SlottedPage *apage;             /* pointer to the buffer of the page */
+  Object *obj;                    /* pointer to the object in the page */
+  ObjectHdr homeHdr;              /* header of the object in its own slot */
+  ObjectHdr newHdr;               /* header after the update */
+  ObjectID bodyOid;               /* body of the object */
+  ObjectID newBodyOid;            /* new body of the object */
+  Boolean moved;                  /* is the object moved to another page? */
+  Boolean large;                  /* is the object a large object? */
+  Boolean done;                   /* is the update done in the page? */
+  Four oldLength;                 /* length of the object before the update */
+  char *buf;                      /* new contents of the object */
+  Four cleanupErr;                /* error number of the cleanup */
+
+  // 1. Object의 slot에 저장된 header를 읽고, 이동된 object인 경우 이동된
+  // object의 ID를 얻음
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  e = eduom_LatchPage(&pid, LATCH_SHARED);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERR(e);
+  }
+
+  if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots ||
+      !IS_VALID_OBJECTID(oid, apage)) {
+    eduom_UnlatchPage(&pid);
+    ERRB1(eBADOBJECTID_OM, (TrainID *)&pid, PAGE_BUF);
+  }
+
+  // Pin 된 object는 갱신할 수 없음
+  // 갱신 도중 pin 되는 경우에 대비하여 object를 바꾸는 곳에서 다시 확인함
+  if (eduom_IsPinnedObject(oid)) {
+    eduom_UnlatchPage(&pid);
+    ERRB1(eOBJECTPINNED_EDUOM, (TrainID *)&pid, PAGE_BUF);
+  }
+
+  obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+  homeHdr = obj->header;
+  moved = (homeHdr.properties & P_MOVED) ? TRUE : FALSE;
+  bodyOid = moved ? *((ObjectID *)obj->data) : *oid;
+
+  e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  eduom_UnlatchPage(&pid);
+  if (e < eNOERROR) ERR(e);
+
+  large = (homeHdr.properties & P_LRGOBJ) ? TRUE : FALSE;
+  if (moved) {
+    MAKE_PAGEID(pid, bodyOid.volNo, bodyOid.pageNo);
+    e = eduom_LatchPage(&pid, LATCH_SHARED);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) {
+      eduom_UnlatchPage(&pid);
+      ERR(e);
+    }
+
+    obj = (Object *)&(apage->data[apage->slot[-(bodyOid.slotNo)].offset]);
+    if (obj->header.properties & P_LRGOBJ) large = TRUE;
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e >= eNOERROR && eduom_IsPinnedObject(&bodyOid))
+      e = eOBJECTPINNED_EDUOM;
+    eduom_UnlatchPage(&pid);
+    if (e < eNOERROR) ERR(e);
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  }
+
+  // 2. 갱신할 범위와 갱신 후의 object의 길이를 정함
+  oldLength = homeHdr.length;
+  if (start == REMAINDER) start = oldLength;
+  if (start > oldLength) ERR(eBADSTART_OM);
+  if (newLength == NIL) newLength = MAX(oldLength, start + length);
+  if (newLength < 0 || start + length > newLength ||
+      newLength > MAX(oldLength, start + length))
+    ERR(eBADLENGTH_OM);
+
+  // 3. Large object이거나 갱신 후 large object가 되는 경우, large object
+  // manager를 이용하여 갱신함
+  if (large || ALIGNED_LENGTH(newLength) > LRGOBJ_THRESHOLD) {
+    e = eduom_UpdateLargeObject(catObjForFile, &bodyOid, oldLength, newLength,
+                                start, length, data, dlPool, dlHead);
+    if (e < eNOERROR) ERR(e);
+
+    if (moved) {
+      e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+      if (e < eNOERROR) ERR(e);
+
+      e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+      if (e < eNOERROR) {
+        eduom_UnlatchPage(&pid);
+        ERR(e);
+      }
+
+      obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+      obj->header.length = newLength;
+
+      BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+      e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+      eduom_UnlatchPage(&pid);
+      if (e < eNOERROR) ERR(e);
+    }
+
+    return (eNOERROR);
+  }
+
+  e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+  // 4. Object의 body가 저장된 page에 여유 공간이 있는 경우, 해당 page에서
+  // object를 갱신함
+  newHdr = homeHdr;
+  newHdr.properties &= ~P_MOVED;
+  if (moved) newHdr.properties |= P_FORWARDED;
+  newHdr.length = newLength;
+
+  e = eduom_RewriteInPage(catObjForFile, catEntry, &bodyOid, &newHdr, start,
+                          length, data, &done);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+  if (done) {
+    // 이동된 object인 경우, stub에 저장된 object의 길이를 갱신함
+    if (moved) {
+      newHdr = homeHdr;
+      newHdr.length = newLength;
+      e = eduom_RewriteInPage(catObjForFile, catEntry, oid, &newHdr, 0, 0,
+                              NULL, &done);
+      if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+    }
+
+    e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return (eNOERROR);
+  }
+
+  // 5. 갱신 후의 object의 데이터 전체를 만듦
+  buf = (char *)malloc(MAX(newLength, 1));
+  if (buf == NULL)
+    ERRB1(eMEMORYALLOCERR_EDUOM, (TrainID *)catObjForFile, PAGE_BUF);
+
+  e = eduom_ReadObject(&bodyOid, 0, MIN(oldLength, newLength), buf);
+  if (e < eNOERROR) {
+    free(buf);
+    ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+  }
+  if (length > 0) memcpy(&buf[start], data, length);
+
+  // 6. 이동된 object이고 stub이 저장된 page에 여유 공간이 있는 경우, object를
+  // stub이 저장된 page로 다시 옮김
+  done = FALSE;
+  if (moved) {
+    newHdr = homeHdr;
+    newHdr.properties &= ~P_MOVED;
+    newHdr.length = newLength;
+    e = eduom_RewriteInPage(catObjForFile, catEntry, oid, &newHdr, 0,
+                            newLength, buf, &done);
+    if (e < eNOERROR) {
+      free(buf);
+      ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+    }
+  }
+
+  if (!done) {
+    // 7. 다른 page에 새로운 forwarded object를 만들고, object의 slot을 새로운
+    // forwarded object를 가리키는 stub으로 설정함
+    newHdr = homeHdr;
+    newHdr.properties = (homeHdr.properties & ~P_MOVED) | P_FORWARDED;
+    newHdr.length = 0;
+    e = eduom_CreateObject(catObjForFile, NULL, &newHdr, newLength, buf,
+                           &newBodyOid);
+    if (e < eNOERROR) {
+      free(buf);
+      ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+    }
+
+    newHdr = homeHdr;
+    newHdr.properties |= P_MOVED;
+    newHdr.length = newLength;
+    e = eduom_RewriteInPage(catObjForFile, catEntry, oid, &newHdr, 0,
+                            sizeof(ObjectID), (char *)&newBodyOid, &done);
+    if (e >= eNOERROR && !done) {
+      // Object가 ObjectID 보다 짧고 page에 여유 공간이 없어 stub을 만들 수
+      // 없는 경우
+      e = eNOTSUPPORTED_EDUOM;
+    }
+    if (e < eNOERROR) {
+      // 새로 만든 forwarded object를 삭제함
+      free(buf);
+      cleanupErr =
+          eduom_DestroyObject(catObjForFile, &newBodyOid, dlPool, dlHead);
+      if (cleanupErr < eNOERROR)
+        ERRB1(cleanupErr, (TrainID *)catObjForFile, PAGE_BUF);
+      ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+    }
+  }
+  free(buf);
+
+  // 8. 이전의 forwarded object를 삭제함
+  if (moved) {
+    e = eduom_DestroyObject(catObjForFile, &bodyOid, dlPool, dlHead);
+    if (e < eNOERROR) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+  }
+
+  e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_UpdateObject() */
+
+/*@================================
+ * eduom_UpdateLargeObject()
+ *================================*/
+/*
+ * Function: Four eduom_UpdateLargeObject(ObjectID*, ObjectID*, Four, Four,
+ * Four, Four, char*, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  Update a large object, or a small object which becomes a large object.
+ *  The part of the data within the object is written in place and the rest
+ *  is appended by OM_AppendToObject(), which converts a small object into a
+ *  large object. Shrinking a large object(truncation) is not supported.
+ *
+ * Returns:
+ *  error code
+ *    eNOTSUPPORTED_EDUOM
+ *    some errors caused by function calls
+ */
+Four eduom_UpdateLargeObject(
+    ObjectID *catObjForFile, /* IN file containing the object */
+    ObjectID *oid,           /* IN object (body) to update */
+    Four oldLength,          /* IN length of the object */
+    Four newLength,          /* IN length of the object after the update */
+    Four start,              /* IN starting offset of write */
+    Four length,             /* IN amount of data to write */
+    char *data,              /* IN data to write */
+    Pool *dlPool,            /* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead) /* INOUT head of dealloc list */
+{
+  Four e;             /* error number */
+  Four inPlace;       /* # of bytes written within the object */
+  PageID pid;         /* page of the object */
+  SlottedPage *apage; /* pointer to the buffer of the page */
+  Object *obj;        /* pointer to the object in the page */
+  Boolean forwarded;  /* is the object the body of a moved object? */
+
+  if (newLength < oldLength) ERR(eNOTSUPPORTED_EDUOM);
+
+  inPlace = MIN(length, oldLength - start);
+
+  // Object가 저장된 page를 갱신이 끝날 때까지 exclusive mode로 latch 함
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERR(e);
+  }
+
+  if (eduom_IsPinnedObject(oid)) {
+    eduom_UnlatchPage(&pid);
+    ERRB1(eOBJECTPINNED_EDUOM, (TrainID *)&pid, PAGE_BUF);
+  }
+
+  obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+
+  // 1. Large object manager는 forwarded object를 처리하지 않으므로, 갱신하는
+  // 동안 P_FORWARDED를 지움
+  forwarded = (obj->header.properties & P_FORWARDED) ? TRUE : FALSE;
+  obj->header.properties &= ~P_FORWARDED;
+
+  // 2. Object 내부의 범위를 덮어씀
+  if (inPlace > 0) {
+    if (obj->header.properties & P_LRGOBJ) {
+      e = LOT_WriteObject(&pid, oid->slotNo, start, inPlace, data);
+    } else {
+      memcpy(&(obj->data[start]), data, inPlace);
+    }
+  }
+
+  BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+  BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+
+  // 3. 나머지 데이터를 object에 덧붙임
+  if (e >= eNOERROR && length > inPlace) {
+    e = OM_AppendToObject(catObjForFile, oid, length - inPlace,
+                          &data[inPlace], dlPool, dlHead);
+  }
+
+  // 4. P_FORWARDED를 다시 설정함
+  if (forwarded) {
+    BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+    obj->header.properties |= P_FORWARDED;
+    BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  }
+  eduom_UnlatchPage(&pid);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_UpdateLargeObject() */
+
+/*@================================
+ * eduom_RewriteInPage()
+ *================================*/
+/*
+ * Function: Four eduom_RewriteInPage(ObjectID*, sm_CatOverlayForData*,
+ * ObjectID*, ObjectHdr*, Four, Four, char*, Boolean*)
+ *
+ * Description :
+ *  Give the object the header 'newHdr' and write 'length' bytes of 'data'
+ *  from 'start' of its data, in its own page. The space of the object in the
+ *  page is resized for the new header first; the bytes not written keep
+ *  their contents. If the page has no room for the resized object, nothing
+ *  is changed and 'done' is set to FALSE. The page is queued for the
+ *  deferred compaction when its unused bytes exceed the threshold.
+ *
+ * Returns:
+ *  error code
+ *    eOBJECTPINNED_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter done
+ *     'done' is set to TRUE if the object is rewritten
+ */
+Four eduom_RewriteInPage(
+    ObjectID *catObjForFile,        /* IN file containing the object */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    ObjectID *oid,                  /* IN object to rewrite */
+    ObjectHdr *newHdr,              /* IN new header of the object */
+    Four start,                     /* IN starting offset of write */
+    Four length,                    /* IN amount of data to write */
+    char *data,                     /* IN data to write */
+    Boolean *done)                  /* OUT is the object rewritten? */
+{
+  Four e;             /* error number */
+  PageID pid;         /* page of the object */
+  SlottedPage *apage; /* pointer to the buffer of the page */
+  Object *obj;        /* pointer to the object in the page */
+
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  e = eduom_LatchPage(&pid, LATCH_EXCLUSIVE);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERR(e);
+  }
+
+  // Pin 된 object는 갱신할 수 없음
+  if (eduom_IsPinnedObject(oid)) {
+    eduom_UnlatchPage(&pid);
+    ERRB1(eOBJECTPINNED_EDUOM, (TrainID *)&pid, PAGE_BUF);
+  }
+
+  // 1. Page를 현재 available space list에서 삭제하고 object의 공간을 조정함
+  e = eduom_RemoveFromAvailSpaceList(catObjForFile, catEntry, &pid, apage);
+  if (e < eNOERROR) {
+    eduom_UnlatchPage(&pid);
+    ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+  }
+
+  *done = eduom_ResizeInPage(apage, oid->slotNo, SPACE_FOR_HDR(newHdr));
+
+  // 2. 공간이 조정된 경우, object의 header와 데이터를 갱신함
+  if (*done) {
+    obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+    obj->header = *newHdr;
+    if (length > 0) memcpy(&(obj->data[start]), data, length);
+
+    BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+  }
+
+  // 3. Page를 알맞은 available space list에 삽입하고 free space map을 갱신함
+  // Object가 줄어들거나 stub으로 바뀌어 unused 영역이 threshold를 넘는 page는
+  // deferred compaction 대상으로 등록함
+  e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+  if (e >= eNOERROR)
+    e = eduom_FsmSetFreeSpace(&catEntry->fid, pid.pageNo, SP_FREE(apage));
+  if (e >= eNOERROR) e = eduom_AddCompactCandidate(&pid, apage);
+
+  eduom_UnlatchPage(&pid);
+  if (e < eNOERROR) ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+
+  e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return (eNOERROR);
+
+} /* eduom_RewriteInPage() */
+
+/*@================================
+ * eduom_ResizeInPage()
+ *================================*/
+/*
+ * Function: Boolean eduom_ResizeInPage(SlottedPage*, Two, Four)
+ *
+ * Description :
+ *  Resize the space of the object in the page to 'newSpace' bytes including
+ *  its header, without moving it to another page. A shrunk object leaves the
+ *  freed bytes unused; a grown object is extended into the contiguous free
+ *  area, after compacting the page with the object moved to the end if
+ *  needed. Pages holding pinned objects are not compacted. The caller must
+ *  set the header of the object to match the new space.
+ *
+ * Returns:
+ *  TRUE if the object is resized, FALSE if the page has no room
+ */
+Boolean eduom_ResizeInPage(SlottedPage *apage, /* INOUT buffer of the page */
+                           Two slotNo,         /* IN slot of the object */
+                           Four newSpace)      /* IN new space of the object */
+{
+  Object *obj;   /* pointer to the object in the page */
+  Four offset;   /* offset of the object in the data area */
+  Four oldSpace; /* current space of the object */
+  Four extra;    /* additional space needed */
+
+  offset = apage->slot[-slotNo].offset;
+  obj = (Object *)&(apage->data[offset]);
+  oldSpace = LENGTH_WITH_HDR(obj);
+
+  // 1. Object의 공간이 줄어드는 경우
+  if (newSpace <= oldSpace) {
+    if (offset + oldSpace == apage->header.free)
+      apage->header.free -= oldSpace - newSpace;
+    else
+      apage->header.unused += oldSpace - newSpace;
+
+    return (TRUE);
+  }
+
+  // 2. Object의 공간이 늘어나는 경우, object가 데이터 영역의 마지막 object가
+  // 아니거나 contiguous free area가 부족하면 object를 마지막으로 보내며
+  // page를 compact 함
+  extra = newSpace - oldSpace;
+  if (offset + oldSpace != apage->header.free || SP_CFREE(apage) < extra) {
+    if (SP_FREE(apage) < extra) return (FALSE);
+
+    // Pin 된 object가 있는 page는 compact 되지 않음
+    if (EduOM_CompactPage(apage, slotNo) < eNOERROR) return (FALSE);
+  }
+
+  apage->header.free += extra;
+
+  return (TRUE);
+
+} /* eduom_ResizeInPage() */
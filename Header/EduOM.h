@@ -35,12 +35,43 @@
  * Function Prototypes
  */
 /* Interface Function Prototypes */
+Four EduOM_AppendToObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*);
 Four EduOM_CompactPage(SlottedPage*, Two);
+Four EduOM_CompactPendingPages(Four, Four*);
 Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, void*, ObjectID*);
+Four EduOM_CreateObjects(ObjectID*, ObjectID*, Four, ObjectCreateInfo*, ObjectID*);
+Four EduOM_ClosePageScan(PageScanInfo*);
+Four EduOM_CloseScanCursor(ScanCursor*);
 Four EduOM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*);
+Four EduOM_FinalBulkLoad(BulkLoadInfo*, Pool*, DeallocListElem*);
+Four EduOM_FlushElementPool(Pool*);
+Four EduOM_GetPlacementPolicy(ObjectID*, Two*);
+Four EduOM_GetStats(ObjectID*, EduOM_Stats*);
+Four EduOM_InitBulkLoad(ObjectID*, Two, BulkLoadInfo*);
+Four EduOM_NextBulkLoad(BulkLoadInfo*, ObjectHdr*, Four, char*, ObjectID*);
 Four EduOM_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
+Four EduOM_NextPageObjects(PageScanInfo*, ObjectBatchEntry*, Four, Four*);
+Four EduOM_NextScanCursor(ScanCursor*, ObjectID*, ObjectHdr*);
+Four EduOM_OpenPageScan(ObjectID*, PageScanInfo*);
+Four EduOM_OpenScanCursor(ObjectID*, ScanCursor*);
+Four EduOM_PinObject(ObjectID*, Four, Four, char**);
 Four EduOM_PrevObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
+Four EduOM_PrevScanCursor(ScanCursor*, ObjectID*, ObjectHdr*);
 Four EduOM_ReadObject(ObjectID*, Four, Four, void*);
+Four EduOM_ReleasePreallocatedPages(ObjectID*, Pool*, DeallocListElem*);
+Four EduOM_ReorganizeFile(ObjectID*, Four, Pool*, DeallocListElem*, Four*);
+Four EduOM_ReportFile(ObjectID*, FILE*);
+Four EduOM_ResetStats(void);
+Four EduOM_SetClusterRadius(Four);
+Four EduOM_SetCompactThreshold(Four);
+Four EduOM_SetPlacementPolicy(ObjectID*, Two);
+Four EduOM_SetPreallocation(ObjectID*, Four);
+Four EduOM_SetReadahead(Four);
+Four EduOM_StartCompactor(void);
+Four EduOM_StopCompactor(void);
+Four EduOM_TruncateObject(ObjectID*, ObjectID*, Four, Pool*, DeallocListElem*);
+Four EduOM_UnpinObject(ObjectID*);
+Four EduOM_WriteObject(ObjectID*, ObjectID*, Four, Four, char*, Pool*, DeallocListElem*);
 
 Four OM_DumpObject(ObjectID *);
 
@@ -25,7 +25,10 @@
 #ifndef _EDUOM_INTERNAL_H_
 #define _EDUOM_INTERNAL_H_
 
+#include <time.h>
+
 #include "EduOM_common.h"
+#include "Util_pool.h"
 
 /*@
  * Type Definitions
@@ -74,6 +77,222 @@ typedef struct {
   SlottedPageSlot slot[1];        /* slot arrays, indexes backwards */
 } SlottedPage;
 
+/*
+ *----------------- Typedefs for In-Memory File Information --------------------
+ */
+
+/*
+ * Typedef for the free space map of a data file
+ * Pages are classified by their free space in units of FSM_UNIT bytes;
+ * the pages of each category are doubly linked through 'next' and 'prev',
+ * which are indexed by the page number like 'category'. The pages of the
+ * smallest category which may fit a request are checked against their exact
+ * free space, at most FSM_FLOOR_PROBES of them.
+ */
+#define FSM_UNIT 16
+#define FSM_NUM_CATEGORIES (PAGESIZE / FSM_UNIT)
+#define FSM_BITMAP_SIZE (FSM_NUM_CATEGORIES / 32)
+#define FSM_FLOOR_PROBES 8
+
+typedef struct {
+  Boolean built;        /* whether the map has been built */
+  Four nPages;          /* # of entries of the per-page arrays */
+  UOne *category;       /* free space category of each page, 0 if none */
+  Two *freeSpace;       /* free space of each page */
+  ShortPageID *next;    /* next page in the same category */
+  ShortPageID *prev;    /* previous page in the same category */
+  ShortPageID head[FSM_NUM_CATEGORIES]; /* first page of each category */
+  UFour nonEmpty[FSM_BITMAP_SIZE];      /* bitmap of nonempty categories */
+} FreeSpaceMap;
+
+/*
+ * Placement policies of a data file, used when no near object is given
+ * The policy is kept in the flags of the first page of the file.
+ */
+#define PLACEMENT_BEST_FIT 0    /* page with the least sufficient free space */
+#define PLACEMENT_FIRST_FIT 1   /* first page of the fitting avail space list */
+#define PLACEMENT_APPEND_ONLY 2 /* last page of the file only */
+#define PLACEMENT_PARTITIONED 3 /* insertion page of the current thread */
+
+#define PLACEMENT_POLICY_MASK 0x30
+#define PLACEMENT_POLICY_SHIFT 4
+
+/*
+ * Typedef for the pages preallocated for a data file
+ */
+#define PREALLOC_MAX_PAGES 16 /* max # of pages allocated at once (extSize) */
+
+typedef struct {
+  Four runSize;                     /* # of pages allocated at once, 0 if off */
+  Four nPages;                      /* # of pages in 'pages' */
+  Four nextPage;                    /* index of the next page to hand out */
+  PageID pages[PREALLOC_MAX_PAGES]; /* preallocated pages by page number */
+} PreallocInfo;
+
+/*
+ * Typedef for the insertion pages of the partitions of a data file
+ */
+#define PARTITION_SLOTS 64 /* # of partitions; threads beyond own no page */
+
+typedef struct {
+  ShortPageID pages[PARTITION_SLOTS]; /* insertion page, NIL if none */
+} PartitionInfo;
+
+/*
+ * Typedef for the in-memory information about a data file
+ */
+typedef struct _eduom_FileInfo {
+  FileID fid;                   /* ID of the file */
+  Two placementPolicy;          /* placement policy, NIL if not read yet */
+  FreeSpaceMap fsm;             /* free space map of the file */
+  PreallocInfo prealloc;        /* pages preallocated for the file */
+  PartitionInfo partition;      /* insertion pages of partitioned placement */
+  struct _eduom_FileInfo *next; /* next entry in the file info table */
+} eduom_FileInfo;
+
+/*
+ * Typedef for the cached catalog information about a data file
+ */
+typedef struct _eduom_CatalogDesc {
+  ObjectID catObjForFile;          /* catalog object of the file */
+  Boolean valid;                   /* is the descriptor up to date? */
+  FileID fid;                      /* ID of the file */
+  Two eff;                         /* extent fill factor of the file */
+  ShortPageID firstPage;           /* first page of the file */
+  ShortPageID lastPage;            /* last page of the file */
+  struct _eduom_CatalogDesc *next; /* next entry in the descriptor table */
+} eduom_CatalogDesc;
+
+/*
+ *----------------- Typedefs for Interface Parameters --------------------
+ */
+
+/*
+ * Typedef for one object to be created by EduOM_CreateObjects()
+ */
+typedef struct {
+  ObjectHdr *objHdr; /* from which tag is to be set (may be NULL) */
+  Four length;       /* amount of data */
+  char *data;        /* the initial data for the object */
+} ObjectCreateInfo;
+
+/*
+ * Typedef for one object returned by EduOM_NextPageObjects()
+ */
+typedef struct {
+  ObjectID oid;     /* ID of the object */
+  ObjectHdr objHdr; /* header of the object */
+  char *data;       /* object data in the buffer frame, NULL if not in page */
+  Four length;      /* length of the object data */
+} ObjectBatchEntry;
+
+/*
+ * Typedef for the readahead state of a sequential scan
+ */
+#define READAHEAD_DEFAULT_PAGES 8 /* # of pages read ahead by default */
+#define READAHEAD_MAX_PAGES 64    /* max # of pages read ahead */
+#define READAHEAD_HELD_PAGES (2 * READAHEAD_MAX_PAGES) /* max # of pages kept */
+
+typedef struct {
+  Four nAhead;  /* # of pages requested ahead of the current page */
+  Four ticket;  /* ticket of the last request of the scan, 0 if none */
+  Four nHeld;   /* # of pages kept fixed for the scan by the worker */
+  Four nPassed; /* # of the kept pages the scan has passed */
+  PageID held[READAHEAD_HELD_PAGES]; /* kept pages in page list order */
+} ReadaheadInfo;
+
+/*
+ * Typedef for the state of a page-at-a-time scan of a data file
+ */
+typedef struct {
+  ObjectID catObjForFile; /* catalog object of the file being scanned */
+  PageID pid;             /* page being scanned, pageNo is NIL at the end */
+  SlottedPage *apage;     /* buffer of the page, NULL if no page is fixed */
+  Two nextSlot;           /* next slot to be scanned in the page */
+  ReadaheadInfo ra;       /* readahead state of the scan */
+} PageScanInfo;
+
+/*
+ * Typedef for a scan cursor on a data file
+ */
+typedef struct {
+  ObjectID catObjForFile; /* catalog object of the file being scanned */
+  ShortPageID firstPage;  /* first page of the file, read at each boundary */
+  ShortPageID lastPage;   /* last page of the file, read at each boundary */
+  PageID pid;             /* current page, pageNo is NIL if not positioned */
+  SlottedPage *apage;     /* current page fixed and pinned, NULL if none */
+  Two slotNo;             /* slot of the current object in the page */
+  ReadaheadInfo ra;       /* readahead state of forward scans */
+} ScanCursor;
+
+/*
+ * Typedef for the state of a bulk load into a data file
+ */
+#define BULKLOAD_TRAINS 16 /* # of pages allocated at once during bulk load */
+
+typedef struct {
+  ObjectID catObjForFile;  /* catalog object of the file being loaded */
+  FileID fid;              /* ID of the file being loaded */
+  Two eff;                 /* extent fill factor of the file */
+  Four firstExt;           /* first extent No of the file */
+  Four fillLimit;          /* bytes of a page to be filled */
+  PageID pid;              /* page currently being filled */
+  SlottedPage *apage;      /* buffer of the current page, NULL if none */
+  ShortPageID *loadedPages;            /* pages linked by the load, in order */
+  Four nLoadedPages;                   /* # of pages in 'loadedPages' */
+  Four maxLoadedPages;                 /* size of 'loadedPages' */
+  Four nAllocPages;                    /* # of pages in 'allocPages' */
+  Four nextAllocPage;                  /* index of the next unused page */
+  PageID allocPages[BULKLOAD_TRAINS];  /* pages allocated but not yet used */
+} BulkLoadInfo;
+
+/*
+ * Typedef for the statistics of the object manager
+ */
+#define STATS_MAX_FILES 8 /* max # of files counted separately by a thread */
+
+/* operations whose latency is measured */
+#define STATS_OP_CREATE 0
+#define STATS_OP_DESTROY 1
+#define STATS_OP_READ 2
+#define STATS_OP_NEXT 3
+#define STATS_OP_PREV 4
+#define STATS_OP_UPDATE 5   /* write, append and truncate */
+#define STATS_OP_BULKLOAD 6 /* object appended by a bulk load */
+#define STATS_NUM_OPS 7
+
+/* where the page for a new object is found */
+#define STATS_PLACE_NEAR 0      /* page of the near object */
+#define STATS_PLACE_FSM 1       /* free space map (best-fit) */
+#define STATS_PLACE_LIST10 2    /* available space lists (first-fit) */
+#define STATS_PLACE_LIST20 3
+#define STATS_PLACE_LIST30 4
+#define STATS_PLACE_LIST40 5
+#define STATS_PLACE_LIST50 6
+#define STATS_PLACE_LASTPAGE 7  /* last page of the file */
+#define STATS_PLACE_PARTITION 8 /* insertion page of the thread */
+#define STATS_PLACE_NEWPAGE 9   /* newly allocated page */
+#define STATS_PLACE_CLUSTER 10  /* page around the near page */
+#define STATS_NUM_PLACEMENTS 11
+
+/* bucket i of a histogram counts the values in [2^i, 2^(i+1)) */
+#define STATS_NUM_LATENCY_BUCKETS 32 /* latency in nanoseconds */
+#define STATS_NUM_SCAN_BUCKETS 16    /* # of slots visited */
+
+typedef unsigned long long StatsCounter;
+
+typedef struct {
+  StatsCounter bufferFixes;     /* # of pages fixed in the buffer */
+  StatsCounter bufferUnfixes;   /* # of pages freed from the buffer */
+  StatsCounter compactions;     /* # of calls of EduOM_CompactPage() */
+  StatsCounter bytesMoved;      /* # of bytes moved by the compactions */
+  StatsCounter pagesAllocated;  /* # of pages allocated by RDsM_AllocTrains() */
+  StatsCounter placements[STATS_NUM_PLACEMENTS];   /* pages for new objects */
+  StatsCounter slotScans[STATS_NUM_SCAN_BUCKETS];  /* slot scan lengths */
+  StatsCounter ops[STATS_NUM_OPS];                 /* # of operations */
+  StatsCounter latency[STATS_NUM_OPS][STATS_NUM_LATENCY_BUCKETS]; /* in ns */
+} EduOM_Stats;
+
 /*@
  * Macro Function Definitions
  */
@@ -106,6 +325,10 @@ typedef struct {
 /* The empty slots have EMPTYSLOT with the 'offset' */
 #define EMPTYSLOT -1
 
+/* constant macro for the chain of the empty slots */
+/* The chain headed by 'reserved' of the page header is valid if set in 'flags' */
+#define SLOT_FREELIST_VALID 0x40
+
 /* Macro: IS_VALID_OBJECTID(oid, s_page)
  * Description: check whether the object ID given as a parameter is valid or not
  * Parameters:
@@ -119,8 +342,51 @@ typedef struct {
        ? FALSE                                              \
        : TRUE)
 
+/* Macro: IS_SCANNED_SLOT(s_page, slotNo)
+ * Description: check whether the slot holds an object returned by scans; the
+ * body of a moved object(forwarded object) is reached only through its stub
+ * Parameters:
+ *  SlottedPage *s_page : pointer to the page
+ *  Two slotNo          : slot number to check
+ * Returns: TRUE(1) if the object in the slot is scanned, otherwise FALSE(0)
+ */
+#define IS_SCANNED_SLOT(s_page, slotNo)                                   \
+  (((s_page)->slot[-(slotNo)].offset == EMPTYSLOT ||                      \
+    (((Object *)&((s_page)->data[(s_page)->slot[-(slotNo)].offset]))      \
+         ->header.properties &                                            \
+     P_FORWARDED))                                                        \
+       ? FALSE                                                            \
+       : TRUE)
+
+/* Macro: EQUAL_OBJECTID(x, y)
+ * Description: check whether the two object IDs are the same
+ * Parameters:
+ *  ObjectID x, y : object IDs to compare
+ * Returns: TRUE(1) if they are the same, otherwise FALSE(0)
+ */
+#define EQUAL_OBJECTID(x, y)                                    \
+  (((x).volNo == (y).volNo && (x).pageNo == (y).pageNo &&       \
+    (x).slotNo == (y).slotNo && (x).unique == (y).unique)       \
+       ? TRUE                                                   \
+       : FALSE)
+
 #define LRGOBJ_THRESHOLD (PAGESIZE - SP_FIXED - sizeof(ObjectHdr))
 
+/* Macro: LENGTH_WITH_HDR(obj)
+ * Description: return the number of bytes the object occupies in the data area
+ * of its page; only the root of a large object tree is stored in the page and
+ * a moved object(stub) stores only the object ID of its body
+ * Parameter: Object *obj   : pointer to the object in the page
+ * Returns: (Four) length of the object header and the data in the page
+ */
+#define LENGTH_WITH_HDR(obj)                                          \
+  (((obj)->header.properties & P_MOVED)                               \
+       ? (Four)(sizeof(ObjectHdr) + sizeof(ObjectID))                 \
+       : ((obj)->header.properties & P_LRGOBJ)                        \
+             ? LOT_GetLengthWithHdr(obj)                              \
+             : (Four)(sizeof(ObjectHdr) +                             \
+                      ALIGNED_LENGTH((obj)->header.length)))
+
 /* Macro: GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry)
  * Description: get the information about the data file(sm_CatOverlayForData)
  * residing in the catalog object for data file Parameters: ObjectID
@@ -139,9 +405,84 @@ typedef struct {
 /*@
  * Function Prototypes
  */
+/* interface functions also called inside EduOM */
+Four EduOM_CompactPage(SlottedPage *, Two);
+
 /* internal function prototypes */
 Four eduom_CreateObject(ObjectID *, ObjectID *, ObjectHdr *, Four, char *,
                         ObjectID *);
+Four eduom_TryCreateObject(ObjectID *, ObjectID *, ObjectHdr *, Four, char *,
+                           ObjectID *, Boolean *);
+Four eduom_SelectPage(ObjectID *, sm_CatOverlayForData *, ObjectID *, Four,
+                      Boolean, Two *, PageID *, PageID *, SlottedPage **,
+                      Four *);
+Four eduom_ReturnInsertPage(ObjectID *, sm_CatOverlayForData *, Two, Boolean,
+                            PageID *, SlottedPage *);
+Four eduom_CreateObjects(ObjectID *, ObjectID *, Four, ObjectCreateInfo *,
+                         ObjectID *);
+Four eduom_DestroyObject(ObjectID *, ObjectID *, Pool *, DeallocListElem *);
+Four eduom_UnlinkPage(ObjectID *, PageID *, SlottedPage *);
+Four eduom_AllocNewPage(ObjectID *, sm_CatOverlayForData *, Four, PageID *,
+                        PageID *, SlottedPage **);
+Four eduom_LinkNewPage(ObjectID *, FileID *, PageID *, PageID *,
+                       SlottedPage **);
+Four eduom_InsertIntoPage(SlottedPage *, PageID *, ObjectHdr *, Four, char *,
+                          ObjectID *);
+Four eduom_GetUnique(PageID *, SlottedPage *, Unique *);
+Four eduom_GetAvailSpaceListPage(sm_CatOverlayForData *, Four, PageID *,
+                                 SlottedPage **);
+Four eduom_RemoveFromAvailSpaceList(ObjectID *, sm_CatOverlayForData *,
+                                    PageID *, SlottedPage *);
+Four eduom_PinPage(PageID *, Two);
+Four eduom_UnpinPage(PageID *, Two);
+Boolean eduom_IsPinnedPage(PageID *);
+Boolean eduom_IsPinnedObject(ObjectID *);
+Boolean eduom_HasRoomInPage(PageID *, SlottedPage *, Four);
+Four eduom_GetFileInfo(FileID *, eduom_FileInfo **);
+Four eduom_GetCatalogDesc(ObjectID *, eduom_CatalogDesc *);
+void eduom_InvalidateCatalogDesc(ObjectID *);
+Four eduom_GetPlacementPolicy(sm_CatOverlayForData *, Two *);
+Four eduom_FsmSetFreeSpace(FileID *, ShortPageID, Four);
+Four eduom_FsmGetPage(sm_CatOverlayForData *, Four, PageID *, SlottedPage **);
+Four eduom_AddCompactCandidate(PageID *, SlottedPage *);
+Four eduom_GetPartitionPage(ObjectID *, sm_CatOverlayForData *, Four,
+                            Boolean, PageID *, SlottedPage **);
+Four eduom_SetPartitionPage(FileID *, ShortPageID);
+Four eduom_DropPartitionPage(FileID *, ShortPageID);
+Four eduom_GetPartitionOwner(FileID *, ShortPageID, Four *);
+Four eduom_ReleasePartitionPages(ObjectID *, sm_CatOverlayForData *);
+Four eduom_GetPartitionNo(void);
+Four eduom_GetClusterPage(FileID *, PageID *, SlottedPage *, Four, PageID *,
+                          SlottedPage **);
+Four eduom_FlushElementPool(Pool *);
+Four eduom_GetElementFromPool(Pool *, void *);
+Four eduom_FreeElementToPool(Pool *, void *);
+EduOM_Stats *eduom_GetThreadStats(ObjectID *);
+void eduom_StatsStartOp(struct timespec *);
+void eduom_StatsEndOp(ObjectID *, Four, struct timespec *);
+void eduom_StatsAddPlacement(ObjectID *, Four);
+void eduom_StatsAddSlotScan(Four);
+Four eduom_ReadObject(ObjectID *, Four, Four, char *);
+Four eduom_NextObject(ObjectID *, ObjectID *, ObjectID *, ObjectHdr *);
+Four eduom_PrevObject(ObjectID *, ObjectID *, ObjectID *, ObjectHdr *);
+Four eduom_AllocPage(sm_CatOverlayForData *, Four, PageID *, PageID *);
+Four eduom_ReleasePreallocPages(sm_CatOverlayForData *, Pool *,
+                                DeallocListElem *);
+Four eduom_InitReadahead(ReadaheadInfo *);
+Four eduom_RestartReadahead(ReadaheadInfo *);
+Four eduom_Readahead(ReadaheadInfo *, PageID *, SlottedPage *, ShortPageID);
+Four eduom_FinalReadahead(ReadaheadInfo *);
+Two eduom_AllocSlot(SlottedPage *);
+void eduom_FreeSlot(SlottedPage *, Two);
+Four eduom_UpdateObject(ObjectID *, ObjectID *, Four, Four, char *, Four,
+                        Pool *, DeallocListElem *);
+Four eduom_RewriteInPage(ObjectID *, sm_CatOverlayForData *, ObjectID *,
+                         ObjectHdr *, Four, Four, char *, Boolean *);
+Boolean eduom_ResizeInPage(SlottedPage *, Two, Four);
+
+Four LOT_GetLengthWithHdr(Object *);
+Four OM_AppendToObject(ObjectID *, ObjectID *, Four, char *, Pool *,
+                       DeallocListElem *);
 
 Four om_FileMapAddPage(ObjectID *, PageID *, PageID *);
 Four om_FileMapDeletePage(ObjectID *, PageID *);
@@ -150,4 +491,69 @@ Four om_IsTemporary(FileID *, Boolean *);
 Four om_PutInAvailSpaceList(ObjectID *, PageID *, SlottedPage *);
 Four om_RemoveFromAvailSpaceList(ObjectID *, PageID *, SlottedPage *);
 
+/*
+ * Latches (EduOM_Latch.c)
+ * Order : file latch -> page latch -> space latch -> storage latch
+ */
+#define LATCH_SHARED 1    /* latch mode for reading */
+#define LATCH_EXCLUSIVE 2 /* latch mode for writing */
+
+Four eduom_LatchFile(ObjectID *, Four);
+Four eduom_UnlatchFile(ObjectID *);
+Four eduom_LatchPage(PageID *, Four);
+Four eduom_UnlatchPage(PageID *);
+Four eduom_LatchPagePair(PageID *, PageID *);
+void eduom_UnlatchPagePair(PageID *, PageID *);
+Four eduom_LatchFileSpace(ObjectID *);
+Four eduom_UnlatchFileSpace(ObjectID *);
+void eduom_LatchStorage(void);
+void eduom_UnlatchStorage(void);
+
+Four eduom_BfM_GetTrain(TrainID *, char **, Four);
+Four eduom_BfM_GetNewTrain(TrainID *, char **, Four);
+Four eduom_BfM_FreeTrain(TrainID *, Four);
+Four eduom_BfM_SetDirty(TrainID *, Four);
+Four eduom_RDsM_AllocTrains(Four, Four, PageID *, Two, Four, Two, PageID *);
+Four eduom_RDsM_GetUnique(PageID *, Unique *, Four *);
+Four eduom_RDsM_PageIdToExtNo(PageID *, Four *);
+Four eduom_LOT_DestroyObject(PageID *, Two, Pool *, DeallocListElem *);
+Four eduom_LOT_GetLengthWithHdr(Object *);
+Four eduom_LOT_ReadObject(PageID *, Two, Four, Four, char *);
+Four eduom_LOT_WriteObject(PageID *, Two, Four, Four, char *);
+Four eduom_OM_AppendToObject(ObjectID *, ObjectID *, Four, char *, Pool *,
+                             DeallocListElem *);
+Four eduom_om_FileMapAddPage(ObjectID *, PageID *, PageID *);
+Four eduom_om_FileMapDeletePage(ObjectID *, PageID *);
+Four eduom_om_GetUnique(PageID *, Unique *);
+Four eduom_om_IsTemporary(FileID *, Boolean *);
+Four eduom_om_PutInAvailSpaceList(ObjectID *, PageID *, SlottedPage *);
+Four eduom_om_RemoveFromAvailSpaceList(ObjectID *, PageID *, SlottedPage *);
+
+/*
+ * The storage layer is not reentrant: the EduOM modules call it through the
+ * functions of EduOM_Latch.c, which hold the storage latch. The page buffers
+ * go through the fixed page table of EduOM_Latch.c, which calls the buffer
+ * manager only for the first fix and the last free of a page.
+ */
+#ifndef EDUOM_LATCH_INTERNAL
+#define BfM_GetTrain eduom_BfM_GetTrain
+#define BfM_GetNewTrain eduom_BfM_GetNewTrain
+#define BfM_FreeTrain eduom_BfM_FreeTrain
+#define BfM_SetDirty eduom_BfM_SetDirty
+#define RDsM_AllocTrains eduom_RDsM_AllocTrains
+#define RDsM_GetUnique eduom_RDsM_GetUnique
+#define RDsM_PageIdToExtNo eduom_RDsM_PageIdToExtNo
+#define LOT_DestroyObject eduom_LOT_DestroyObject
+#define LOT_GetLengthWithHdr eduom_LOT_GetLengthWithHdr
+#define LOT_ReadObject eduom_LOT_ReadObject
+#define LOT_WriteObject eduom_LOT_WriteObject
+#define OM_AppendToObject eduom_OM_AppendToObject
+#define om_FileMapAddPage eduom_om_FileMapAddPage
+#define om_FileMapDeletePage eduom_om_FileMapDeletePage
+#define om_GetUnique eduom_om_GetUnique
+#define om_IsTemporary eduom_om_IsTemporary
+#define om_PutInAvailSpaceList eduom_om_PutInAvailSpaceList
+#define om_RemoveFromAvailSpaceList eduom_om_RemoveFromAvailSpaceList
+#endif /* EDUOM_LATCH_INTERNAL */
+
 #endif /* _EDUOM_INTERNAL_H_ */
@@ -73,7 +73,12 @@ Four LRDS_Final(void);
 
 Four RDsM_AllocTrains(Four, Four, PageID *, Two, Four, Two, PageID *);
 
+Four SM_CreateFile(Four, FileID *, Boolean, void *); /* no lock parameter */
+Four SM_DestroyFile(FileID *, void *);                /* no lock parameter */
+Four sm_GetCatalogEntryFromDataFileId(Four, FileID *, ObjectID *);
+
 Four EduOM_Test(Four, Four, Boolean);
+Four EduOM_APITest(Four, Four);
 
 
 #endif /* _EDUOM_TESTMODULE_H_ */
@@ -31,6 +31,7 @@
 Four LOT_DestroyObject(PageID*, Two, Pool*, DeallocListElem*);
 Four LOT_GetLengthWithHdr(Object*);
 Four LOT_ReadObject(PageID*, Two, Four, Four, char*);
+Four LOT_WriteObject(PageID*, Two, Four, Four, char*);
 
 
 #endif /* _LOT_H_ */
@@ -30,6 +30,7 @@
 
 
 Four Util_getElementFromPool(Pool*, void*);
+Four Util_freeElementToPool(Pool*, void*);
 
 
 #endif /* _UTIL_H_ */